@@ -27,6 +27,7 @@
 
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icarus_signal_processing/Denoising.h"
+#include "icaruscode/TPC/Utilities/VanHerkMorphologicalFunctions.h"
 #include "icarus_signal_processing/Filters/FFTFilterFunctions.h"
 
 // std includes
@@ -428,10 +429,10 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
             switch(fFilterModeVec[plane][0])
             {
                 case 'd' :
-                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Dilation1D>(fStructuringElement);
+                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus::VanHerkDilation1D>(fStructuringElement);
                     break;
                 case 'e' :
-                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Erosion1D>(fStructuringElement);
+                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus::VanHerkErosion1D>(fStructuringElement);
                     break;
                 case 'g' :
                     fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Gradient1D>(fStructuringElement);
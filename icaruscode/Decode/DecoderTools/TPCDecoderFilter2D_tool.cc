@@ -27,6 +27,7 @@
 
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icarus_signal_processing/Denoising.h"
+#include "icaruscode/TPC/Utilities/VanHerkMorphologicalFunctions.h"
 #include "icarus_signal_processing/Filters/FFTFilterFunctions.h"
 
 // std includes
@@ -143,6 +144,7 @@ private:
     size_t                                         fCoherentNoiseGrouping;  //< # channels in common for coherent noise
     size_t                                         fCoherentNoiseOffset;    //< offset for midplane
     std::vector<size_t>                            fStructuringElement;     //< Structuring element for morphological filter
+    bool                                           fUseVanHerk2D;           //< Use the linear time 2D erosion/dilation (not yet validated)
     size_t                                         fMorphWindow;            //< Window for filter
     std::vector<float>                             fThreshold;              //< Threshold to apply for saving signal
     bool                                           fDiagnosticOutput;       //< If true will spew endless messages to output
@@ -220,6 +222,7 @@ void TPCDecoderFilter2D::configure(fhicl::ParameterSet const &pset)
     fCoherentNoiseGrouping  = pset.get<size_t             >("CoherentGrouping",    64);
     fCoherentNoiseOffset    = pset.get<size_t             >("CoherentOffset",       0);
     fStructuringElement     = pset.get<std::vector<size_t>>("StructuringElement",  std::vector<size_t>()={8,16});
+    fUseVanHerk2D           = pset.get<bool               >("UseVanHerk2D",        false);
     fMorphWindow            = pset.get<size_t             >("FilterWindow",        10);
     fThreshold              = pset.get<std::vector<float> >("Threshold",           std::vector<float>()={5.0,3.5,3.5});
     fDiagnosticOutput       = pset.get<bool               >("DiagnosticOutput",    false);
@@ -454,10 +457,12 @@ void TPCDecoderFilter2D::process_fragment(detinfo::DetectorClocksData const&,
                 switch(fFilterModeVec[plane])
                 {
                     case 'd' :
-                        filterFunctionPtr = std::make_unique<icarus_signal_processing::Dilation2D>(fStructuringElement[0],fStructuringElement[1]);
+                        if (fUseVanHerk2D) filterFunctionPtr = std::make_unique<icarus::VanHerkDilation2D>(fStructuringElement[0],fStructuringElement[1]);
+                        else               filterFunctionPtr = std::make_unique<icarus_signal_processing::Dilation2D>(fStructuringElement[0],fStructuringElement[1]);
                         break;
                     case 'e' :
-                        filterFunctionPtr = std::make_unique<icarus_signal_processing::Erosion2D>(fStructuringElement[0],fStructuringElement[1]);
+                        if (fUseVanHerk2D) filterFunctionPtr = std::make_unique<icarus::VanHerkErosion2D>(fStructuringElement[0],fStructuringElement[1]);
+                        else               filterFunctionPtr = std::make_unique<icarus_signal_processing::Erosion2D>(fStructuringElement[0],fStructuringElement[1]);
                         break;
                     case 'g' :
                         filterFunctionPtr = std::make_unique<icarus_signal_processing::Gradient2D>(fStructuringElement[0],fStructuringElement[1]);
@@ -26,6 +26,7 @@
 
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icarus_signal_processing/Denoising.h"
+#include "icaruscode/TPC/Utilities/VanHerkMorphologicalFunctions.h"
 #include "icarus_signal_processing/Filters/FFTFilterFunctions.h"
 
 // std includes
@@ -302,10 +303,10 @@ void TPCNoiseFilter1DMC::process_fragment(detinfo::DetectorClocksData const&,
         switch(fFilterModeVec[plane][0])
         {
             case 'd' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Dilation1D>(fStructuringElement);
+                fFilterFunctionVec[idx] = std::make_unique<icarus::VanHerkDilation1D>(fStructuringElement);
                 break;
             case 'e' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Erosion1D>(fStructuringElement);
+                fFilterFunctionVec[idx] = std::make_unique<icarus::VanHerkErosion1D>(fStructuringElement);
                 break;
             case 'g' :
                 fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Gradient1D>(fStructuringElement);
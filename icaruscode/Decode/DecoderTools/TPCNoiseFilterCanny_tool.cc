@@ -29,6 +29,7 @@
 #include "icarus_signal_processing/Filters/FFTFilterFunctions.h"
 #include "icarus_signal_processing/Filters/ImageFilters.h"
 #include "icarus_signal_processing/Denoising.h"
+#include "icaruscode/TPC/Utilities/VanHerkMorphologicalFunctions.h"
 #include "icarus_signal_processing/Detection/EdgeDetection.h"
 #include "icarus_signal_processing/Filters/BilateralFilters.h"
 #include "icarus_signal_processing/ROIFinder2D.h"
@@ -165,6 +166,7 @@ private:
     // Parameters for the 2D morphological filter
     unsigned int                                   fMorph2DStructuringElementX; ///< Structuring element in X
     unsigned int                                   fMorph2DStructuringElementY; ///< Structuring element in Y
+    bool                                           fUseVanHerk2D;               ///< Use the linear time 2D dilation (not yet validated)
 
     // Parameters for the denoiser
     unsigned int                                   fCoherentNoiseGrouping;      ///< Number of consecutive channels in coherent noise subtraction
@@ -273,7 +275,10 @@ void TPCNoiseFilterCannyMC::configure(fhicl::ParameterSet const &pset)
     fMorph2DStructuringElementX = pset.get<unsigned int            >("Morph2DStructuringElementX", 7);
     fMorph2DStructuringElementY = pset.get<unsigned int            >("Morph2DStructuringElementX", 28);
 
-    fMorphologicalFilter = std::make_unique<icarus_signal_processing::Dilation2D>(fMorph2DStructuringElementX,fMorph2DStructuringElementY);
+    fUseVanHerk2D               = pset.get<bool                    >("UseVanHerk2D",        false);
+
+    if (fUseVanHerk2D) fMorphologicalFilter = std::make_unique<icarus::VanHerkDilation2D>(fMorph2DStructuringElementX,fMorph2DStructuringElementY);
+    else               fMorphologicalFilter = std::make_unique<icarus_signal_processing::Dilation2D>(fMorph2DStructuringElementX,fMorph2DStructuringElementY);
 
     fCoherentNoiseOffset        = pset.get<unsigned int            >("CoherentNoiseOffset",      24);
     fMorphologicalWindow        = pset.get<unsigned int            >("MorphologicalWindow",      10);
@@ -387,10 +392,10 @@ void TPCNoiseFilterCannyMC::process_fragment(detinfo::DetectorClocksData const&,
         switch(fFilterModeVec[plane][0])
         {
             case 'd' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Dilation1D>(fStructuringElement[1]);
+                fFilterFunctionVec[idx] = std::make_unique<icarus::VanHerkDilation1D>(fStructuringElement[1]);
                 break;
             case 'e' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Erosion1D>(fStructuringElement[1]);
+                fFilterFunctionVec[idx] = std::make_unique<icarus::VanHerkErosion1D>(fStructuringElement[1]);
                 break;
             case 'g' :
                 fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Gradient1D>(fStructuringElement[1]);
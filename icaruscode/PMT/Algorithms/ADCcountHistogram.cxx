@@ -0,0 +1,76 @@
+/**
+ * @file   icaruscode/PMT/Algorithms/ADCcountHistogram.cxx
+ * @brief  Counting histogram of digitized samples, for median and mode.
+ * @date   October 18, 2026
+ * @see    icaruscode/PMT/Algorithms/ADCcountHistogram.h
+ */
+
+// library header
+#include "icaruscode/PMT/Algorithms/ADCcountHistogram.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::fill()
+#include <limits>
+
+
+//------------------------------------------------------------------------------
+//---  opdet::ADCcountHistogram
+//------------------------------------------------------------------------------
+opdet::ADCcountHistogram::ADCcountHistogram
+  (unsigned int bits /* = DefaultBits */)
+{
+  // all values must be representable by `Sample_t`
+  if ((bits == 0U) || (bits >= std::numeric_limits<Sample_t>::digits + 1U)) {
+    throw cet::exception("ADCcountHistogram")
+      << "Histogram of samples with " << bits
+      << " bits not supported (must be between 1 and "
+      << std::numeric_limits<Sample_t>::digits << ").\n";
+  }
+  fCounts.resize(std::size_t{ 1U } << bits, 0U);
+  fLow = fCounts.size();
+} // opdet::ADCcountHistogram::ADCcountHistogram()
+
+
+//------------------------------------------------------------------------------
+void opdet::ADCcountHistogram::clear() {
+  if (fLow <= fHigh)
+    std::fill(fCounts.begin() + fLow, fCounts.begin() + fHigh + 1, 0U);
+  fN = 0U;
+  fLow = fCounts.size();
+  fHigh = 0U;
+} // opdet::ADCcountHistogram::clear()
+
+
+//------------------------------------------------------------------------------
+auto opdet::ADCcountHistogram::nth(std::size_t rank) const -> Sample_t {
+  assert(rank < fN);
+
+  std::size_t seen = 0U;
+  for (std::size_t bin = fLow; bin <= fHigh; ++bin) {
+    seen += fCounts[bin];
+    if (seen > rank) return static_cast<Sample_t>(bin);
+  } // for
+
+  // can happen only if `rank` is out of range
+  throw cet::exception("ADCcountHistogram")
+    << "Requested sample #" << rank << " from a histogram with " << fN
+    << " samples.\n";
+} // opdet::ADCcountHistogram::nth()
+
+
+//------------------------------------------------------------------------------
+auto opdet::ADCcountHistogram::mode() const -> Sample_t {
+  assert(!empty());
+
+  std::size_t best = fLow;
+  for (std::size_t bin = fLow + 1; bin <= fHigh; ++bin)
+    if (fCounts[bin] > fCounts[best]) best = bin;
+
+  return static_cast<Sample_t>(best);
+} // opdet::ADCcountHistogram::mode()
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,182 @@
+/**
+ * @file   icaruscode/PMT/Algorithms/ADCcountHistogram.h
+ * @brief  Counting histogram of digitized samples, for median and mode.
+ * @date   October 18, 2026
+ * @see    icaruscode/PMT/Algorithms/ADCcountHistogram.cxx
+ */
+
+#ifndef ICARUSCODE_PMT_ALGORITHMS_ADCCOUNTHISTOGRAM_H
+#define ICARUSCODE_PMT_ALGORITHMS_ADCCOUNTHISTOGRAM_H
+
+
+// LArSoft libraries
+#include "lardataobj/RawData/OpDetWaveform.h" // raw::ADC_Count_t
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::clamp(), std::min(), std::max()
+#include <cstdint> // std::size_t
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------
+namespace opdet {
+
+  class ADCcountHistogram;
+
+  /// Returns the median of the samples between `begin` and `end`.
+  template <typename BIter, typename EIter>
+  raw::ADC_Count_t medianADC
+    (BIter begin, EIter end, ADCcountHistogram& workspace);
+
+  /// Returns the median of the samples between `begin` and `end`.
+  template <typename BIter, typename EIter>
+  raw::ADC_Count_t medianADC(BIter begin, EIter end);
+
+} // namespace opdet
+
+
+/**
+ * @class opdet::ADCcountHistogram
+ * @brief Histogram with a bin for each possible value of a digitized sample.
+ *
+ * The digitizers of the PMT readout produce integral samples with a limited
+ * resolution (14 bits for the CAEN V1730B).
+ * Statistics based on the order of the samples, like median and mode, can then
+ * be extracted by counting how many times each value appears, which takes a
+ * time linear with the number of samples and does not require to copy or sort
+ * them.
+ *
+ * The histogram keeps track of the range of values it has been filled with, so
+ * that both `clear()` and the extraction of the statistics take a time
+ * proportional to the spread of the samples rather than to the full range of
+ * the digitizer.
+ * The histogram memory is allocated only on construction, and it is meant to
+ * be reused for many sets of samples.
+ *
+ * Values out of the range of the digitizer (`0` to `2^bits - 1`) are counted
+ * as the closest valid value.
+ *
+ * Example of usage:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * opdet::ADCcountHistogram histogram;
+ * histogram.add(waveform.begin(), waveform.end());
+ * raw::ADC_Count_t const baseline = histogram.median();
+ * histogram.clear();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class opdet::ADCcountHistogram {
+    public:
+
+  using Sample_t = raw::ADC_Count_t; ///< Type of sample value.
+  using Count_t = unsigned int; ///< Type of the count in a bin.
+
+  /// Default resolution of the samples [bits].
+  static constexpr unsigned int DefaultBits = 14U;
+
+  /// Constructor: histogram for samples with the specified resolution.
+  explicit ADCcountHistogram(unsigned int bits = DefaultBits);
+
+
+  // --- BEGIN -- Filling ------------------------------------------------------
+  /// Adds a sample with the specified `value`.
+  void add(Sample_t value);
+
+  /// Adds all the samples between `begin` and `end`.
+  template <typename BIter, typename EIter>
+  void add(BIter begin, EIter end)
+    { for (auto it = begin; it != end; ++it) add(*it); }
+
+  /// Removes all the samples.
+  void clear();
+
+  // --- END ---- Filling ------------------------------------------------------
+
+
+  // --- BEGIN -- Statistics ---------------------------------------------------
+  /// Returns the number of samples in the histogram.
+  std::size_t size() const { return fN; }
+
+  /// Returns whether the histogram has no sample.
+  bool empty() const { return fN == 0U; }
+
+  /// Returns how many samples have the specified `value`.
+  Count_t count(Sample_t value) const { return fCounts[binOf(value)]; }
+
+  /**
+   * @brief Returns the value of the sample with the specified `rank`.
+   * @param rank the position of the requested sample in ascending order
+   * @return the value of the sample at position `rank` (`0` is the smallest)
+   *
+   * This is the same value that `std::nth_element()` would place at `rank`.
+   * The histogram must hold more than `rank` samples.
+   */
+  Sample_t nth(std::size_t rank) const;
+
+  /// Returns the median of the samples (the one at rank `size() / 2`).
+  Sample_t median() const { return nth(fN / 2); }
+
+  /// Returns the most frequent value (the lowest one, in case of tie).
+  Sample_t mode() const;
+
+  // --- END ---- Statistics ---------------------------------------------------
+
+    private:
+
+  std::vector<Count_t> fCounts; ///< Count of samples for each value.
+
+  std::size_t fN = 0U; ///< Number of samples in the histogram.
+
+  /// Lowest bin with entries ever since the last `clear()`.
+  std::size_t fLow;
+  /// Highest bin with entries ever since the last `clear()`.
+  std::size_t fHigh = 0U;
+
+  /// Returns the index of the bin for `value`.
+  std::size_t binOf(Sample_t value) const
+    {
+      return static_cast<std::size_t>(std::clamp
+        (static_cast<long int>(value), 0L, long(fCounts.size() - 1)));
+    }
+
+}; // opdet::ADCcountHistogram
+
+
+//------------------------------------------------------------------------------
+//---  Inline implementation
+//------------------------------------------------------------------------------
+inline void opdet::ADCcountHistogram::add(Sample_t value) {
+  std::size_t const bin = binOf(value);
+  ++fCounts[bin];
+  ++fN;
+  fLow = std::min(fLow, bin);
+  fHigh = std::max(fHigh, bin);
+} // opdet::ADCcountHistogram::add()
+
+
+//------------------------------------------------------------------------------
+//---  Template implementation
+//------------------------------------------------------------------------------
+template <typename BIter, typename EIter>
+raw::ADC_Count_t opdet::medianADC
+  (BIter begin, EIter end, ADCcountHistogram& workspace)
+{
+  assert(workspace.empty());
+  workspace.add(begin, end);
+  raw::ADC_Count_t const median = workspace.median();
+  workspace.clear();
+  return median;
+} // opdet::medianADC()
+
+
+//------------------------------------------------------------------------------
+template <typename BIter, typename EIter>
+raw::ADC_Count_t opdet::medianADC(BIter begin, EIter end) {
+  thread_local ADCcountHistogram workspace;
+  return medianADC(begin, end, workspace);
+} // opdet::medianADC()
+
+
+//------------------------------------------------------------------------------
+
+#endif // ICARUSCODE_PMT_ALGORITHMS_ADCCOUNTHISTOGRAM_H
@@ -15,18 +15,124 @@
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 // C++ standard library
+#include <optional>
+#include <sstream>
+#include <ios> // std::hexfloat, std::ios_base
+#include <algorithm> // std::copy(), std::transform()
 #include <functional> // std::function
 #include <utility> // std::cref()
+#include <cmath> // std::floor(), std::round()
+#include <cassert>
 
 
 // -----------------------------------------------------------------------------
 // ---  icarus::opdet::DiscretePhotoelectronPulse
+// -----------------------------------------------------------------------------
+icarus::opdet::DiscretePhotoelectronPulse::DiscretePhotoelectronPulse(
+  PulseFunction_t const& pulseShape,
+  gigahertz samplingFreq, unsigned int nSubsamples, /* = 1U */
+  ADCcount samplingThreshold, /* = 1e-6_ADCf */
+  PhotoelectronPulseTemplateCache const* cache /* = nullptr */
+  )
+  : fShape(pulseShape)
+  , fSamplingFreq(samplingFreq)
+{
+  using Template_t = PhotoelectronPulseTemplateCache::Template_t;
+  
+  bool const useCache = cache && cache->enabled();
+  std::string const key = useCache
+    ? cacheKey(shape(), fSamplingFreq, nSubsamples, samplingThreshold): "";
+  
+  std::optional<Template_t> sampling;
+  if (useCache) sampling = cache->load(key);
+  if (!sampling) {
+    sampling
+      = sampleShape(shape(), fSamplingFreq, nSubsamples, samplingThreshold);
+    if (useCache) cache->store(key, *sampling);
+  }
+  
+  fillSamples(*sampling);
+  
+} // icarus::opdet::DiscretePhotoelectronPulse::DiscretePhotoelectronPulse()
+
+
+// -----------------------------------------------------------------------------
+auto icarus::opdet::DiscretePhotoelectronPulse::closestSubsampleIndex
+  (Time_t time) const -> SubsampleIndex_t
+{
+  double const ticks = time.value() / samplingPeriod().value();
+  double const fraction = ticks - std::floor(ticks);
+  auto const i = static_cast<SubsampleIndex_t>
+    (std::round(fraction * static_cast<double>(fNSubsamples)));
+  return i % fNSubsamples; // closest to the start of the next tick?
+} // icarus::opdet::DiscretePhotoelectronPulse::closestSubsampleIndex()
+
+
+// -----------------------------------------------------------------------------
+void icarus::opdet::DiscretePhotoelectronPulse::fillSamples
+  (PhotoelectronPulseTemplateCache::Template_t const& sampling)
+{
+  assert(sampling.samples.size() == sampling.nSubsamples * sampling.length);
+  
+  fNSubsamples = static_cast<SubsampleIndex_t>(sampling.nSubsamples);
+  fPulseLength = sampling.length;
+  fSubsampleStride = ((fPulseLength + SamplesPerBlock - 1) / SamplesPerBlock)
+    * SamplesPerBlock;
+  
+  // padding samples are left to 0
+  fSamples.assign(sampling.nSubsamples * fSubsampleStride, ADCcount{ 0 });
+  for (std::size_t i = 0; i < sampling.nSubsamples; ++i) {
+    auto const first = sampling.samples.begin() + i * fPulseLength;
+    std::transform(first, first + fPulseLength,
+      fSamples.begin() + i * fSubsampleStride,
+      [](float s){ return ADCcount{ s }; }
+      );
+  } // for subsamples
+  
+} // icarus::opdet::DiscretePhotoelectronPulse::fillSamples()
+
+
+// -----------------------------------------------------------------------------
+std::string icarus::opdet::DiscretePhotoelectronPulse::cacheKey(
+  PulseFunction_t const& pulseShape,
+  gigahertz samplingFreq, unsigned int nSubsamples,
+  ADCcount threshold
+) {
+  /*
+   * The description of the function may not be complete, or not include
+   * enough precision: a number of function values is added as fingerprint,
+   * in an exact representation.
+   */
+  constexpr unsigned int NFingerprintPoints = 32U;
+  
+  std::ostringstream sstr;
+  sstr << pulseShape.toString();
+  
+  // all the numbers are written exactly, in hexadecimal floating point format;
+  // the format of the stream is restored afterwards
+  std::ios_base::fmtflags const flags = sstr.flags();
+  sstr << std::hexfloat
+    << "\nsampling: " << samplingFreq.value() << " GHz x"
+      << std::dec << nSubsamples << std::hexfloat
+    << "\nthreshold: " << threshold.value()
+    << "\npeak: " << pulseShape.peakAmplitude().value()
+      << " at " << pulseShape.peakTime().value()
+    << "\nvalues:";
+  nanoseconds const step = 4.0 * pulseShape.peakTime() / NFingerprintPoints;
+  for (unsigned int i = 0; i < NFingerprintPoints; ++i)
+    sstr << " " << pulseShape(i * step).value();
+  sstr.flags(flags);
+  
+  return sstr.str();
+} // icarus::opdet::DiscretePhotoelectronPulse::cacheKey()
+
+
 // -----------------------------------------------------------------------------
 auto icarus::opdet::DiscretePhotoelectronPulse::sampleShape(
   PulseFunction_t const& pulseShape,
   gigahertz samplingFreq, unsigned int nSubsamples,
   ADCcount threshold
-) -> SampledFunction_t
+) -> PhotoelectronPulseTemplateCache::Template_t
 {
   using namespace util::quantities::time_literals;
   using namespace icarus::waveform_operations;
@@ -67,7 +173,7 @@ auto icarus::opdet::DiscretePhotoelectronPulse::sampleShape(
       )
     ;
 
-  return SampledFunction_t{
+  SampledFunction_t const sampledShape{
     std::cref(pulseShape), // function to sample (by reference because abstract)
     0.0_ns,                // sampling start time
     1.0 / samplingFreq,    // tick duration
@@ -76,6 +182,16 @@ auto icarus::opdet::DiscretePhotoelectronPulse::sampleShape(
     pulseShape.peakTime() // sample at least until here
     };
 
+  PhotoelectronPulseTemplateCache::Template_t sampling;
+  sampling.nSubsamples = sampledShape.nSubsamples();
+  sampling.length = sampledShape.size();
+  sampling.samples.reserve(sampling.nSubsamples * sampling.length);
+  for (gsl::index i = 0; i < sampledShape.nSubsamples(); ++i) {
+    for (ADCcount const sample: sampledShape.subsample(i))
+      sampling.samples.push_back(sample.value());
+  } // for subsamples
+  return sampling;
+
 } // icarus::opdet::DiscretePhotoelectronPulse::sampleShape()
 
 
@@ -84,9 +200,8 @@ bool icarus::opdet::DiscretePhotoelectronPulse::checkRange
   (ADCcount limit, std::string const& outputCat /* = "" */) const
 {
   assert(pulseLength() > 0);
-  auto const low = *(fSampledShape.subsample(0).begin());
-  auto const high
-    = *(fSampledShape.subsample(fSampledShape.nSubsamples() - 1).rbegin());
+  auto const low = *(subsample(0).begin());
+  auto const high = *(subsample(nSubsamples() - 1).rbegin());
 
   bool const bLowOk = (low.abs() < limit);
   bool const bHighOk = (high.abs() < limit);
@@ -13,6 +13,7 @@
 
 // // ICARUS libraries
 #include "icaruscode/PMT/Algorithms/PhotoelectronPulseFunction.h"
+#include "icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.h"
 #include "icarusalg/Utilities/SampledFunction.h"
 
 // LArSoft libraries
@@ -22,9 +23,12 @@
 
 // guidelines library
 #include "gsl/gsl_util" // gsl::index
+#include "gsl/span"
 
 // C++ standard library
+#include <vector>
 #include <string>
+#include <new> // std::align_val_t
 #include <utility> // std::forward()
 #include <type_traits> // std::is_same_v, std::decay_t
 #include <cstdlib> // std::size_t
@@ -38,6 +42,40 @@ namespace icarus::opdet {
   
   class DiscretePhotoelectronPulse;
   
+  namespace details {
+    
+    /// Minimal allocator returning memory aligned to `Alignment` bytes.
+    template <typename T, std::size_t Alignment>
+    struct AlignedAllocator {
+      
+      using value_type = T;
+      
+      template <typename U>
+      struct rebind { using other = AlignedAllocator<U, Alignment>; };
+      
+      AlignedAllocator() noexcept = default;
+      template <typename U>
+      AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept {}
+      
+      T* allocate(std::size_t n)
+        {
+          return static_cast<T*>
+            (::operator new(n * sizeof(T), std::align_val_t{ Alignment }));
+        }
+      void deallocate(T* p, std::size_t) noexcept
+        { ::operator delete(p, std::align_val_t{ Alignment }); }
+      
+      template <typename U>
+      bool operator== (AlignedAllocator<U, Alignment> const&) const noexcept
+        { return true; }
+      template <typename U>
+      bool operator!= (AlignedAllocator<U, Alignment> const&) const noexcept
+        { return false; }
+      
+    }; // AlignedAllocator
+    
+  } // namespace details
+  
 } // namespace icarus::opdet
 
 
@@ -54,6 +92,18 @@ namespace icarus::opdet {
  * A reference to the sampled function is kept available, so that function needs
  * to be valid for the lifetime of this object.
  * 
+ * The samples of all subsamples are stored in a single buffer. Each subsample
+ * starts at a `SampleAlignment` byte boundary, and it is padded with zeroes
+ * up to the following one, so that
+ * loops over a subsample can be vectorized with aligned loads.
+ * 
+ * If a template cache is specified at construction, the sampling is looked up
+ * in that cache first, and stored there if not found (see
+ * `icarus::opdet::PhotoelectronPulseTemplateCache`).
+ * The key of the cache includes the description of the function
+ * (`PhotoelectronPulseFunction::toString()`), a fingerprint of its values,
+ * the sampling frequency, the number of subsamples and the sampling threshold.
+ * 
  */
 class icarus::opdet::DiscretePhotoelectronPulse {
     public:
@@ -70,7 +120,7 @@ class icarus::opdet::DiscretePhotoelectronPulse {
     "The type of single response function does not take nanoseconds."
     );
 
-  /// Internal discretized representation of the sampled pulse shape.
+  /// Discretized representation of the sampled pulse shape.
   using SampledFunction_t = util::SampledFunction<nanoseconds, ADCcount>;
 
     public:
@@ -80,7 +130,10 @@ class icarus::opdet::DiscretePhotoelectronPulse {
   using SubsampleIndex_t = gsl::index; ///< Type of index of subsample.
 
   /// Type of subsample data (a sampling of the full range).
-  using Subsample_t = SampledFunction_t::SubsampleData_t;
+  using Subsample_t = gsl::span<ADCcount const>;
+
+  /// Alignment of the start of each subsample in memory [bytes].
+  static constexpr std::size_t SampleAlignment = 64U;
 
   static_assert(!std::is_same<Time_t, Tick_t>(),
     "Time and tick must be different types!");
@@ -101,17 +154,21 @@ class icarus::opdet::DiscretePhotoelectronPulse {
     * threshold, the sampling ends (that tick under threshold itself is also
     * discarded).
     *
+    * If a `cache` is specified and enabled, the sampling is loaded from it
+    * if available there, and saved into it otherwise.
+    *
     * The ownership of `pulseShape` is acquired by this object.
     */
   DiscretePhotoelectronPulse(
     PulseFunction_t const& pulseShape,
     gigahertz samplingFreq,
     unsigned int nSubsamples = 1U,
-    ADCcount samplingThreshold = 1e-6_ADCf
+    ADCcount samplingThreshold = 1e-6_ADCf,
+    PhotoelectronPulseTemplateCache const* cache = nullptr
     );
 
   /// Returns the length of the sampled pulse in ticks.
-  std::size_t pulseLength() const { return fSampledShape.size(); }
+  std::size_t pulseLength() const { return fPulseLength; }
 
   /// Evaluates the shape at the specified time.
   ADCcount operator() (Time_t time) const { return shape()(time); }
@@ -136,15 +193,18 @@ class icarus::opdet::DiscretePhotoelectronPulse {
   /// @{
 
   /// Returns the subsample specified by index `i`, undefined if invalid.
-  decltype(auto) subsample(SubsampleIndex_t i) const
-    { return fSampledShape.subsample(i); }
+  Subsample_t subsample(SubsampleIndex_t i) const
+    { return { fSamples.data() + i * fSubsampleStride, fPulseLength }; }
+
+  /// Returns the subsample whose tick left limit is closest to `time`.
+  Subsample_t subsampleFor(Time_t time) const
+    { return subsample(closestSubsampleIndex(time)); }
 
   /// Returns the index of the subsample whose tick left limit is closest to
-  /// `time` (see `util::SampledFunction::closestSubsampleIndex()`).
-  decltype(auto) subsampleFor(Time_t time) const
-    { return subsample(fSampledShape.closestSubsampleIndex(time)); }
+  /// `time` (as `util::SampledFunction::closestSubsampleIndex()`).
+  SubsampleIndex_t closestSubsampleIndex(Time_t time) const;
 
-  SubsampleIndex_t nSubsamples() const { return fSampledShape.nSubsamples(); }
+  SubsampleIndex_t nSubsamples() const { return fNSubsamples; }
 
   /// @}
   // --- END -- Access to subsamples -----------------------------------------
@@ -207,21 +267,44 @@ class icarus::opdet::DiscretePhotoelectronPulse {
 
     private:
 
+  /// Type of storage of the samples.
+  using SampleBuffer_t = std::vector
+    <ADCcount, details::AlignedAllocator<ADCcount, SampleAlignment>>;
+
+  /// Number of samples in an aligned block.
+  static constexpr std::size_t SamplesPerBlock
+    = SampleAlignment / sizeof(ADCcount);
+  static_assert(SampleAlignment % sizeof(ADCcount) == 0);
+
   /// Analytical shape of the pules.
   PulseFunction_t const& fShape;
   gigahertz fSamplingFreq; ///< Sampling frequency.
 
-  /// Pulse shape, discretized.
-  SampledFunction_t fSampledShape;
+  SubsampleIndex_t fNSubsamples = 0; ///< Number of subsamples.
+  std::size_t fPulseLength = 0U; ///< Number of samples in each subsample.
+  std::size_t fSubsampleStride = 0U; ///< Distance between subsample starts.
+
+  /// Pulse shape, discretized (all subsamples, aligned and padded).
+  SampleBuffer_t fSamples;
 
 
-  /// Builds the sampling cache.
-  static SampledFunction_t sampleShape(
+  /// Samples the shape.
+  static PhotoelectronPulseTemplateCache::Template_t sampleShape(
     PulseFunction_t const& pulseShape,
     gigahertz samplingFreq, unsigned int nSubsamples,
     ADCcount threshold
     );
 
+  /// Returns the key identifying a sampling in a template cache.
+  static std::string cacheKey(
+    PulseFunction_t const& pulseShape,
+    gigahertz samplingFreq, unsigned int nSubsamples,
+    ADCcount threshold
+    );
+
+  /// Fills the aligned sample storage from the `sampling` data.
+  void fillSamples(PhotoelectronPulseTemplateCache::Template_t const& sampling);
+
 }; // class DiscretePhotoelectronPulse<>
 
 
@@ -234,19 +317,6 @@ class icarus::opdet::DiscretePhotoelectronPulse {
 // -----------------------------------------------------------------------------
 // --- icarus::opdet::DiscretePhotoelectronPulse
 // -----------------------------------------------------------------------------
-inline icarus::opdet::DiscretePhotoelectronPulse::DiscretePhotoelectronPulse(
-  PulseFunction_t const& pulseShape,
-  gigahertz samplingFreq, unsigned int nSubsamples, /* = 1U */
-  ADCcount samplingThreshold /* = 1e-3_ADCf */
-  )
-  : fShape(pulseShape)
-  , fSamplingFreq(samplingFreq)
-  , fSampledShape
-    (sampleShape(shape(), fSamplingFreq, nSubsamples, samplingThreshold))
-  {}
-
-
-//-----------------------------------------------------------------------------
 template <typename Stream>
 void icarus::opdet::DiscretePhotoelectronPulse::dump(Stream&& out,
   std::string const& indent, std::string const& firstIndent
@@ -257,7 +327,8 @@ void icarus::opdet::DiscretePhotoelectronPulse::dump(Stream&& out,
     << " long, sampled at " << samplingFrequency()
     << ");"
     << "\n" << shape().toString(indent + "  ", indent);
-  fSampledShape.dump(out, indent + "  ", indent);
+  out << indent << "  " << nSubsamples() << " subsamples of " << pulseLength()
+    << " samples (" << fSubsampleStride << " reserved each)";
 } // icarus::opdet::DiscretePhotoelectronPulse::dump()
 
 
@@ -27,7 +27,6 @@
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandPoisson.h"
 #include "CLHEP/Random/RandGaussQ.h"
-#include "CLHEP/Random/RandExponential.h"
 
 // C++ standard libaries
 #include <chrono> // std::chrono::high_resolution_clock
@@ -104,16 +103,18 @@ icarus::opdet::PMTsimulationAlg::PMTsimulationAlg
   , fQE(fParams.QEbase / fParams.larProp->ScintPreScale())
   , fSampling(fParams.clockData->OpticalClock().Frequency())
   , fNsamples(fParams.readoutEnablePeriod * fSampling) // us * MHz cancels out
-  , wsp( // NOTE: wsp amplitude already includes sign from polarity
-    *(fParams.pulseFunction),
-    fSampling,
-    fParams.pulseSubsamples, // tick subsampling
-    1.0e-4_ADCf // stop sampling when ADC counts are below this value
-    )
+  , fSampledPulse
+    (fParams.sampledPulse? fParams.sampledPulse: samplePulse(fParams))
+  , wsp(*fSampledPulse)
   , fNoiseAdder(fParams.useFastElectronicsNoise
       ? &icarus::opdet::PMTsimulationAlg::AddNoise_faster
       : &icarus::opdet::PMTsimulationAlg::AddNoise
     )
+  , fSparseSimulation(fParams.sparseSimulation && canSimulateSparse())
+  , fFindThresholdCrossings{
+      { fParams.baseline + fParams.pulsePolarity * fParams.thresholdADC },
+      fParams.pulsePolarity
+    }
 {
   using namespace util::quantities::electronics_literals;
 
@@ -138,14 +139,44 @@ icarus::opdet::PMTsimulationAlg::PMTsimulationAlg
       ;
   }
 
+  if (fParams.sparseSimulation && !fSparseSimulation) {
+    mf::LogWarning("PMTsimulationAlg")
+      << "Sparse simulation was requested, but electronics noise within "
+      << fParams.sparseNoiseBound << " x " << fParams.ampNoise
+      << " may trigger the readout alone (threshold: " << fParams.thresholdADC
+      << "): full simulation will be performed instead.";
+  }
+
+} // icarus::opdet::PMTsimulationAlg::PMTsimulationAlg()
+
+
+// -----------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::samplePulse
+  (ConfigurationParameters_t const& config)
+  -> std::shared_ptr<DiscretePhotoelectronPulse const>
+{
+  using namespace util::quantities::electronics_literals;
+  
+  PhotoelectronPulseTemplateCache const cache { config.pulseTemplateCache };
+  
+  auto pulse = std::make_shared<DiscretePhotoelectronPulse const>(
+    // NOTE: wsp amplitude already includes sign from polarity
+    *(config.pulseFunction),
+    megahertz{ config.clockData->OpticalClock().Frequency() },
+    config.pulseSubsamples, // tick subsampling
+    1.0e-4_ADCf, // stop sampling when ADC counts are below this value
+    &cache
+    );
+  
   // check that the sampled waveform has a sufficiently large range, so that
   // tails are below 10^-3 ADC counts (absolute value);
   // if this test fails, it's better to reduce the threshold in wsp constructor
   // (for analytical pulses converging to 0) or have a longer sampling that does
   // converge to 0 (10^-3 ADC is quite low though).
-  wsp.checkRange(1.0e-3_ADCf, "PMTsimulationAlg");
-
-} // icarus::opdet::PMTsimulationAlg::PMTsimulationAlg()
+  pulse->checkRange(1.0e-3_ADCf, "PMTsimulationAlg");
+  
+  return pulse;
+} // icarus::opdet::PMTsimulationAlg::samplePulse()
 
 
 // -----------------------------------------------------------------------------
@@ -155,6 +186,12 @@ std::tuple<std::vector<raw::OpDetWaveform>, std::optional<sim::SimPhotons>>
 {
   std::optional<sim::SimPhotons> photons_used;
 
+  if (fSparseSimulation) {
+    auto waveforms
+      = CreateSparseOpDetWaveforms(photons, lite_photons, photons_used);
+    return { std::move(waveforms), std::move(photons_used) };
+  }
+
   Waveform_t const waveform = CreateFullWaveform(photons, lite_photons, photons_used);
 
   return {
@@ -181,11 +218,11 @@ auto icarus::opdet::PMTsimulationAlg::makeGainFluctuator() const {
 
 
 //------------------------------------------------------------------------------
-auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
+auto icarus::opdet::PMTsimulationAlg::CollectPhotoelectrons
   (sim::SimPhotons const& photons,
    sim::SimPhotonsLite const& lite_photons,
    std::optional<sim::SimPhotons>& photons_used)
-  const -> Waveform_t
+  const -> PhotoelectronMaps_t
 {
 
     using namespace util::quantities::time_literals;
@@ -206,8 +243,7 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
     // storage is by subtick group (vector index is the subtick), then by
     // tick (unordered map index is the tick number).
     //
-    std::vector<std::unordered_map<tick, unsigned int>> peMaps
-      (wsp.nSubsamples());
+    PhotoelectronMaps_t peMaps(wsp.nSubsamples());
 
     // returns tick and relative subtick number
     TimeToTickAndSubtickConverter const toTickAndSubtick(peMaps.size());
@@ -275,6 +311,23 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
         peMaps[subtick][tick] += nPE;
     }
 
+    // dark noise photoelectrons join the ones from the photons
+    if (fParams.darkNoiseRate > 0.0_Hz) AddDarkNoise(peMaps, fNsamples);
+
+    return peMaps;
+  } // CollectPhotoelectrons()
+
+
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
+  (sim::SimPhotons const& photons,
+   sim::SimPhotonsLite const& lite_photons,
+   std::optional<sim::SimPhotons>& photons_used)
+  const -> Waveform_t
+{
+    PhotoelectronMaps_t const peMaps
+      = CollectPhotoelectrons(photons, lite_photons, photons_used);
+
     //
     // add the collected photoelectrons to the waveform
     //
@@ -318,25 +371,306 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
 //       std::cout << "\tadded pes... " << photons.OpChannel() << " " << diff.count() << std::endl;
 //       start=std::chrono::high_resolution_clock::now();
 
-      if(fParams.ampNoise > 0.0_ADCf) (this->*fNoiseAdder)(waveform);
-      if(fParams.darkNoiseRate > 0.0_Hz) AddDarkNoise(waveform);
+    ApplyElectronics(waveform);
+    
+    return waveform;
+  } // CreateFullWaveform()
+
 
-//       end=std::chrono::high_resolution_clock::now(); diff = end-start;
-//       std::cout << "\tadded noise... " << photons.OpChannel() << " " << diff.count() << std::endl;
-//       start=std::chrono::high_resolution_clock::now();
-      
-    // saturation in terms of photoelectrons (sharp);
-    auto const ADCrange = fParams.ADCrange();
-    ApplySaturation(waveform, ADCrange);
+//------------------------------------------------------------------------------
+void icarus::opdet::PMTsimulationAlg::ApplyElectronics
+  (Waveform_t& waveform) const
+{
+  using namespace util::quantities::electronics_literals;
+  
+  if(fParams.ampNoise > 0.0_ADCf) (this->*fNoiseAdder)(waveform);
+  
+  // saturation in terms of photoelectrons (sharp);
+  auto const ADCrange = fParams.ADCrange();
+  ApplySaturation(waveform, ADCrange);
+  
+  // clip to the ADC range, 0 -- 2
+  ClipWaveform(waveform, ADCrange.first, ADCrange.second);
+  
+} // icarus::opdet::PMTsimulationAlg::ApplyElectronics()
+
+
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::MakePhotoelectronTrain
+  (PhotoelectronMaps_t const& peMaps) const -> PhotoelectronTrain_t
+{
+  PhotoelectronTrain_t train;
+  train.reserve(std::accumulate(
+    peMaps.begin(), peMaps.end(), std::size_t{ 0 },
+    [](std::size_t n, auto const& map){ return n + map.size(); }
+    ));
+  
+  auto gainFluctuation = makeGainFluctuator();
+  
+  // same iteration order as in `CreateFullWaveform()`
+  for (auto const& [ iSubsample, peMap ]: util::enumerate(peMaps)) {
+    for (auto const& [ startTick, nPE ]: peMap) {
+      train.push_back({
+        static_cast<std::size_t>(startTick.value()),
+        static_cast<DiscretePhotoelectronPulse::SubsampleIndex_t>(iSubsample),
+        static_cast<WaveformValue_t>(gainFluctuation(nPE))
+        });
+    } // for sample
+  } // for subsamples
+  
+  std::sort(train.begin(), train.end(),
+    [](PhotoelectronGroup_t const& a, PhotoelectronGroup_t const& b)
+      { return a.startTick < b.startTick; }
+    );
+  
+  return train;
+} // icarus::opdet::PMTsimulationAlg::MakePhotoelectronTrain()
+
+
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::CreateSignalSegment(
+  PhotoelectronTrain_t::const_iterator begin,
+  PhotoelectronTrain_t::const_iterator end,
+  std::size_t startTick, std::size_t endTick
+) const -> Waveform_t {
+  
+  assert(startTick <= endTick);
+  Waveform_t segment(endTick - startTick, fParams.baseline);
+  
+  for (auto iGroup = begin; iGroup != end; ++iGroup) {
     
-    // clip to the ADC range, 0 -- 2
-    ClipWaveform(waveform, ADCrange.first, ADCrange.second);
+    PhotoelectronGroup_t const& group = *iGroup;
+    if (group.nEffectivePE == 0.0) continue;
+    if (group.startTick >= endTick) continue;
     
-//       end=std::chrono::high_resolution_clock::now(); diff = end-start;
-//       std::cout << "\tadded saturation... " << photons.OpChannel() << " " << diff.count() << std::endl;
+    auto const& pulse = wsp.subsample(group.subsample);
     
-    return waveform;
-  } // CreateFullWaveform()
+    // skip the part of the pulse before the start of the segment
+    std::size_t const pulseSkip
+      = (group.startTick < startTick)? (startTick - group.startTick): 0;
+    if (pulseSkip >= static_cast<std::size_t>(pulse.size())) continue;
+    
+    std::size_t const first = group.startTick + pulseSkip - startTick;
+    std::size_t const n = std::min(
+      static_cast<std::size_t>(pulse.size()) - pulseSkip,
+      segment.size() - first
+      );
+    
+    WaveformValue_t const nPE = group.nEffectivePE;
+    std::transform(
+      segment.begin() + first, segment.begin() + first + n,
+      pulse.begin() + pulseSkip,
+      segment.begin() + first,
+      [nPE](auto a, auto b) { return a + nPE * b; }
+      );
+    
+  } // for groups
+  
+  return segment;
+} // icarus::opdet::PMTsimulationAlg::CreateSignalSegment()
+
+
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::CreateSignalSegment(
+  PhotoelectronTrain_t const& train,
+  std::size_t startTick, std::size_t endTick
+) const -> Waveform_t {
+  
+  // pulses starting earlier than this can't reach `startTick`
+  std::size_t const pulseLength = wsp.pulseLength();
+  std::size_t const earliestStart
+    = (startTick > pulseLength)? (startTick - pulseLength): 0;
+  
+  auto const byStartTick = [](PhotoelectronGroup_t const& group, std::size_t t)
+    { return group.startTick < t; };
+  auto const begin = std::lower_bound
+    (train.begin(), train.end(), earliestStart, byStartTick);
+  auto const end = std::lower_bound(begin, train.end(), endTick, byStartTick);
+  
+  return CreateSignalSegment(begin, end, startTick, endTick);
+  
+} // icarus::opdet::PMTsimulationAlg::CreateSignalSegment(train)
+
+
+//------------------------------------------------------------------------------
+std::vector<raw::OpDetWaveform>
+icarus::opdet::PMTsimulationAlg::CreateSparseOpDetWaveforms
+  (sim::SimPhotons const& photons,
+   sim::SimPhotonsLite const& lite_photons,
+   std::optional<sim::SimPhotons>& photons_used)
+  const
+{
+  /*
+   * Plan:
+   * 
+   * 1. collect all photoelectrons with their (fluctuated) gain
+   * 2. find the ranges of ticks where the signal, without electronics noise,
+   *    may be beyond threshold once the noise is added
+   * 3. simulate the full waveform in those ranges and find the triggers there
+   * 4. define the readout buffers around those triggers
+   *    (same as `CreateFixedSizeOpDetWaveforms()`)
+   * 5. simulate the full waveform in the buffers, reusing the samples from
+   *    step 3., and create the actual `raw::OpDetWaveform` objects
+   * 
+   */
+  using namespace detinfo::timescales; // electronics_time, time_interval, ...
+  
+  raw::Channel_t const opChannel = photons.OpChannel();
+  
+  //
+  // 1. photoelectrons
+  //
+  PhotoelectronTrain_t const train = MakePhotoelectronTrain
+    (CollectPhotoelectrons(photons, lite_photons, photons_used));
+  
+  //
+  // 2. ranges which may trigger
+  //
+  
+  // a trigger candidate tick is one where noiseless signal plus the largest
+  // noise fluctuation passes the threshold
+  ADCcount const noiseBound = fParams.ampNoise * fParams.sparseNoiseBound;
+  auto const isCandidate = [this,noiseBound](ADCcount sample)
+    {
+      return fParams.pulsePolarity * (sample - fParams.baseline) + noiseBound
+        >= fParams.thresholdADC;
+    };
+  
+  std::size_t const pulseLength = wsp.pulseLength();
+  std::vector<std::pair<std::size_t, std::size_t>> candidateRanges;
+  
+  auto iGroup = train.cbegin();
+  auto const gend = train.cend();
+  while (iGroup != gend) {
+    
+    // find the next range of ticks covered by any pulse
+    std::size_t const activeStart = iGroup->startTick;
+    if (activeStart >= fNsamples) break;
+    std::size_t activeEnd = activeStart + pulseLength;
+    auto iNextGroup = std::next(iGroup);
+    while ((iNextGroup != gend) && (iNextGroup->startTick < activeEnd)) {
+      activeEnd = iNextGroup->startTick + pulseLength; // sorted start ticks
+      ++iNextGroup;
+    }
+    activeEnd = std::min(activeEnd, fNsamples);
+    
+    Waveform_t const signal
+      = CreateSignalSegment(iGroup, iNextGroup, activeStart, activeEnd);
+    
+    // collect all the candidate ticks in ranges, merging contiguous ones
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+      if (!isCandidate(signal[i])) continue;
+      std::size_t const t = activeStart + i;
+      if (!candidateRanges.empty() && (candidateRanges.back().second == t))
+        ++candidateRanges.back().second;
+      else
+        candidateRanges.emplace_back(t, t + 1);
+    } // for
+    
+    iGroup = iNextGroup;
+  } // while
+  
+  //
+  // 3. simulation of the candidate ranges, and trigger finding
+  //
+  std::vector<std::pair<std::size_t, Waveform_t>> simulatedRanges;
+  simulatedRanges.reserve(candidateRanges.size());
+  std::vector<optical_tick> trigger_locations;
+  for (auto const& [ startTick, endTick ]: candidateRanges) {
+    
+    Waveform_t waveform = CreateSignalSegment(train, startTick, endTick);
+    ApplyElectronics(waveform);
+    
+    // the tick before a candidate range is not a candidate: under threshold
+    std::vector<optical_tick> const triggers
+      = FindThresholdCrossings(waveform, startTick);
+    trigger_locations.insert
+      (trigger_locations.end(), triggers.begin(), triggers.end());
+    
+    simulatedRanges.emplace_back(startTick, std::move(waveform));
+  } // for
+  
+  MergeBeamGateTriggers(trigger_locations);
+  
+  //
+  // 4. readout buffers
+  //
+  std::vector<BufferRange_t> const buffers
+    = MakeReadoutBuffers(trigger_locations);
+  
+  MF_LOG_TRACE("PMTsimulationAlg")
+    << "Channel #" << opChannel << ": " << buffers.size() << " waveforms for "
+    << trigger_locations.size() << " triggers (sparse simulation of "
+    << candidateRanges.size() << " candidate ranges)"
+    ;
+  
+  //
+  // 5. simulation of the buffers
+  //
+  detinfo::DetectorTimings const& timings
+    = detinfo::makeDetectorTimings(fParams.clockData);
+  electronics_time const PMTstartTime
+    = timings.TriggerTime() + time_interval{ fParams.triggerOffsetPMT };
+  nanoseconds const samplingPeriod = 1.0 / fSampling;
+  
+  std::vector<raw::OpDetWaveform> output_opdets;
+  output_opdets.reserve(buffers.size());
+  auto iSimulated = simulatedRanges.cbegin();
+  auto const send = simulatedRanges.cend();
+  for (BufferRange_t const& buffer: buffers) {
+    
+    std::size_t const start
+      = std::min(std::size_t(buffer.first.value()), fNsamples);
+    std::size_t const end
+      = std::min(std::size_t(buffer.second.value()), fNsamples);
+    assert(start <= end);
+    
+    Waveform_t waveform = CreateSignalSegment(train, start, end);
+    ApplyElectronics(waveform);
+    
+    // overwrite with the samples which were already simulated
+    while ((iSimulated != send)
+      && (iSimulated->first + iSimulated->second.size() <= start)
+    ) {
+      ++iSimulated;
+    }
+    for (auto iRange = iSimulated; iRange != send; ++iRange) {
+      auto const& [ rangeStart, rangeWaveform ] = *iRange;
+      if (rangeStart >= end) break;
+      std::size_t const first = std::max(rangeStart, start);
+      std::size_t const last
+        = std::min(rangeStart + rangeWaveform.size(), end);
+      std::copy(
+        rangeWaveform.begin() + (first - rangeStart),
+        rangeWaveform.begin() + (last - rangeStart),
+        waveform.begin() + (first - start)
+        );
+    } // for simulated ranges
+    
+    // create the waveform (need to unwrap the ADCcount value)
+    raw::OpDetWaveform& outputWaveform = output_opdets.emplace_back(
+      raw::TimeStamp_t{ PMTstartTime + start * samplingPeriod },
+      opChannel, waveform.size()
+      );
+    std::transform(
+      waveform.begin(), waveform.end(), std::back_inserter(outputWaveform),
+      [](auto sample){ return sample.value(); }
+      );
+    
+  } // for buffers
+  
+  return output_opdets;
+} // icarus::opdet::PMTsimulationAlg::CreateSparseOpDetWaveforms()
+
+
+//------------------------------------------------------------------------------
+bool icarus::opdet::PMTsimulationAlg::canSimulateSparse() const {
+  
+  // the noise alone must not be able to reach the threshold
+  return fParams.ampNoise * fParams.sparseNoiseBound < fParams.thresholdADC;
+  
+} // icarus::opdet::PMTsimulationAlg::canSimulateSparse()
+
 
   auto icarus::opdet::PMTsimulationAlg::CreateBeamGateTriggers() const
     -> std::vector<optical_tick>
@@ -368,41 +702,48 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
   auto icarus::opdet::PMTsimulationAlg::FindTriggers(Waveform_t const& wvfm) const
     -> std::vector<optical_tick>
   {
-    std::vector<optical_tick> trigger_locations;
-
-    // find all ticks at which we would trigger readout
-    bool above_thresh=false;
-    for(size_t i_t=0; i_t<wvfm.size(); ++i_t){
+    std::vector<optical_tick> trigger_locations = FindThresholdCrossings(wvfm);
 
-      auto const val { fParams.pulsePolarity* (wvfm[i_t]-fParams.baseline) };
+    // next, add the triggers injected at beam gate time
+    MergeBeamGateTriggers(trigger_locations);
 
-      if(!above_thresh && val>=fParams.thresholdADC){
-	above_thresh=true;
-	trigger_locations.push_back(optical_tick::castFrom(i_t));
-      }
-      else if(above_thresh && val<fParams.thresholdADC){
-	above_thresh=false;
-      }
+    return trigger_locations;
+  }
 
-    }//end loop over waveform
+  auto icarus::opdet::PMTsimulationAlg::FindThresholdCrossings
+    (Waveform_t const& wvfm, std::size_t startTick /* = 0 */) const
+    -> std::vector<optical_tick>
+  {
+    // find all ticks at which we would trigger readout
+    // (the threshold level is `baseline + polarity x threshold`)
+    std::vector<std::size_t> const openings
+      = fFindThresholdCrossings(wvfm, startTick).front().opening;
 
-    // next, add the triggers injected at beam gate time
-    if (fParams.createBeamGateTriggers) {
-      auto beamGateTriggers = CreateBeamGateTriggers();
-
-      // insert the new triggers and sort them
-      trigger_locations.insert(trigger_locations.end(),
-        beamGateTriggers.begin(), beamGateTriggers.end());
-      std::inplace_merge(
-        trigger_locations.begin(),
-        trigger_locations.end() - beamGateTriggers.size(),
-        trigger_locations.end()
-        );
-    }
+    std::vector<optical_tick> trigger_locations;
+    trigger_locations.reserve(openings.size());
+    for (std::size_t const tick: openings)
+      trigger_locations.push_back(optical_tick::castFrom(tick));
 
     return trigger_locations;
   }
 
+  void icarus::opdet::PMTsimulationAlg::MergeBeamGateTriggers
+    (std::vector<optical_tick>& trigger_locations) const
+  {
+    if (!fParams.createBeamGateTriggers) return;
+
+    auto beamGateTriggers = CreateBeamGateTriggers();
+
+    // insert the new triggers and sort them
+    trigger_locations.insert(trigger_locations.end(),
+      beamGateTriggers.begin(), beamGateTriggers.end());
+    std::inplace_merge(
+      trigger_locations.begin(),
+      trigger_locations.end() - beamGateTriggers.size(),
+      trigger_locations.end()
+      );
+  }
+
 //------------------------------------------------------------------------------
 std::vector<raw::OpDetWaveform>
 icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
@@ -420,27 +761,14 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
    */
   
   //
-  // parameters check and setup
+  // setup
   //
   
-  // not a big deal if this assertion fails, but a bit more care needs to be
-  // taken in comparisons and subtractions
-  static_assert(
-    std::is_signed_v<optical_tick::value_t>,
-    "This algorithm requires tick type to be signed."
-    );
-  
   using namespace detinfo::timescales; // electronics_time, time_interval, ...
 
-  auto const pretrigSize = optical_time_ticks::castFrom(fParams.pretrigSize());
-  auto const posttrigSize = optical_time_ticks::castFrom(fParams.posttrigSize());
-  
   detinfo::DetectorTimings const& timings
     = detinfo::makeDetectorTimings(fParams.clockData);
 
-  // first viable tick number: since this is the item index in `wvfm`, it's 0
-  optical_tick const firstTick { 0 };
-
   // use hardware trigger time plus the configured offset as waveform start time
   OpDetWaveformMaker_t createOpDetWaveform {
     waveform,
@@ -454,6 +782,51 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
   
   // prepare the set of triggers
   std::vector<optical_tick> const trigger_locations = FindTriggers(waveform);
+  
+  //
+  // collect all buffer ranges and merge them
+  //
+  std::vector<BufferRange_t> const buffers
+    = MakeReadoutBuffers(trigger_locations);
+  
+  //
+  // turn each buffer into a waveform
+  //
+  MF_LOG_TRACE("PMTsimulationAlg")
+    << "Channel #" << opChannel << ": " << buffers.size() << " waveforms for "
+    << trigger_locations.size() << " triggers"
+    ;
+  std::vector<raw::OpDetWaveform> output_opdets;
+  for (BufferRange_t const& buffer: buffers) {
+    
+    output_opdets.push_back(createOpDetWaveform(opChannel, buffer));
+    
+  } // for buffers
+  
+  return output_opdets;
+} // icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms()
+
+
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::MakeReadoutBuffers
+  (std::vector<optical_tick> const& trigger_locations) const
+  -> std::vector<BufferRange_t>
+{
+  // not a big deal if this assertion fails, but a bit more care needs to be
+  // taken in comparisons and subtractions
+  static_assert(
+    std::is_signed_v<optical_tick::value_t>,
+    "This algorithm requires tick type to be signed."
+    );
+  
+  using namespace detinfo::timescales; // optical_time_ticks, ...
+
+  auto const pretrigSize = optical_time_ticks::castFrom(fParams.pretrigSize());
+  auto const posttrigSize = optical_time_ticks::castFrom(fParams.posttrigSize());
+  
+  // first viable tick number: since this is the item index in `wvfm`, it's 0
+  optical_tick const firstTick { 0 };
+
   auto const tend = trigger_locations.end();
   
   // find the first viable trigger
@@ -465,7 +838,6 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
   //
   // collect all buffer ranges and merge them
   //
-  using BufferRange_t = OpDetWaveformMaker_t::BufferRange_t;
   auto makeBuffer
     = [pretrigSize, posttrigSize](optical_tick triggerTime) -> BufferRange_t
     { return { triggerTime - pretrigSize, triggerTime + posttrigSize }; }
@@ -490,22 +862,8 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
     ++iNextTrigger;
   } // while
   
-  //
-  // turn each buffer into a waveform
-  //
-  MF_LOG_TRACE("PMTsimulationAlg")
-    << "Channel #" << opChannel << ": " << buffers.size() << " waveforms for "
-    << trigger_locations.size() << " triggers"
-    ;
-  std::vector<raw::OpDetWaveform> output_opdets;
-  for (BufferRange_t const& buffer: buffers) {
-    
-    output_opdets.push_back(createOpDetWaveform(opChannel, buffer));
-    
-  } // for buffers
-  
-  return output_opdets;
-} // icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms()
+  return buffers;
+} // icarus::opdet::PMTsimulationAlg::MakeReadoutBuffers()
 
 
 // -----------------------------------------------------------------------------
@@ -592,58 +950,69 @@ void icarus::opdet::PMTsimulationAlg::AddNoise_faster(Waveform_t& wave) const {
 
 
 // -----------------------------------------------------------------------------
-void icarus::opdet::PMTsimulationAlg::AddDarkNoise(Waveform_t& wave) const {
+void icarus::opdet::PMTsimulationAlg::AddDarkNoise
+  (PhotoelectronMaps_t& peMaps, std::size_t nSamples) const
+{
   /*
    * We assume leakage current ("dark noise") is completely stochastic and
    * distributed uniformly in time with a fixed and known rate.
    *
-   * In these condition, the time between two consecutive events follows an
-   * exponential distribution with as decay constant the same rate.
-   * We extact all the leakage events (including the first one) according to
-   * that distribution.
+   * In these condition, the number of events in the whole waveform follows
+   * a Poisson distribution with mean the rate times the waveform duration,
+   * and each of the events is uniformly distributed in time, independently
+   * of the others.
+   * We extract the number of events first, then all their times at once;
+   * times are sorted only to make the insertion in the maps more orderly.
    *
    * We follow the "standard" approach of subsampling of tick as for the
-   * photoelectron.
+   * photoelectron, and in fact the events are just added to the same
+   * photoelectron maps: gain fluctuations and pulse shape are applied to them
+   * together with the ones from the scintillation photons.
    *
    */
   using namespace util::quantities::frequency_literals;
 
   if (fParams.darkNoiseRate <= 0.0_Hz) return; // no dark noise
-
-  // CLHEP random objects do not understand quantities, so we use scalars;
-  // we choose to work with nanosecond
-  CLHEP::RandExponential random(*(fParams.darkNoiseRandomEngine),
-    (1.0 / fParams.darkNoiseRate).convertInto<nanoseconds>().value());
+  if (nSamples == 0) return;
 
   // time to stop at: full duration of the waveform
-  nanoseconds const maxTime = static_cast<double>(wave.size()) / fSampling;
+  nanoseconds const maxTime = static_cast<double>(nSamples) / fSampling;
 
-  // the time of first leakage event:
-  nanoseconds darkNoiseTime { random.fire() };
-
-  TimeToTickAndSubtickConverter const toTickAndSubtick(wsp.nSubsamples());
+  // CLHEP random objects do not understand quantities, so we use scalars;
+  // we choose to work with nanosecond
+  double const meanDarkPulses
+    = maxTime.value()
+    / (1.0 / fParams.darkNoiseRate).convertInto<nanoseconds>().value();
 
-  auto gainFluctuation = makeGainFluctuator();
+  long int const nDarkPulses = CLHEP::RandPoisson::shoot
+    (fParams.darkNoiseRandomEngine, meanDarkPulses);
 
   MF_LOG_TRACE("PMTsimulationAlg")
-    << "Adding dark noise (" << fParams.darkNoiseRate << ") up to " << maxTime;
+    << "Adding " << nDarkPulses << " dark noise photoelectrons ("
+    << fParams.darkNoiseRate << ", " << meanDarkPulses << " expected) up to "
+    << maxTime;
 
-  while (darkNoiseTime < maxTime) {
+  if (nDarkPulses <= 0) return;
 
-    auto const [ tick, subtick ] = toTickAndSubtick(darkNoiseTime * fSampling);
+  // times, in units of ticks, in [ 0, nSamples [
+  std::vector<double> darkNoiseTicks(nDarkPulses);
+  CLHEP::RandFlat::shootArray(
+    fParams.darkNoiseRandomEngine, static_cast<int>(nDarkPulses),
+    darkNoiseTicks.data(), 0.0, static_cast<double>(nSamples)
+    );
+  std::sort(darkNoiseTicks.begin(), darkNoiseTicks.end());
 
-    double const n = gainFluctuation(1.0); // leakage is one photoelectron
-    MF_LOG_TRACE("PMTsimulationAlg")
-      << " * at " << darkNoiseTime << " (" << tick << ", subsample " << subtick
-      << ") x" << n;
+  TimeToTickAndSubtickConverter const toTickAndSubtick(peMaps.size());
+  tick const endSample = tick::castFrom(nSamples);
 
-    AddPhotoelectrons
-      (wsp.subsample(subtick), wave, tick, static_cast<WaveformValue_t>(n));
+  for (double const tick_d: darkNoiseTicks) {
 
-    // time of the next leakage event:
-    darkNoiseTime += nanoseconds{ random.fire() };
+    auto const [ tick, subtick ] = toTickAndSubtick(tick_d);
+    if (tick >= endSample) continue; // protect from rounding at the very end
 
-  } // while
+    ++peMaps[subtick][tick]; // leakage is one photoelectron
+
+  } // for
 
 } // icarus::opdet::PMTsimulationAlg::AddDarkNoise()
 
@@ -780,6 +1149,7 @@ icarus::opdet::PMTsimulationAlgMaker::PMTsimulationAlgMaker
   // single photoelectron response
   //
   fBaseConfig.pulseSubsamples          = config.PulseSubsamples();
+  fBaseConfig.pulseTemplateCache       = config.PulseTemplateCache();
 
   //
   // dark noise
@@ -792,6 +1162,12 @@ icarus::opdet::PMTsimulationAlgMaker::PMTsimulationAlgMaker
   fBaseConfig.ampNoise                 = ADCcount(config.AmpNoise());
   fBaseConfig.useFastElectronicsNoise  = config.FastElectronicsNoise();
 
+  //
+  // sparse simulation
+  //
+  fBaseConfig.sparseSimulation         = config.SparseSimulation();
+  fBaseConfig.sparseNoiseBound         = config.SparseNoiseBound();
+
   //
   // trigger
   //
@@ -883,6 +1259,8 @@ auto icarus::opdet::PMTsimulationAlgMaker::makeParams(
   
   params.trackSelectedPhotons = trackSelectedPhotons;
   
+  params.sampledPulse = sampledPulse(params);
+  
   //
   // setup checks
   //
@@ -903,4 +1281,29 @@ auto icarus::opdet::PMTsimulationAlgMaker::makeParams(
 } // icarus::opdet::PMTsimulationAlgMaker::create()
 
 
+//-----------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlgMaker::sampledPulse
+  (PMTsimulationAlg::ConfigurationParameters_t const& params) const
+  -> std::shared_ptr<DiscretePhotoelectronPulse const>
+{
+  util::quantities::megahertz const samplingFreq
+    { params.clockData->OpticalClock().Frequency() };
+  
+  std::lock_guard const lock { fSampledPulseMutex };
+  
+  // the response function is owned by the caller and is usually the same
+  // for the whole job, as is the sampling frequency: then the pulse is sampled
+  // (or read from the template cache) only once
+  if (!fSampledPulse
+    || (&(fSampledPulse->shape()) != params.pulseFunction)
+    || (fSampledPulseFreq != samplingFreq)
+  ) {
+    fSampledPulse = PMTsimulationAlg::samplePulse(params);
+    fSampledPulseFreq = samplingFreq;
+  }
+  
+  return fSampledPulse;
+} // icarus::opdet::PMTsimulationAlgMaker::sampledPulse()
+
+
 //-----------------------------------------------------------------------------
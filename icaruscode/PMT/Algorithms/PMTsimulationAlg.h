@@ -17,6 +17,8 @@
 
 // ICARUS libraries
 #include "icaruscode/PMT/Algorithms/DiscretePhotoelectronPulse.h"
+#include "icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.h"
+#include "icaruscode/PMT/Algorithms/ThresholdCrossingFinder.h"
 #include "icaruscode/PMT/Algorithms/PhotoelectronPulseFunction.h"
 #include "icarusalg/Utilities/SampledFunction.h"
 #include "icarusalg/Utilities/FastAndPoorGauss.h"
@@ -45,12 +47,14 @@
 
 // C++ standard library
 #include <vector>
+#include <unordered_map>
 #include <string>
 #include <tuple>
 #include <optional>
 #include <ios> // std::boolalpha
 #include <utility> // std::forward()
-#include <memory> // std::unique_ptr()
+#include <memory> // std::unique_ptr(), std::shared_ptr()
+#include <mutex>
 #include <functional> // std::plus
 #include <cmath> // std::abs(), std::exp()
 #include <cstdlib> // std::size_t
@@ -231,6 +235,14 @@ class icarus::opdet::OpDetWaveformMakerClass {
  * The first stage gain is computed by
  * `icarus::opdet::PMTsimulationAlg::ConfigurationParameters_t::PMTspecs_t::multiplicationStageGain()`.
  *
+ * The sampling of the response function is performed once at construction
+ * time. Algorithms created by the same `PMTsimulationAlgMaker` share the
+ * sampling, which is repeated only if the response function or the sampling
+ * frequency change. If the configuration parameter `PulseTemplateCache` is set
+ * to a directory path, the sampling is looked up there, and stored there if not
+ * present yet, so that jobs with the same response function and sampling
+ * settings can share it (see `icarus::opdet::PhotoelectronPulseTemplateCache`).
+ *
  *
  * Dark noise
  * -----------
@@ -238,8 +250,12 @@ class icarus::opdet::OpDetWaveformMakerClass {
  * Dark noise, i.e. the noise originating by "spontaneous" emission of a
  * photoelectron in the photocathode without any external stimulation, is
  * simulated by randomly extracting the time such emission happens.
- * Each emission causes a photoelectron template waveform to be added at the
- * extracted time.
+ * The number of emissions in the full readout enable period is extracted from
+ * a Poisson distribution, and their times are then uniformly distributed
+ * within that period.
+ * Each emission is added as a photoelectron at the extracted time, together
+ * with the ones from physical photons, and it is therefore subject to the
+ * same gain fluctuations.
  * The rate of dark noise emission is set by configuration with
  * `DarkNoiseRate` parameter.
  *
@@ -281,6 +297,34 @@ class icarus::opdet::OpDetWaveformMakerClass {
  *     of that stage and @f$ k @f$ the parameter set by `dynodeK`.
  *
  *
+ * Sparse simulation
+ * ------------------
+ *
+ * By default, the full waveform of each channel is simulated for the whole
+ * readout enable period (`ReadoutEnablePeriod`), and only afterwards the
+ * readout buffers around the triggers are cut out of it.
+ * Since most of the time of that period is usually not saved, the algorithm
+ * can be instructed (`SparseSimulation` configuration parameter) to simulate
+ * only the ticks that may matter:
+ *
+ * 1. the photoelectron pulses are added, without noise, only where they
+ *    contribute to the waveform, and the ticks where that signal could be
+ *    beyond threshold once the electronics noise is added are identified;
+ *    the electronics noise is assumed to be contained within
+ *    `SparseNoiseBound` times its RMS (`AmpNoise`);
+ * 2. the full waveform (including noise, saturation and digitization limits)
+ *    is simulated in those regions only, and the triggers are found there;
+ * 3. the full waveform is simulated in each of the buffers to be read out,
+ *    reusing the samples already simulated at the previous step.
+ *
+ * Each tick which is saved is simulated exactly once, with the same
+ * distributions as in the full simulation, and the result is statistically
+ * equivalent to it, unless the electronics noise exceeds the configured bound.
+ * If the noise bound is not smaller than the threshold (`ThresholdADC`),
+ * that is, if the noise alone could trigger the readout anywhere, the full
+ * simulation is performed instead.
+ *
+ *
  * Random number generators
  * -------------------------
  *
@@ -431,11 +475,16 @@ class icarus::opdet::PMTsimulationAlg {
     size_t beamGateTriggerNReps; ///< Number of beamgate trigger reps to produce
 
     unsigned int pulseSubsamples = 1U; ///< Number of tick subsamples.
+    
+    /// Directory of the cache of sampled pulse templates (empty: no cache).
+    std::string pulseTemplateCache;
 
     unsigned int ADCbits = 14U; ///< Number of bits of the digitizer.
     ADCcount baseline; //waveform baseline
     ADCcount ampNoise; //amplitude of gaussian noise
     bool useFastElectronicsNoise; ///< Whether to use fast generator for electronics noise.
+    bool sparseSimulation = false; ///< Simulate only the ticks around triggers.
+    double sparseNoiseBound = 6.0; ///< Noise bound in sparse simulation [RMS].
     hertz darkNoiseRate;
     float saturation; //equivalent to the number of p.e. that saturates the electronic signal
     PMTspecs_t PMTspecs; ///< PMT specifications.
@@ -453,6 +502,9 @@ class icarus::opdet::PMTsimulationAlg {
     /// Single photon response function.
     SinglePhotonResponseFunc_t const* pulseFunction;
 
+    /// Sampling of `pulseFunction` to be shared (if null, sampled anew).
+    std::shared_ptr<DiscretePhotoelectronPulse const> sampledPulse;
+
     /// Main random stream engine.
     CLHEP::HepRandomEngine* randomEngine = nullptr;
 
@@ -513,6 +565,17 @@ class icarus::opdet::PMTsimulationAlg {
   template <typename Stream>
   void printConfiguration(Stream&& out, std::string indent = "") const;
 
+  /**
+   * @brief Samples the single photon response of the specified configuration.
+   * @param config the configuration (`pulseFunction` and `clockData` required)
+   * @return the sampled pulse
+   *
+   * The sampling is looked up in (and stored into) the template cache
+   * `config.pulseTemplateCache`, if any.
+   */
+  static std::shared_ptr<DiscretePhotoelectronPulse const> samplePulse
+    (ConfigurationParameters_t const& config);
+
 
 
     private:
@@ -530,6 +593,22 @@ class icarus::opdet::PMTsimulationAlg {
   /// Type of member function to add electronics noise.
   using NoiseAdderFunc_t = void (PMTsimulationAlg::*)(Waveform_t&) const;
 
+  /// Number of photoelectrons starting at each tick, one map per subsample.
+  using PhotoelectronMaps_t = std::vector<std::unordered_map<tick, unsigned int>>;
+
+  /// A group of photoelectrons all starting at the same tick and subsample.
+  struct PhotoelectronGroup_t {
+    std::size_t startTick; ///< Tick the pulses start at.
+    DiscretePhotoelectronPulse::SubsampleIndex_t subsample; ///< Subsample.
+    WaveformValue_t nEffectivePE; ///< Effective photoelectrons, after gain.
+  }; // PhotoelectronGroup_t
+
+  /// Photoelectron groups sorted by start tick.
+  using PhotoelectronTrain_t = std::vector<PhotoelectronGroup_t>;
+
+  /// Range of ticks of a readout buffer (end excluded).
+  using BufferRange_t = OpDetWaveformMaker_t::BufferRange_t;
+
 
   // --- BEGIN -- Helper functors ----------------------------------------------
   /// Functor to convert tick point into a tick number and a subsample index.
@@ -581,10 +660,18 @@ class icarus::opdet::PMTsimulationAlg {
   megahertz fSampling;   ///< Wave sampling frequency [MHz].
   std::size_t fNsamples; ///< Samples per waveform.
   
-  DiscretePhotoelectronPulse wsp; /// Single photon pulse (sampled).
+  /// Sampled single photon pulse (possibly shared with other instances).
+  std::shared_ptr<DiscretePhotoelectronPulse const> const fSampledPulse;
+  
+  DiscretePhotoelectronPulse const& wsp; /// Single photon pulse (sampled).
 
   NoiseAdderFunc_t const fNoiseAdder; ///< Selected electronics noise method.
 
+  bool const fSparseSimulation; ///< Whether sparse simulation is performed.
+
+  /// Algorithm finding where waveforms cross the readout threshold.
+  ThresholdCrossingFinder<ADCcount> const fFindThresholdCrossings;
+
   ///< Transformation uniform to Gaussian for electronics noise.
   static util::FastAndPoorGauss<32768U, float> const fFastGauss;
 
@@ -612,6 +699,80 @@ class icarus::opdet::PMTsimulationAlg {
     std::optional<sim::SimPhotons>& photons_used
     ) const;
   
+  /**
+   * @brief Collects the photoelectrons from photons and dark noise.
+   * @param photons the simulated list of photoelectrons
+   * @param lite_photons the simulated photoelectrons, in "lite" format
+   * @param photons_used (_output_) list of used photoelectrons
+   * @return number of photoelectrons starting at each subsample of each tick
+   * 
+   * Quantum efficiency and dark noise are applied here.
+   * The `photons_used` output argument is filled as in `CreateFullWaveform()`.
+   */
+  PhotoelectronMaps_t CollectPhotoelectrons(
+    sim::SimPhotons const& photons,
+    sim::SimPhotonsLite const& lite_photons,
+    std::optional<sim::SimPhotons>& photons_used
+    ) const;
+  
+  /**
+   * @brief Returns the photoelectron groups from `peMaps`, sorted by tick.
+   * 
+   * Gain fluctuations are applied here, in the same order as
+   * `CreateFullWaveform()` does.
+   */
+  PhotoelectronTrain_t MakePhotoelectronTrain
+    (PhotoelectronMaps_t const& peMaps) const;
+  
+  /**
+   * @brief Returns the noiseless signal of a range of ticks.
+   * @param begin first photoelectron group to include
+   * @param end past the last photoelectron group to include
+   * @param startTick first tick of the range
+   * @param endTick tick past the last one of the range
+   * @return the baseline plus all the pulses of the groups, in the range
+   * 
+   * The groups are expected to be sorted by start tick. Pulses starting before
+   * `startTick` contribute only with their part within the range.
+   */
+  Waveform_t CreateSignalSegment(
+    PhotoelectronTrain_t::const_iterator begin,
+    PhotoelectronTrain_t::const_iterator end,
+    std::size_t startTick, std::size_t endTick
+    ) const;
+  
+  /// Returns the noiseless signal in the specified range of ticks.
+  Waveform_t CreateSignalSegment(
+    PhotoelectronTrain_t const& train,
+    std::size_t startTick, std::size_t endTick
+    ) const;
+  
+  /// Adds electronics noise, saturation and digitization range to `waveform`.
+  void ApplyElectronics(Waveform_t& waveform) const;
+  
+  /**
+   * @brief Creates `raw::OpDetWaveform` simulating only the needed ticks.
+   * @param photons the simulated list of photoelectrons
+   * @param lite_photons the simulated photoelectrons, in "lite" format
+   * @param photons_used (_output_) list of used photoelectrons
+   * @return a collection of digitised `raw::OpDetWaveform` objects
+   * @see `CreateFixedSizeOpDetWaveforms()`
+   * 
+   * This is the sparse simulation equivalent of
+   * `CreateFixedSizeOpDetWaveforms(CreateFullWaveform())`: the waveform is
+   * simulated only in the regions where triggers may happen, and where data
+   * is read out. See the "Sparse simulation" section of the class
+   * documentation for details.
+   */
+  std::vector<raw::OpDetWaveform> CreateSparseOpDetWaveforms(
+    sim::SimPhotons const& photons,
+    sim::SimPhotonsLite const& lite_photons,
+    std::optional<sim::SimPhotons>& photons_used
+    ) const;
+  
+  /// Returns whether the configured noise can't trigger the readout alone.
+  bool canSimulateSparse() const;
+  
   /**
    * @brief Creates `raw::OpDetWaveform` objects from a waveform data.
    * @param opChannel number of optical detector channel the data belongs to
@@ -669,6 +830,17 @@ class icarus::opdet::PMTsimulationAlg {
   std::vector<raw::OpDetWaveform> CreateFixedSizeOpDetWaveforms
     (raw::Channel_t opChannel, Waveform_t const& waveform) const;
   
+  /**
+   * @brief Returns the readout buffers for the specified triggers.
+   * @param triggers the sorted list of triggers (interest points)
+   * @return a list of sorted, non-overlapping buffer ranges
+   * @see `CreateFixedSizeOpDetWaveforms()`
+   * 
+   * Buffers may extend beyond the end of the waveform.
+   */
+  std::vector<BufferRange_t> MakeReadoutBuffers
+    (std::vector<optical_tick> const& triggers) const;
+  
   
   /**
    * @brief Adds a pulse to a waveform, starting at a given tick.
@@ -715,8 +887,19 @@ class icarus::opdet::PMTsimulationAlg {
   void AddNoise(Waveform_t& wave) const; //add noise to baseline
   /// Same as `AddNoise()` but using an alternative generator.
   void AddNoise_faster(Waveform_t& wave) const;
-  // Add "dark" noise to baseline.
-  void AddDarkNoise(Waveform_t& wave) const;
+  
+  /**
+   * @brief Adds "dark" noise photoelectrons to the photoelectron maps.
+   * @param peMaps photoelectron counts per subsample and tick to be updated
+   * @param nSamples number of ticks in the waveform being simulated
+   * 
+   * The number of dark noise photoelectrons in the `nSamples` ticks is
+   * extracted from a Poisson distribution, and their times are uniformly
+   * distributed in that interval.
+   * Each photoelectron is counted in `peMaps` exactly as a photoelectron from
+   * a scintillation photon would be.
+   */
+  void AddDarkNoise(PhotoelectronMaps_t& peMaps, std::size_t nSamples) const;
   
   /**
    * @brief Ticks in the specified waveform where some signal activity starts.
@@ -743,6 +926,20 @@ class icarus::opdet::PMTsimulationAlg {
    */
   std::vector<optical_tick> FindTriggers(Waveform_t const& wvfm) const;
   
+  /**
+   * @brief Returns the ticks where `wvfm` crosses the threshold upward.
+   * @param wvfm the waveform
+   * @param startTick the tick of the first sample of `wvfm`
+   * @return the sorted ticks where `wvfm` passes the threshold
+   * 
+   * The sample preceding `wvfm` is assumed to be under threshold.
+   */
+  std::vector<optical_tick> FindThresholdCrossings
+    (Waveform_t const& wvfm, std::size_t startTick = 0) const;
+  
+  /// Adds the beam gate triggers (if configured) to the sorted `triggers`.
+  void MergeBeamGateTriggers(std::vector<optical_tick>& triggers) const;
+  
   
   /**
    * @brief Generate periodic interest points regardless the actual activity.
@@ -891,6 +1088,12 @@ class icarus::opdet::PMTsimulationAlgMaker {
         ("split each tick by this many subsamples to increase PMT timing simulation"),
       1U
       };
+    fhicl::Atom<std::string> PulseTemplateCache {
+      Name("PulseTemplateCache"),
+      Comment
+        ("directory to load/save sampled photoelectron pulses from (empty: none)"),
+      ""
+      };
 
     //
     // dark noise
@@ -916,6 +1119,22 @@ class icarus::opdet::PMTsimulationAlgMaker {
       true
       };
 
+    //
+    // sparse simulation
+    //
+    fhicl::Atom<bool> SparseSimulation {
+      Name("SparseSimulation"),
+      Comment
+        ("simulate only the parts of the waveform which may trigger or be saved"),
+      false
+      };
+    fhicl::Atom<double> SparseNoiseBound {
+      Name("SparseNoiseBound"),
+      Comment
+        ("largest electronics noise fluctuation assumed by sparse simulation [RMS]"),
+      6.0
+      };
+
     //
     // trigger
     //
@@ -1006,6 +1225,19 @@ class icarus::opdet::PMTsimulationAlgMaker {
   /// Part of the configuration learned from configuration files.
   PMTsimulationAlg::ConfigurationParameters_t fBaseConfig;
 
+  /// Sampled pulse shared by all the algorithms created by this object.
+  mutable std::shared_ptr<DiscretePhotoelectronPulse const> fSampledPulse;
+
+  /// Sampling frequency of `fSampledPulse`.
+  mutable util::quantities::megahertz fSampledPulseFreq;
+
+  /// Protects `fSampledPulse` and `fSampledPulseFreq`.
+  mutable std::mutex fSampledPulseMutex;
+
+  /// Returns the sampling of the pulse in `params`, reusing the last one.
+  std::shared_ptr<DiscretePhotoelectronPulse const> sampledPulse
+    (PMTsimulationAlg::ConfigurationParameters_t const& params) const;
+
 }; // class PMTsimulationAlgMaker
 
 
@@ -1098,6 +1330,12 @@ void icarus::opdet::PMTsimulationAlg::printConfiguration
   }
   else out << '\n' << indent << "Do not create beam gate triggers.";
 
+  out << '\n' << indent << "Sparse simulation:   ";
+  if (fSparseSimulation) {
+    out << "yes (noise within " << fParams.sparseNoiseBound << " RMS)";
+  }
+  else out << "no";
+
   out << '\n' << indent << "... and more.";
 
   out << '\n' << indent << "Template photoelectron waveform settings:"
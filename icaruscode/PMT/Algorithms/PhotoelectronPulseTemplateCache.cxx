@@ -0,0 +1,213 @@
+/**
+ * @file   icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.cxx
+ * @brief  On-disk cache of sampled photoelectron pulse templates.
+ * @date   October 18, 2026
+ * @see    `icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.h`
+ *
+ */
+
+// library header
+#include "icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.h"
+
+// framework libraries
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// C++ standard library
+#include <filesystem>
+#include <algorithm> // std::equal()
+#include <fstream>
+#include <sstream>
+#include <iomanip> // std::setw(), std::setfill()
+#include <system_error>
+#include <utility> // std::move()
+#include <cassert>
+#include <cstdlib> // ::mkstemp()
+#include <unistd.h> // ::close()
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Tag at the beginning of each template file (includes format version).
+  constexpr char const FileTag[] = "ICARUSPETemplate_v1";
+
+  /// Sanity limits for the content of a template file.
+  constexpr std::uint64_t MaxKeyLength = 1ULL << 20;
+  constexpr std::uint64_t MaxSamples = 1ULL << 28;
+
+  template <typename T>
+  void writeBinary(std::ostream& out, T const& value)
+    { out.write(reinterpret_cast<char const*>(&value), sizeof(T)); }
+
+  template <typename T>
+  bool readBinary(std::istream& in, T& value)
+    { return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// ---  icarus::opdet::PhotoelectronPulseTemplateCache
+// -----------------------------------------------------------------------------
+icarus::opdet::PhotoelectronPulseTemplateCache::PhotoelectronPulseTemplateCache
+  (std::string directory /* = "" */)
+  : fDirectory(std::move(directory))
+  {}
+
+
+// -----------------------------------------------------------------------------
+auto icarus::opdet::PhotoelectronPulseTemplateCache::load
+  (std::string const& key) const -> std::optional<Template_t>
+{
+  if (!enabled()) return std::nullopt;
+
+  std::string const path = pathFor(key);
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    MF_LOG_DEBUG("PhotoelectronPulseTemplateCache")
+      << "No cached pulse template in '" << path << "'.";
+    return std::nullopt;
+  }
+
+  auto failure = [&path](char const* msg) -> std::optional<Template_t>
+    {
+      mf::LogWarning("PhotoelectronPulseTemplateCache")
+        << "Cached pulse template '" << path << "' ignored: " << msg;
+      return std::nullopt;
+    };
+
+  char tag[sizeof(FileTag)];
+  if (!in.read(tag, sizeof(tag)) || !std::equal(tag, tag + sizeof(tag), FileTag))
+    return failure("unsupported format.");
+
+  std::uint64_t keyLength;
+  if (!readBinary(in, keyLength)) return failure("truncated header.");
+  if (keyLength > MaxKeyLength) return failure("corrupted header.");
+  std::string storedKey(keyLength, '\0');
+  if (!in.read(storedKey.data(), keyLength)) return failure("truncated key.");
+  if (storedKey != key) {
+    // a hash collision; not an error, just not what we are looking for
+    MF_LOG_DEBUG("PhotoelectronPulseTemplateCache")
+      << "Cached pulse template in '" << path << "' has a different key.";
+    return std::nullopt;
+  }
+
+  std::uint64_t nSubsamples, length;
+  if (!readBinary(in, nSubsamples) || !readBinary(in, length))
+    return failure("truncated header.");
+  if ((nSubsamples == 0) || (length > MaxSamples / nSubsamples))
+    return failure("corrupted header.");
+
+  Template_t data;
+  data.nSubsamples = nSubsamples;
+  data.length = length;
+  data.samples.resize(nSubsamples * length);
+  if (!in.read(
+    reinterpret_cast<char*>(data.samples.data()),
+    data.samples.size() * sizeof(float)
+    )
+  ) {
+    return failure("truncated data.");
+  }
+
+  MF_LOG_DEBUG("PhotoelectronPulseTemplateCache")
+    << "Pulse template (" << data.nSubsamples << " x " << data.length
+    << " samples) loaded from '" << path << "'.";
+  return data;
+} // icarus::opdet::PhotoelectronPulseTemplateCache::load()
+
+
+// -----------------------------------------------------------------------------
+bool icarus::opdet::PhotoelectronPulseTemplateCache::store
+  (std::string const& key, Template_t const& data) const
+{
+  if (!enabled()) return false;
+
+  assert(data.samples.size() == data.nSubsamples * data.length);
+
+  std::string const path = pathFor(key);
+
+  std::error_code ec;
+  std::filesystem::create_directories(fDirectory, ec);
+  if (ec) {
+    mf::LogWarning("PhotoelectronPulseTemplateCache")
+      << "Can't create pulse template cache directory '" << fDirectory
+      << "': " << ec.message();
+    return false;
+  }
+
+  // write in a temporary file first, then move it into place;
+  // the name is unique also among threads and jobs sharing the directory
+  std::string tempPath = path + ".tmpXXXXXX";
+  int const fd = ::mkstemp(tempPath.data());
+  if (fd < 0) {
+    mf::LogWarning("PhotoelectronPulseTemplateCache")
+      << "Can't create a temporary pulse template cache file for '" << path
+      << "'.";
+    return false;
+  }
+  ::close(fd);
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+
+    out.write(FileTag, sizeof(FileTag));
+    writeBinary(out, static_cast<std::uint64_t>(key.size()));
+    out.write(key.data(), key.size());
+    writeBinary(out, static_cast<std::uint64_t>(data.nSubsamples));
+    writeBinary(out, static_cast<std::uint64_t>(data.length));
+    out.write(
+      reinterpret_cast<char const*>(data.samples.data()),
+      data.samples.size() * sizeof(float)
+      );
+
+    if (!out) {
+      mf::LogWarning("PhotoelectronPulseTemplateCache")
+        << "Failed to write pulse template cache file '" << tempPath << "'.";
+      out.close();
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    mf::LogWarning("PhotoelectronPulseTemplateCache")
+      << "Failed to store pulse template cache file '" << path << "': "
+      << ec.message();
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  MF_LOG_DEBUG("PhotoelectronPulseTemplateCache")
+    << "Pulse template (" << data.nSubsamples << " x " << data.length
+    << " samples) stored into '" << path << "'.";
+  return true;
+} // icarus::opdet::PhotoelectronPulseTemplateCache::store()
+
+
+// -----------------------------------------------------------------------------
+std::string icarus::opdet::PhotoelectronPulseTemplateCache::pathFor
+  (std::string const& key) const
+{
+  std::ostringstream sstr;
+  sstr << "PEpulse_" << std::hex << std::setfill('0') << std::setw(16)
+    << hashKey(key) << ".bin";
+  return (std::filesystem::path{ fDirectory } / sstr.str()).string();
+} // icarus::opdet::PhotoelectronPulseTemplateCache::pathFor()
+
+
+// -----------------------------------------------------------------------------
+std::uint64_t icarus::opdet::PhotoelectronPulseTemplateCache::hashKey
+  (std::string const& key)
+{
+  // 64-bit FNV-1a: unlike `std::hash`, it is stable across jobs and platforms
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char const c: key) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+} // icarus::opdet::PhotoelectronPulseTemplateCache::hashKey()
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+/**
+ * @file   icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.h
+ * @brief  On-disk cache of sampled photoelectron pulse templates.
+ * @date   October 18, 2026
+ * @see    `icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.cxx`
+ *
+ */
+
+#ifndef ICARUSCODE_PMT_ALGORITHMS_PHOTOELECTRONPULSETEMPLATECACHE_H
+#define ICARUSCODE_PMT_ALGORITHMS_PHOTOELECTRONPULSETEMPLATECACHE_H
+
+
+// C++ standard library
+#include <vector>
+#include <string>
+#include <optional>
+#include <cstdint> // std::uint64_t
+#include <cstdlib> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::opdet { class PhotoelectronPulseTemplateCache; }
+/**
+ * @brief Persistent storage of sampled photoelectron pulse templates.
+ *
+ * Each template is stored in its own file in the cache directory, and it is
+ * identified by a key string which should describe completely the sampled
+ * function and the sampling parameters
+ * (see `icarus::opdet::DiscretePhotoelectronPulse`).
+ * The file name is derived from a hash of the key, and the full key is also
+ * stored in the file and checked on load, so that hash collisions result in
+ * cache misses rather than in wrong templates.
+ *
+ * Files are written to a temporary name and then renamed, so that concurrent
+ * jobs sharing the same cache directory never read a partially written file.
+ * The file format is binary and not portable across architectures with
+ * different endianness or floating point representation.
+ *
+ * Any failure in reading or writing the cache is not fatal: the template is
+ * considered not cached, and the caller is expected to sample it anew.
+ *
+ * A cache with an empty directory path is disabled: it never finds any
+ * template and never stores any.
+ */
+class icarus::opdet::PhotoelectronPulseTemplateCache {
+    public:
+
+  /// Sampled template data.
+  struct Template_t {
+    std::size_t nSubsamples = 0U; ///< Number of subsamples.
+    std::size_t length = 0U; ///< Number of samples in each subsample.
+    /// All samples, subsample by subsample (`nSubsamples x length`).
+    std::vector<float> samples;
+  }; // Template_t
+
+
+  /// Constructor: cache in the specified `directory` (empty disables it).
+  PhotoelectronPulseTemplateCache(std::string directory = "");
+
+  /// Returns whether the cache is enabled.
+  bool enabled() const { return !fDirectory.empty(); }
+
+  /// Returns the directory of the cache.
+  std::string const& directory() const { return fDirectory; }
+
+  /// Returns the template with the specified `key`, if cached.
+  std::optional<Template_t> load(std::string const& key) const;
+
+  /// Stores the template `data` under the specified `key`; returns success.
+  bool store(std::string const& key, Template_t const& data) const;
+
+  /// Returns the path of the file of the template with the specified `key`.
+  std::string pathFor(std::string const& key) const;
+
+
+    private:
+
+  std::string fDirectory; ///< Path of the cache directory.
+
+  /// Returns a (stable) hash of the specified string.
+  static std::uint64_t hashKey(std::string const& key);
+
+}; // icarus::opdet::PhotoelectronPulseTemplateCache
+
+
+// -----------------------------------------------------------------------------
+
+
+#endif // ICARUSCODE_PMT_ALGORITHMS_PHOTOELECTRONPULSETEMPLATECACHE_H
@@ -18,7 +18,7 @@
 
 // C/C++ standard libraries
 #include <vector>
-#include <algorithm> // std::nth_element(), std::copy()
+#include <algorithm> // std::nth_element()
 #include <iterator> // std::distance(), std::next()
 #include <ostream>
 #include <cmath> // std::round()
@@ -120,13 +120,22 @@ auto opdet::SharedWaveformBaseline::operator()
   (std::vector<raw::OpDetWaveform const*> const& waveforms) const
   -> BaselineInfo_t
 {
+  thread_local ADCcountHistogram workspace;
+  return (*this)(waveforms, workspace);
+} // opdet::SharedWaveformBaseline::operator()
+
+
+//------------------------------------------------------------------------------
+auto opdet::SharedWaveformBaseline::operator() (
+  std::vector<raw::OpDetWaveform const*> const& waveforms,
+  ADCcountHistogram& workspace
+) const -> BaselineInfo_t {
   if (waveforms.empty()) return {};
   
   //
   // first pass: find statistics
   //
-  std::vector<raw::ADC_Count_t> samples;
-  samples.reserve(fParams.nSample * waveforms.size());
+  assert(workspace.empty());
   std::vector<double> RMSs;
   RMSs.reserve(waveforms.size());
   
@@ -148,11 +157,14 @@ auto opdet::SharedWaveformBaseline::operator()
     for (auto it = begin; it != end; ++it) stats.add(*it);
     RMSs.push_back(stats.RMS());
     
-    std::copy(waveform->begin(), waveform->end(), back_inserter(samples));
+    workspace.add(waveform->begin(), waveform->end());
   } // for
   
+  if (workspace.empty()) return {}; // all waveforms were too short
+  
   double const medRMS = median(RMSs.cbegin(), RMSs.cend());
-  raw::ADC_Count_t const med = median(samples.cbegin(), samples.cend());
+  raw::ADC_Count_t const med = workspace.median();
+  workspace.clear();
   
   mf::LogTrace{ fLogCategory } << "Stats of channel "
     << waveforms.front()->ChannelNumber() << " from "
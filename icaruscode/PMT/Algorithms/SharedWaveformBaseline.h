@@ -10,6 +10,9 @@
 #define ICARUSCODE_PMT_ALGORITHMS_SHAREDWAVEFORMBASELINE_H
 
 
+// ICARUS libraries
+#include "icaruscode/PMT/Algorithms/ADCcountHistogram.h"
+
 // LArSoft libraries
 #include "lardataobj/RawData/OpDetWaveform.h"
 
@@ -48,6 +51,10 @@ namespace opdet { class SharedWaveformBaseline; }
  * The parameters are specified at algorithm construction time and are contained
  * in the `Params_t` object.
  * 
+ * The median of the samples is extracted from a counting histogram
+ * (`opdet::ADCcountHistogram`), which can be provided by the caller to be
+ * reused for many channels; otherwise, one histogram per thread is used.
+ * 
  */
 class opdet::SharedWaveformBaseline {
     public:
@@ -105,6 +112,12 @@ class opdet::SharedWaveformBaseline {
   BaselineInfo_t operator()
     (std::vector<raw::OpDetWaveform const*> const& waveforms) const;
   
+  /// Returns a common baseline, using `workspace` for the sample median.
+  BaselineInfo_t operator() (
+    std::vector<raw::OpDetWaveform const*> const& waveforms,
+    ADCcountHistogram& workspace
+    ) const;
+  
   /// Returns the set of configuration parameters of this algorithm.
   Params_t const& parameters() const { return fParams; }
   
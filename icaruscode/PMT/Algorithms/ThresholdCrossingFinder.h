@@ -0,0 +1,252 @@
+/**
+ * @file   icaruscode/PMT/Algorithms/ThresholdCrossingFinder.h
+ * @brief  Finds where a waveform crosses a set of thresholds.
+ * @date   October 18, 2026
+ *
+ * This is a header only library.
+ */
+
+#ifndef ICARUSCODE_PMT_ALGORITHMS_THRESHOLDCROSSINGFINDER_H
+#define ICARUSCODE_PMT_ALGORITHMS_THRESHOLDCROSSINGFINDER_H
+
+
+// C++ standard library
+#include <vector>
+#include <iterator> // std::data(), std::size()
+#include <algorithm> // std::min()
+#include <utility> // std::move()
+#include <cstdint> // std::uint64_t
+#include <cstdlib> // std::size_t
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::opdet {
+
+  /// Positions where a waveform crosses a threshold.
+  struct ThresholdCrossings_t {
+
+    /// Index of the samples where the waveform reaches the threshold.
+    std::vector<std::size_t> opening;
+
+    /// Index of the samples where the waveform falls back below threshold.
+    std::vector<std::size_t> closing;
+
+  }; // ThresholdCrossings_t
+
+  template <typename Sample> class ThresholdCrossingFinder;
+
+} // namespace icarus::opdet
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Finds the crossings of a waveform with multiple thresholds.
+ * @tparam Sample type of the waveform samples (and of the thresholds)
+ *
+ * This algorithm scans a waveform once, and returns for each of the configured
+ * thresholds the list of the positions where the waveform goes beyond that
+ * threshold ("opening") and where it goes back below it ("closing").
+ *
+ * The level of each threshold is expressed in the same units and scale as the
+ * waveform samples, i.e. including the baseline.
+ * With positive polarity, a sample is beyond threshold if it is equal or larger
+ * than the level (`sample >= level`); with negative polarity, it is beyond
+ * threshold if it is equal or smaller than the level (`sample <= level`).
+ *
+ * Example of usage:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * icarus::opdet::ThresholdCrossingFinder<short int> const findCrossings
+ *   { { 14900, 14800, 14700 }, -1 };
+ *
+ * std::vector<icarus::opdet::ThresholdCrossings_t> const crossings
+ *   = findCrossings(waveform.Waveform());
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * will find where `waveform`, with a negative polarity, crosses the levels
+ * 14900, 14800 and 14700 ADC counts; the crossings of each threshold are in
+ * the element of `crossings` with the same index as the threshold level.
+ *
+ *
+ * Implementation details
+ * -----------------------
+ *
+ * The waveform is processed in blocks of 64 samples. For each block and
+ * threshold, a bit mask of which samples are beyond threshold is built without
+ * branches (a loop that the compiler can vectorize), and the crossings are
+ * then found as the bits which differ from the preceding one.
+ * Only the crossings are looped through individually, so that the cost of the
+ * scan is close to that of reading the waveform once, independently of the
+ * number of crossings, and the waveform block stays in cache while all the
+ * thresholds are tested.
+ */
+template <typename Sample>
+class icarus::opdet::ThresholdCrossingFinder {
+
+    public:
+  using Sample_t = Sample; ///< Type of waveform samples.
+
+  /**
+   * @brief Constructor: sets the threshold `levels` and the `polarity`.
+   * @param levels the threshold levels
+   * @param polarity `+1` if the signal is positive, `-1` if negative
+   */
+  ThresholdCrossingFinder(std::vector<Sample_t> levels, int polarity = +1)
+    : fLevels(std::move(levels)), fPositive(polarity >= 0)
+    {}
+
+  /// Returns the configured threshold levels.
+  std::vector<Sample_t> const& levels() const { return fLevels; }
+
+  /// Returns the number of configured thresholds.
+  std::size_t nThresholds() const { return fLevels.size(); }
+
+  /// Returns whether the signal polarity is positive.
+  bool isPositive() const { return fPositive; }
+
+  /**
+   * @brief Finds the crossings of the `n` samples starting at `samples`.
+   * @param samples pointer to the first sample of the waveform
+   * @param n number of samples in the waveform
+   * @param firstIndex index of the first sample (default: `0`)
+   * @param above (in/out) whether the waveform is beyond each threshold
+   *              before the first sample, updated to the last sample
+   * @return crossing positions for each of the thresholds
+   *
+   * The returned positions are offset by `firstIndex`.
+   * This form allows to scan a waveform in pieces, carrying `above` from one
+   * to the next.
+   */
+  std::vector<ThresholdCrossings_t> operator() (
+    Sample_t const* samples, std::size_t n, std::size_t firstIndex,
+    std::vector<bool>& above
+    ) const;
+
+  /// Finds the crossings of `n` samples, starting below all thresholds.
+  std::vector<ThresholdCrossings_t> operator()
+    (Sample_t const* samples, std::size_t n, std::size_t firstIndex = 0) const
+    {
+      std::vector<bool> above(nThresholds(), false);
+      return (*this)(samples, n, firstIndex, above);
+    }
+
+  /// Finds the crossings of the contiguous `waveform` samples.
+  template <typename Waveform>
+  std::vector<ThresholdCrossings_t> operator()
+    (Waveform const& waveform, std::size_t firstIndex = 0) const
+    { return (*this)(std::data(waveform), std::size(waveform), firstIndex); }
+
+
+    private:
+
+  using Mask_t = std::uint64_t; ///< Type of the bit mask of a block.
+
+  /// Number of samples processed in a block.
+  static constexpr std::size_t BlockSize = 64U;
+
+  std::vector<Sample_t> fLevels; ///< Threshold levels.
+  bool fPositive; ///< Whether the polarity of the signal is positive.
+
+  /// Returns the mask of samples in the block beyond `level`.
+  template <bool Positive>
+  static Mask_t blockMask
+    (Sample_t const* samples, std::size_t n, Sample_t level);
+
+  /// Returns the index of the lowest set bit in `mask` (must not be `0`).
+  static unsigned int lowestBit(Mask_t mask);
+
+}; // icarus::opdet::ThresholdCrossingFinder
+
+
+// -----------------------------------------------------------------------------
+// ---  Template implementation
+// -----------------------------------------------------------------------------
+template <typename Sample>
+auto icarus::opdet::ThresholdCrossingFinder<Sample>::operator() (
+  Sample_t const* samples, std::size_t n, std::size_t firstIndex,
+  std::vector<bool>& above
+) const -> std::vector<ThresholdCrossings_t> {
+
+  std::size_t const nLevels = nThresholds();
+  assert(above.size() == nLevels);
+
+  std::vector<ThresholdCrossings_t> crossings(nLevels);
+
+  // state of the last sample of the previous block, per threshold
+  std::vector<Mask_t> prevBit(nLevels);
+  for (std::size_t iLevel = 0; iLevel < nLevels; ++iLevel)
+    prevBit[iLevel] = above[iLevel]? 1U: 0U;
+
+  for (std::size_t blockStart = 0; blockStart < n; blockStart += BlockSize) {
+
+    std::size_t const blockSize = std::min(BlockSize, n - blockStart);
+    Sample_t const* const block = samples + blockStart;
+    Mask_t const validBits = (blockSize == BlockSize)
+      ? ~Mask_t{ 0 }: ((Mask_t{ 1 } << blockSize) - 1);
+
+    for (std::size_t iLevel = 0; iLevel < nLevels; ++iLevel) {
+
+      Mask_t const mask = fPositive
+        ? blockMask<true>(block, blockSize, fLevels[iLevel])
+        : blockMask<false>(block, blockSize, fLevels[iLevel])
+        ;
+
+      // each bit is compared with the one of the previous sample
+      Mask_t edges = (mask ^ ((mask << 1) | prevBit[iLevel])) & validBits;
+      prevBit[iLevel] = (mask >> (blockSize - 1)) & 1U;
+
+      ThresholdCrossings_t& levelCrossings = crossings[iLevel];
+      while (edges) {
+        unsigned int const bit = lowestBit(edges);
+        std::size_t const index = firstIndex + blockStart + bit;
+        if ((mask >> bit) & 1U) levelCrossings.opening.push_back(index);
+        else                    levelCrossings.closing.push_back(index);
+        edges &= edges - 1; // clear the lowest bit
+      } // while
+
+    } // for levels
+
+  } // for blocks
+
+  for (std::size_t iLevel = 0; iLevel < nLevels; ++iLevel)
+    above[iLevel] = (prevBit[iLevel] != 0U);
+
+  return crossings;
+} // icarus::opdet::ThresholdCrossingFinder<>::operator()
+
+
+// -----------------------------------------------------------------------------
+template <typename Sample>
+template <bool Positive>
+auto icarus::opdet::ThresholdCrossingFinder<Sample>::blockMask
+  (Sample_t const* samples, std::size_t n, Sample_t level) -> Mask_t
+{
+  Mask_t mask = 0U;
+  for (std::size_t i = 0; i < n; ++i) {
+    bool const beyond
+      = Positive? !(samples[i] < level): !(level < samples[i]);
+    mask |= Mask_t{ beyond } << i;
+  }
+  return mask;
+} // icarus::opdet::ThresholdCrossingFinder<>::blockMask()
+
+
+// -----------------------------------------------------------------------------
+template <typename Sample>
+unsigned int icarus::opdet::ThresholdCrossingFinder<Sample>::lowestBit
+  (Mask_t mask)
+{
+  assert(mask != 0U);
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned int>(__builtin_ctzll(mask));
+#else
+  unsigned int bit = 0U;
+  while (!((mask >> bit) & 1U)) ++bit;
+  return bit;
+#endif
+} // icarus::opdet::ThresholdCrossingFinder<>::lowestBit()
+
+
+// -----------------------------------------------------------------------------
+
+
+#endif // ICARUSCODE_PMT_ALGORITHMS_THRESHOLDCROSSINGFINDER_H
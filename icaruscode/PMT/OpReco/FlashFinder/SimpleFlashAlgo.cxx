@@ -3,6 +3,7 @@
 
 #include "SimpleFlashAlgo.h"
 #include <set>
+#include <algorithm>
 namespace pmtana{
     
     static SimpleFlashAlgoFactory __SimpleFlashAlgoFactoryStaticObject__;
@@ -108,14 +109,16 @@ namespace pmtana{
     
     LiteOpFlashArray_t SimpleFlashAlgo::RecoFlash(const LiteOpHitArray_t ophits) {
         
+        // The hits are binned in time with _time_res resolution, but only the
+        // bins with accepted hits are stored (sorted by time): memory and time
+        // scale with the number of hits rather than with the time span.
+        // The sums are accumulated in the same order as with a dense array
+        // of bins, so the result is exactly the same.
+        
         Reset();
         size_t max_ch = _opch_to_index_v.size() - 1;
         size_t NOpDet = _index_to_opch_v.size();
         
-        //static std::vector<double> pesum_v;
-        static std::vector<double> mult_v;  //< this is not strictly a multiplicity of PMTs, but multiplicity of hits
-        static std::vector<std::vector<double> > pespec_v;
-        static std::vector<std::vector<unsigned int> > hitidx_v;
         double min_time=1.1e20;
         double max_time=1.1e20;
         for(auto const& oph : ophits) {
@@ -128,18 +131,9 @@ namespace pmtana{
             std::cout << "T span: " << min_time << " => " << max_time << " ... " << (size_t)((max_time - min_time) / _time_res) << std::endl;
         
         size_t nbins_pesum_v = (size_t)((max_time - min_time) / _time_res) + 1;
-        if(_pesum_v.size() < nbins_pesum_v) _pesum_v.resize(nbins_pesum_v,0);
-        if(mult_v.size()   < nbins_pesum_v) mult_v.resize(nbins_pesum_v,0);
-        if(pespec_v.size() < nbins_pesum_v) pespec_v.resize(nbins_pesum_v,std::vector<double>(NOpDet));
-        if(hitidx_v.size() < nbins_pesum_v) hitidx_v.resize(nbins_pesum_v,std::vector<unsigned int>());
-        for(size_t i=0; i<_pesum_v.size(); ++i) {
-            _pesum_v[i] = 0;
-            mult_v[i]  = 0;
-            hitidx_v[i].clear();
-            for(auto& v : pespec_v[i]) v=0;
-        }
         
-        // Fill _pesum_v
+        // Select the hits, sorted by time bin (and in input order within a bin)
+        _hit_v.clear();
         for(size_t hitidx = 0; hitidx < ophits.size(); ++hitidx) {
             auto const& oph = ophits[hitidx];
             if(oph.channel > max_ch || _opch_to_index_v[oph.channel] < 0) {
@@ -153,78 +147,85 @@ namespace pmtana{
 	    if(oph.pe <= 0.) continue;
 	    if(_min_pe_hit > 0. && oph.pe < _min_pe_hit) continue;
             size_t index = (size_t)((oph.peak_time - min_time) / _time_res);
-            _pesum_v[index] += oph.pe;
-            mult_v[index] += 1;
-            pespec_v[index][_opch_to_index_v[oph.channel]] += oph.pe;
-            hitidx_v[index].push_back(hitidx);
+            _hit_v.push_back({ index, (size_t)_opch_to_index_v[oph.channel], (unsigned int)hitidx, oph.pe });
+        }
+        std::stable_sort(_hit_v.begin(), _hit_v.end(),
+                         [](BinnedHit_t const& a, BinnedHit_t const& b){ return a.bin < b.bin; });
+        
+        // Fill the (non-empty) bins of the PE sum
+        _bin_v.clear();
+        for(size_t ihit = 0; ihit < _hit_v.size(); ++ihit) {
+            auto const& hit = _hit_v[ihit];
+            if(_bin_v.empty() || _bin_v.back().index != hit.bin)
+                _bin_v.push_back({ hit.bin, 0., 0., ihit, ihit });
+            auto& bin = _bin_v.back();
+            bin.pesum += hit.pe;
+            bin.mult += 1;
+            bin.hit_end = ihit + 1;
         }
         
-        // Order by pe (above threshold)
-        std::map<double,size_t> pesum_idx_map;
-        for(size_t idx=0; idx<nbins_pesum_v; ++idx) {
-            if(_pesum_v[idx] < _min_pe_coinc   ) continue;
-            if(mult_v[idx]  < _min_mult_coinc ) continue;
-            pesum_idx_map[1./(_pesum_v[idx])] = idx;
+        // Order by pe (above threshold); of bins with the same PE sum, only the
+        // latest one is a candidate
+        std::vector<std::pair<double,size_t> > candidate_v; // ( 1/PE, bin )
+        for(size_t ibin=0; ibin<_bin_v.size(); ++ibin) {
+            auto const& bin = _bin_v[ibin];
+            if(bin.pesum < _min_pe_coinc   ) continue;
+            if(bin.mult  < _min_mult_coinc ) continue;
+            candidate_v.emplace_back(1./(bin.pesum), ibin);
         }
+        std::sort(candidate_v.begin(), candidate_v.end(),
+                  [](auto const& a, auto const& b)
+                  { return (a.first != b.first)? (a.first < b.first): (a.second > b.second); });
         
         // Get candidate flash times
         std::vector<std::pair<size_t,size_t> > flash_period_v;
         std::vector<size_t> flash_time_v;
+        std::set<size_t> used_start_s; // start of the claimed flashes
         size_t veto_ctr = (size_t)(_veto_time / _time_res);
         size_t default_integral_ctr = (size_t)(_integral_time / _time_res);
         size_t precount = (size_t)(_pre_sample / _time_res);
-        flash_period_v.reserve(pesum_idx_map.size());
-        flash_time_v.reserve(pesum_idx_map.size());
+        flash_period_v.reserve(candidate_v.size());
+        flash_time_v.reserve(candidate_v.size());
         
         double sum_baseline = 0;
         //for(auto const& v : _pe_baseline_v) sum_baseline += v;
         
-        for(auto const& pe_idx : pesum_idx_map) {
+        for(size_t icand=0; icand<candidate_v.size(); ++icand) {
+            
+            if(icand > 0 && candidate_v[icand].first == candidate_v[icand-1].first) continue;
             
-            //auto const& pe  = 1./(pe_idx.first);
-            auto const& idx = pe_idx.second;
+            auto const& idx = _bin_v[candidate_v[icand].second].index;
             
             size_t start_time = idx;
             if(start_time < precount) start_time = 0;
             else start_time = idx - precount;
             
-            // see if this idx can be used
-            bool skip=false;
-            size_t integral_ctr = default_integral_ctr;
-            for(auto const& used_period : flash_period_v) {
-                if( start_time <= used_period.first && (start_time + veto_ctr) > used_period.first ) {
-                    skip=true;
-                    break;
-                }
-                if( used_period.first <= start_time && start_time < (used_period.first + veto_ctr) ) {
-                    skip=true;
-                    break;
-                }
-                if( used_period.first >= start_time && used_period.first < (start_time + integral_ctr) ) {
-                    if(_debug) std::cout << "Truncating flash @ " << start_time
-                        << " (previous flash @ " << used_period.first
-                        << ") ... integral ctr change: " << integral_ctr
-                        << " => " << used_period.first - start_time << std::endl;
-                    
-                    integral_ctr = used_period.first - start_time;
-                }
-                if(_debug) {
-                    std::cout << "Flash @ " << min_time + used_period.first * _time_res
-                    << " => " << min_time + (used_period.first + used_period.second) * _time_res
-                    << " does not interfare with THIS flash @ " << min_time + start_time * _time_res
-                    << " => " << min_time + (start_time + integral_ctr) * _time_res << std::endl;
-                }
-            }
-            if(skip) {
+            // see if this idx can be used: no flash may start closer than
+            // the veto time, before or after
+            size_t const veto_low = (start_time >= veto_ctr)? (start_time - veto_ctr + 1): 0;
+            auto const iUsed = used_start_s.lower_bound(veto_low);
+            if(iUsed != used_start_s.end() && *iUsed < start_time + veto_ctr) {
                 if(_debug) std::cout << "Skipping a candidate @ " << min_time + start_time * _time_res << " as it is in a veto window!" <<std::endl;
                 continue;
             }
             
+            // the integration stops at the start of the next flash
+            size_t integral_ctr = default_integral_ctr;
+            auto const iNext = used_start_s.lower_bound(start_time);
+            if(iNext != used_start_s.end() && *iNext < start_time + integral_ctr) {
+                if(_debug) std::cout << "Truncating flash @ " << start_time
+                    << " (previous flash @ " << *iNext
+                    << ") ... integral ctr change: " << integral_ctr
+                    << " => " << *iNext - start_time << std::endl;
+                integral_ctr = *iNext - start_time;
+            }
+            
             // See if this flash is declarable
             double pesum = 0;
-            for(size_t i=start_time; i<std::min(nbins_pesum_v,(start_time+integral_ctr)); ++i)
+            size_t const end_time = std::min(nbins_pesum_v,(start_time+integral_ctr));
+            for(auto ibin = FirstBinFrom(start_time); ibin < _bin_v.size() && _bin_v[ibin].index < end_time; ++ibin)
                 
-                pesum += _pesum_v[i];
+                pesum += _bin_v[ibin].pesum;
             
             if(pesum < (_min_pe_flash + sum_baseline)) {
                 if(_debug) std::cout << "Skipping a candidate @ " << start_time  << " => " << start_time + integral_ctr
@@ -235,10 +236,13 @@ namespace pmtana{
             
             flash_period_v.push_back(std::pair<size_t,size_t>(start_time,integral_ctr));
             flash_time_v.push_back(idx);
+            used_start_s.insert(start_time);
         }
         
         // Construct flash
         LiteOpFlashArray_t res;
+        std::vector<double> binpe_v(NOpDet,0); // PE of each PMT in one bin
+        std::vector<size_t> touched_v; // PMT with PE in the bin
         for(size_t flash_idx=0; flash_idx<flash_period_v.size(); ++flash_idx) {
             
             auto const& start  = flash_period_v[flash_idx].first;
@@ -246,11 +250,23 @@ namespace pmtana{
             auto const& time   = flash_time_v[flash_idx];
             
             std::vector<double> pe_v(max_ch+1,0);
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
+            std::vector<unsigned int> asshit_v;
+            for(auto ibin = FirstBinFrom(start); ibin < _bin_v.size() && _bin_v[ibin].index < (start+period); ++ibin) {
                 
-                for(size_t pmt_index=0; pmt_index<NOpDet; ++pmt_index)
-                    
-                    pe_v[_index_to_opch_v[pmt_index]] += pespec_v[index][pmt_index];
+                auto const& bin = _bin_v[ibin];
+                
+                // first sum the PE in the bin, then add them to the flash
+                for(size_t ihit = bin.hit_begin; ihit < bin.hit_end; ++ihit) {
+                    auto const& hit = _hit_v[ihit];
+                    if(binpe_v[hit.pmt_index] == 0) touched_v.push_back(hit.pmt_index);
+                    binpe_v[hit.pmt_index] += hit.pe;
+                    asshit_v.push_back(hit.hitidx);
+                }
+                for(auto const& pmt_index : touched_v) {
+                    pe_v[_index_to_opch_v[pmt_index]] += binpe_v[pmt_index];
+                    binpe_v[pmt_index] = 0;
+                }
+                touched_v.clear();
                 
             }
             
@@ -264,12 +280,6 @@ namespace pmtana{
                 
             }
             
-            std::vector<unsigned int> asshit_v;
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
-                for(auto const& idx : hitidx_v[index])
-                    asshit_v.push_back(idx);
-            }
-            
             if(_debug) {
                 std::cout << "Claiming a flash @ " << min_time + time * _time_res
                 << " : " << std::flush;
@@ -289,6 +299,13 @@ namespace pmtana{
         return res;
     }
     
+    size_t SimpleFlashAlgo::FirstBinFrom(size_t index) const
+    {
+        auto const iBin = std::lower_bound(_bin_v.begin(), _bin_v.end(), index,
+                                           [](PESumBin_t const& bin, size_t index){ return bin.index < index; });
+        return iBin - _bin_v.begin();
+    }
+    
 }
 #endif
 
@@ -21,14 +21,32 @@ namespace pmtana
 
     bool Veto(double t) const;
 
-    const std::vector<double>& PESumArray() const { return _pesum_v; }
-
     const double TimeRes() const { return _time_res; }
 
   private:
 
     double TotalCharge(const std::vector<double>& PEs);
 
+    /// A selected hit, with its time bin and PMT index.
+    struct BinnedHit_t {
+      size_t bin;
+      size_t pmt_index;
+      unsigned int hitidx;
+      double pe;
+    };
+
+    /// A time bin with hits: its PE sum, multiplicity and hits in _hit_v.
+    struct PESumBin_t {
+      size_t index;
+      double pesum;
+      double mult;
+      size_t hit_begin;
+      size_t hit_end;
+    };
+
+    /// Index in _bin_v of the first bin at or after time bin `index`.
+    size_t FirstBinFrom(size_t index) const;
+
     // minimum PE to account for a hit
     double _min_pe_hit;
 
@@ -53,8 +71,11 @@ namespace pmtana
     // time pre-sample
     double _pre_sample;
 
-    // pw aum array
-    std::vector<double> _pesum_v;
+    // selected hits, sorted by time bin
+    std::vector<BinnedHit_t> _hit_v;
+
+    // pe sum of the time bins with hits, sorted by time
+    std::vector<PESumBin_t> _bin_v;
 
     // calibration: PEs to be subtracted from each opdet
     std::vector<double> _pe_baseline_v;
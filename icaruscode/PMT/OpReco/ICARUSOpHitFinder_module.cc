@@ -49,13 +49,18 @@
 #include "fhiclcpp/types/DelegatedParameter.h"
 #include "fhiclcpp/ParameterSet.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+
 // C++ standard libraries
-#include <algorithm> // std::copy_if(), std::binary_search()
+#include <algorithm> // std::binary_search()
 #include <vector>
-#include <variant>
 #include <memory> // std::unique_ptr
 #include <string>
 #include <functional> // std::mem_fn()
+#include <iterator> // std::move_iterator
 #include <utility> // std::move()
 #include <cassert>
 
@@ -198,6 +203,15 @@ namespace opdet { class ICARUSOpHitFinder; }
  * (and multiple managers) but each of them sees an event at a time, in a way
  * that the module (replica) can predict.
  * 
+ * In addition, the waveforms of a single event are processed in parallel.
+ * The hit finding algorithms keep the result of the last waveform as their
+ * state, so each replica owns a complete set of algorithms and pulse
+ * reconstruction manager (a "worker") for each of the threads TBB may run it
+ * on, and each worker is only used by a single thread at a time.
+ * The hits from each waveform are collected separately and then merged in the
+ * order of the waveforms in the input data product, so that the result does
+ * not depend on the number of threads nor on the order of the processing.
+ * 
  */
 class opdet::ICARUSOpHitFinder: public art::ReplicatedProducer {
     public:
@@ -311,19 +325,45 @@ class opdet::ICARUSOpHitFinder: public art::ReplicatedProducer {
   using FWInterfacedPedAlgo
     = opdet::factory::FWInterfacedIF<pmtana::PMTPedestalBase, ArtTraits>;
   
-  pmtana::PulseRecoManager fPulseRecoMgr;
-  std::unique_ptr<pmtana::PMTPulseRecoBase> const fThreshAlg;
-  std::unique_ptr<FWInterfacedPedAlgo> const fPedAlg;
+  /// A complete set of algorithms, to be used by one thread at a time.
+  struct HitFinderWorker_t {
+    pmtana::PulseRecoManager pulseRecoMgr;
+    std::unique_ptr<pmtana::PMTPulseRecoBase> threshAlg;
+    std::unique_ptr<FWInterfacedPedAlgo> pedAlg;
+    bool inEvent = false; ///< Whether `pedAlg` was prepared for this event.
+  }; // HitFinderWorker_t
+  
+  fhicl::ParameterSet fHitAlgoPset; ///< Configuration of the hit algorithm.
+  fhicl::ParameterSet fPedAlgoPset; ///< Configuration of the pedestal algorithm.
+  
+  /// One worker per thread, created on the first use from that thread.
+  mutable tbb::enumerable_thread_specific<std::unique_ptr<HitFinderWorker_t>>
+    fWorkers;
   
   // --- END ---- Algorithms ---------------------------------------------------
   
+  /// Creates a worker with the algorithms from the specified configuration.
+  static std::unique_ptr<HitFinderWorker_t> makeWorker(
+    fhicl::ParameterSet const& hitAlgoPset,
+    fhicl::ParameterSet const& pedAlgoPset
+    );
+  
+  /// Returns the worker of the current thread, prepared for `event`.
+  HitFinderWorker_t& currentWorker(art::Event const& event) const;
+  
   /// Optionally reads the beam gates from `fBeamGateTag`, empty if none.
   std::vector<sim::BeamGateInfo const*> fetchBeamGates
     (art::Event const& event) const;
 
-  /// Returns a vector with copies of only the waveforms not in masked channels.
-  std::vector<raw::OpDetWaveform> selectWaveforms
+  /// Returns pointers to the waveforms not in masked channels.
+  std::vector<raw::OpDetWaveform const*> selectWaveforms
     (std::vector<raw::OpDetWaveform> const& waveforms) const;
+  
+  /// Finds the hits in `waveform` with the algorithms of `worker`.
+  std::vector<recob::OpHit> findHits(
+    raw::OpDetWaveform const& waveform, HitFinderWorker_t& worker,
+    geo::GeometryCore const& geom, detinfo::DetectorClocksData const& clockData
+    ) const;
 
 
 }; // opdet::ICARUSOpHitFinder
@@ -433,49 +473,6 @@ namespace {
     { sortVector(v); return v; }
   
   
-  /**
-   * @brief A "smart" pointer that may or may not own its data.
-   * @tparam T type of the data to point to
-   * 
-   * This pointer can be used when depending on a run-time condition a data set
-   * may come from an immutable, owning source (like `art::Event`) or from a
-   * local processing (e.g. a selection of the above).
-   * 
-   * If initialized with a pointer to the data, this pointer will refer to it
-   * without owning; if initialized with a r-value (reference) to data, the data
-   * is stolen and owned from now on.
-   */
-  template <typename T>
-  class MaybeOwnerPtr {
-      public:
-    using element_type = T;
-    using pointer = T*;
-    
-    /// Points to the given pointer without owning it.
-    MaybeOwnerPtr(pointer ptr) noexcept: fStorage{ ptr } {}
-    
-    /// Steals the data and owns it.
-    MaybeOwnerPtr(element_type&& data): fStorage{ std::move(data) } {}
-    
-    pointer get() const { return std::visit(PointerGetter{}, fStorage); }
-    
-    pointer operator->() const { return get(); }
-    auto& operator*() const { return *(get()); }
-    
-      private:
-    
-    struct PointerGetter {
-      pointer operator() (pointer ptr) const noexcept { return ptr; }
-      pointer operator() (element_type& item) const noexcept { return &item; }
-    }; // PointerGetter
-    
-    using store_t = std::variant<element_type, pointer>;
-    
-    store_t fStorage; ///< Contains the data or pointer to it.
-    
-  }; // MaybeOwnerPtr
-  
-  
 } // local namespace
 
 
@@ -492,11 +489,9 @@ opdet::ICARUSOpHitFinder::ICARUSOpHitFinder
   // caches
   , fMaxOpChannel{ frame.serviceHandle<geo::Geometry>()->MaxOpChannel() }
   // algorithms
-  , fPulseRecoMgr{}
-  , fThreshAlg
-    { HitAlgoFactory.create(params().HitAlgoPset.get<fhicl::ParameterSet>()) }
-  , fPedAlg
-    { PedAlgoFactory.create(params().PedAlgoPset.get<fhicl::ParameterSet>()) }
+  , fHitAlgoPset{ params().HitAlgoPset.get<fhicl::ParameterSet>() }
+  , fPedAlgoPset{ params().PedAlgoPset.get<fhicl::ParameterSet>() }
+  , fWorkers{ [this](){ return makeWorker(fHitAlgoPset, fPedAlgoPset); } }
 {
   
   //
@@ -522,37 +517,17 @@ opdet::ICARUSOpHitFinder::ICARUSOpHitFinder
   } // if ... else
   
   //
-  // register the algorithms in the manager
+  // the algorithms are created the first time each thread needs them
   //
-  fPulseRecoMgr.AddRecoAlgo(fThreshAlg.get());
-  fPulseRecoMgr.SetDefaultPedAlgo(&(fPedAlg->algo()));
-  
-  // framework hooks to the algorithms
-  if (!fChannelMasks.empty() && (fPedAlg->algo().Name() == "Fixed")) {
-    /* TODO
-     * The reason why this is not working is complicate.
-     * The interface of ophit mini-framework is quite minimal and tight,
-     * it accepts only `std::vector<short>` input and nothing more.
-     * The whole reason of this module is to overcome that limitation;
-     * since there is no channel information, we have to guess which channel
-     * this is the data of, and the way we do it is by address of the data;
-     * `raw::OpDetWaveform` derives from `std::vector<short>`, so when we use
-     * the original data product, the waveform data `std::vector<short>` is
-     * actually the same object and we can compare with the address of the data
-     * product, which we have because of the framework hooks here introduced;
-     * but if the `ChannelMasks` is not empty, we are forced to copy the
-     * original data in a new location (excluding the masked channels) and the
-     * new data has a different address. In principle we could still try to
-     * look for which `raw::OpDetWaveform` data product has the same content as
-     * the `std::vector<short>` we were given, which may be a bit tedious
-     * (thousand of vector comparisons to do, although all except the target one
-     * will be short because the noise pattern are different).
-     */
-    throw art::Exception{ art::errors::Configuration }
-      << "Pedestal algorithm \"Fixed\" will not work"
-      " since a channel mask list is specified.\n";
-  }
-  fPedAlg->initialize(consumesCollector());
+  // The interface of ophit mini-framework accepts only `std::vector<short>`
+  // input, with no channel information: algorithms like "Fixed" pedestal
+  // recognise the waveform by the address of the data, which is why the
+  // waveforms are always processed in place in the original data product.
+  //
+  // All the workers share the same configuration and therefore the same
+  // inputs, which are declared here once with a worker created on purpose.
+  //
+  makeWorker(fHitAlgoPset, fPedAlgoPset)->pedAlg->initialize(consumesCollector());
   
   //
   // declare output products
@@ -573,29 +548,14 @@ void opdet::ICARUSOpHitFinder::produce
   auto const& allWaveforms
     = event.getProduct<std::vector<raw::OpDetWaveform>>(fWaveformTags);
   
-  // this pointer owns the waveforms only if they come from `selectWaveforms()`
-//   MaybeOwnerPtr<std::vector<raw::OpDetWaveform> const> waveforms
-//     = fChannelMasks.empty()? &allWaveforms: selectWaveforms(allWaveforms);
-  using WaveformsPtr_t = MaybeOwnerPtr<std::vector<raw::OpDetWaveform> const>;
-  WaveformsPtr_t waveforms = fChannelMasks.empty()
-    ? WaveformsPtr_t{ &allWaveforms }
-    : WaveformsPtr_t{ selectWaveforms(allWaveforms) }
-    ;
-  
-  if (fChannelMasks.empty() && (&allWaveforms != &*waveforms)) {
-    // if this happens, contact the author
-    throw art::Exception{ art::errors::LogicError }
-      << "Bug in MaybeOwnerPtr!\n";
-  }
-  assert(fChannelMasks.empty() || (&allWaveforms == &*waveforms));
+  // pointers to the original data: the waveforms are never copied
+  std::vector<raw::OpDetWaveform const*> const waveforms
+    = selectWaveforms(allWaveforms);
   
   //
   // run the algorithm
   //
   
-  // framework hooks to the algorithms
-  fPedAlg->beginEvent(event);
-  
   std::vector<sim::BeamGateInfo const*> const beamGateArray
     = fetchBeamGates(event);
 
@@ -605,24 +565,43 @@ void opdet::ICARUSOpHitFinder::produce
       ->DataFor(event)
     ;
   
-  std::vector<recob::OpHit> opHits;
-
-  RunHitFinder(
-    *waveforms, opHits,
-    fPulseRecoMgr, *fThreshAlg,
-    geom,
-    fHitThreshold,
-    clockData,
-    *fCalib,
-    fUseStartTime
+  // hits from each waveform are kept separate to be merged in a fixed order
+  std::vector<std::vector<recob::OpHit>> waveformHits(waveforms.size());
+  
+  tbb::parallel_for(
+    tbb::blocked_range<std::size_t>{ 0U, waveforms.size() },
+    [&](tbb::blocked_range<std::size_t> const& range)
+      {
+        HitFinderWorker_t& worker = currentWorker(event);
+        for (auto iWaveform = range.begin(); iWaveform != range.end();
+          ++iWaveform
+        ) {
+          waveformHits[iWaveform]
+            = findHits(*(waveforms[iWaveform]), worker, geom, clockData);
+        }
+      }
     );
   
+  std::size_t nHits = 0U;
+  for (auto const& hits: waveformHits) nHits += hits.size();
+  
+  std::vector<recob::OpHit> opHits;
+  opHits.reserve(nHits);
+  for (auto& hits: waveformHits) {
+    opHits.insert(opHits.end(),
+      std::move_iterator{ hits.begin() }, std::move_iterator{ hits.end() });
+  }
+  
   mf::LogInfo{ "ICARUSOpHitFinder" }
-    << "Found " << opHits.size() << " hits from " << waveforms->size()
+    << "Found " << opHits.size() << " hits from " << waveforms.size()
     << " waveforms.";
   
-  // framework hooks to the algorithms
-  fPedAlg->endEvent(event);
+  // framework hooks to the algorithms (only the workers used in this event)
+  for (auto const& worker: fWorkers) {
+    if (!worker->inEvent) continue;
+    worker->pedAlg->endEvent(event);
+    worker->inEvent = false;
+  }
   
   //
   // store results into the event
@@ -632,6 +611,37 @@ void opdet::ICARUSOpHitFinder::produce
 } // opdet::ICARUSOpHitFinder::produce()
 
 
+//------------------------------------------------------------------------------
+auto opdet::ICARUSOpHitFinder::makeWorker(
+  fhicl::ParameterSet const& hitAlgoPset,
+  fhicl::ParameterSet const& pedAlgoPset
+) -> std::unique_ptr<HitFinderWorker_t> {
+  auto worker = std::make_unique<HitFinderWorker_t>();
+  worker->threshAlg = HitAlgoFactory.create(hitAlgoPset);
+  worker->pedAlg = PedAlgoFactory.create(pedAlgoPset);
+  
+  // register the algorithms in the manager
+  worker->pulseRecoMgr.AddRecoAlgo(worker->threshAlg.get());
+  worker->pulseRecoMgr.SetDefaultPedAlgo(&(worker->pedAlg->algo()));
+  
+  return worker;
+} // opdet::ICARUSOpHitFinder::makeWorker()
+
+
+//------------------------------------------------------------------------------
+auto opdet::ICARUSOpHitFinder::currentWorker
+  (art::Event const& event) const -> HitFinderWorker_t&
+{
+  HitFinderWorker_t& worker = *(fWorkers.local());
+  if (!worker.inEvent) {
+    // framework hooks to the algorithms, once per event for each worker
+    worker.pedAlg->beginEvent(event);
+    worker.inEvent = true;
+  }
+  return worker;
+} // opdet::ICARUSOpHitFinder::currentWorker()
+
+
 //------------------------------------------------------------------------------
 std::vector<sim::BeamGateInfo const*> opdet::ICARUSOpHitFinder::fetchBeamGates
   (art::Event const& event) const
@@ -649,24 +659,58 @@ std::vector<sim::BeamGateInfo const*> opdet::ICARUSOpHitFinder::fetchBeamGates
 
 
 //----------------------------------------------------------------------------
-std::vector<raw::OpDetWaveform> opdet::ICARUSOpHitFinder::selectWaveforms
+std::vector<raw::OpDetWaveform const*>
+opdet::ICARUSOpHitFinder::selectWaveforms
   (std::vector<raw::OpDetWaveform> const& waveforms) const
 {
-  std::vector<raw::OpDetWaveform> selected;
-  
-  auto const isNotMasked = [this](raw::OpDetWaveform const& waveform)
-    {
-      return !std::binary_search
-        (fChannelMasks.begin(), fChannelMasks.end(), waveform.ChannelNumber());
-    };
-  
-  std::copy_if
-    (waveforms.begin(), waveforms.end(), back_inserter(selected), isNotMasked);
+  std::vector<raw::OpDetWaveform const*> selected;
+  selected.reserve(waveforms.size());
+  
+  for (raw::OpDetWaveform const& waveform: waveforms) {
+    if (std::binary_search
+      (fChannelMasks.begin(), fChannelMasks.end(), waveform.ChannelNumber())
+    ) {
+      continue;
+    }
+    selected.push_back(&waveform);
+  } // for
   
   return selected;
 } // selectWaveforms()
 
 
+//----------------------------------------------------------------------------
+std::vector<recob::OpHit> opdet::ICARUSOpHitFinder::findHits(
+  raw::OpDetWaveform const& waveform, HitFinderWorker_t& worker,
+  geo::GeometryCore const& geom, detinfo::DetectorClocksData const& clockData
+) const {
+  
+  // this is the per-waveform body of LArSoft's `opdet::RunHitFinder()`
+  std::vector<recob::OpHit> hits;
+  
+  int const channel = static_cast<int>(waveform.ChannelNumber());
+  if (!geom.IsValidOpChannel(channel)) {
+    mf::LogError{ "ICARUSOpHitFinder" }
+      << "Error! unrecognized channel number " << channel << ". Ignoring pulse";
+    return hits;
+  }
+  
+  // the waveform is passed as the original object, which pedestal algorithms
+  // like "Fixed" rely on
+  worker.pulseRecoMgr.Reconstruct(waveform);
+  
+  double const timeStamp = waveform.TimeStamp();
+  for (auto const& pulse: worker.threshAlg->GetPulses()) {
+    ConstructHit(
+      fHitThreshold, channel, timeStamp, pulse, hits,
+      clockData, *fCalib, fUseStartTime
+      );
+  } // for pulses
+  
+  return hits;
+} // opdet::ICARUSOpHitFinder::findHits()
+
+
 // -----------------------------------------------------------------------------
 DEFINE_ART_MODULE(opdet::ICARUSOpHitFinder)
 
@@ -44,6 +44,10 @@
 #include "fhiclcpp/types/OptionalAtom.h"
 #include "fhiclcpp/types/Atom.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 // ROOT libraries
 #include "TH2F.h"
 #include "TGraph.h"
@@ -594,54 +598,75 @@ void icarus::PMTWaveformBaselinesFromChannelData::produce
   double const eventTime = static_cast<double>(event.time().timeHigh())
     + static_cast<double>(event.time().timeHigh()) * 1e-9;
   
-  std::vector<BaselineInfo_t> channelBaselines;
-  VectorExpander baselineForChannel { channelBaselines };
-  
   auto waveformsByChannel = groupByChannel(waveforms);
   
+  std::vector<std::size_t> activeChannels;
   for (auto const& [ channel, waveforms ]: util::enumerate(waveformsByChannel))
-  {
-    if (waveforms.empty()) continue;
-    
-    mf::LogTrace{ fLogCategory }
-      << "Processing " << waveforms.size() << " waveforms for channel "
-      << channel;
-    
-    //
-    // remove global trigger waveform
-    //
-    if (waveforms.size() >= fExcludeSpillTimeIfMoreThan) {
+    if (!waveforms.empty()) activeChannels.push_back(channel);
+  
+  // channels are independent: each task writes only the entries of its own
+  // channels, so the result does not depend on the scheduling
+  std::vector<BaselineInfo_t> channelBaselines(waveformsByChannel.size());
+  
+  auto const processChannel
+    = [&,this](std::size_t channel)
+    {
+      std::vector<raw::OpDetWaveform const*>& waveforms
+        = waveformsByChannel[channel];
       
-      unsigned int const nExcluded
-        = removeWaveformsAround(waveforms, triggerTime.value());
-      if (nExcluded > 0U) {
-        mf::LogTrace{ fLogCategory }
-          << "Removed " << nExcluded << "/" << (waveforms.size() + nExcluded)
-          << " waveforms at trigger time " << triggerTime;
-      }
+      mf::LogTrace{ fLogCategory }
+        << "Processing " << waveforms.size() << " waveforms for channel "
+        << channel;
       
-    } // if many waveforms
-    
-    //
-    // extract baseline
-    //
-    opdet::SharedWaveformBaseline::BaselineInfo_t const baseline
-      = sharedWaveformBaselineAlgo(waveforms);
-
-    mf::LogTrace{ fLogCategory }
-      << "Channel " << channel << ": baseline " << baseline.baseline
-      << " ADC# from " << baseline.nSamples << " samples in "
-      << baseline.nWaveforms << "/" << waveforms.size()
-      << " waveforms; found RMS=" << baseline.RMS << " ADC#";
-    
-    auto const chIndex = static_cast<std::size_t>(channel);
-    baselineForChannel(chIndex) = { baseline.baseline, baseline.RMS };
-    
-    if (fHBaselines) fHBaselines->Fill(double(channel), baseline.baseline);
+      //
+      // remove global trigger waveform
+      //
+      if (waveforms.size() >= fExcludeSpillTimeIfMoreThan) {
+        
+        unsigned int const nExcluded
+          = removeWaveformsAround(waveforms, triggerTime.value());
+        if (nExcluded > 0U) {
+          mf::LogTrace{ fLogCategory }
+            << "Removed " << nExcluded << "/" << (waveforms.size() + nExcluded)
+            << " waveforms at trigger time " << triggerTime;
+        }
+        
+      } // if many waveforms
+      
+      //
+      // extract baseline (using a sample histogram per thread)
+      //
+      opdet::SharedWaveformBaseline::BaselineInfo_t const baseline
+        = sharedWaveformBaselineAlgo(waveforms);
+      
+      mf::LogTrace{ fLogCategory }
+        << "Channel " << channel << ": baseline " << baseline.baseline
+        << " ADC# from " << baseline.nSamples << " samples in "
+        << baseline.nWaveforms << "/" << waveforms.size()
+        << " waveforms; found RMS=" << baseline.RMS << " ADC#";
+      
+      channelBaselines[channel] = { baseline.baseline, baseline.RMS };
+    }; // processChannel()
+  
+  tbb::parallel_for(
+    tbb::blocked_range<std::size_t>{ 0U, activeChannels.size() },
+    [&processChannel,&activeChannels]
+      (tbb::blocked_range<std::size_t> const& range)
+      {
+        for (std::size_t i = range.begin(); i != range.end(); ++i)
+          processChannel(activeChannels[i]);
+      }
+    );
+  
+  //
+  // plots are filled in channel order
+  //
+  for (std::size_t const chIndex: activeChannels) {
+    double const baseline = channelBaselines[chIndex].baseline.baseline();
+    if (fHBaselines) fHBaselines->Fill(double(chIndex), baseline);
     if (chIndex < fBaselinesVsTime.size())
-      fBaselinesVsTime[chIndex].emplace_back(eventTime, baseline.baseline);
-    
-  } // for grouped waveforms
+      fBaselinesVsTime[chIndex].emplace_back(eventTime, baseline);
+  } // for channels
   
   //
   // assign baselines to waveforms
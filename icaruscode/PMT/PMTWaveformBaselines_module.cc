@@ -6,6 +6,7 @@
  */
 
 // ICARUS libraries
+#include "icaruscode/PMT/Algorithms/ADCcountHistogram.h" // opdet::medianADC()
 #include "sbnobj/ICARUS/PMT/Data/WaveformBaseline.h"
 // #include "icaruscode/Utilities/DataProductPointerMap.h"
 
@@ -32,6 +33,10 @@
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "fhiclcpp/types/Atom.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 // ROOT libraries
 #include "TH2F.h"
 #include "TGraph.h"
@@ -222,27 +227,6 @@ class icarus::PMTWaveformBaselines: public art::EDProducer {
 //------------------------------------------------------------------------------
 //--- Implementation
 //------------------------------------------------------------------------------
-namespace {
-  
-  /// Extracts the median of the collection between the specified iterators.
-  template <typename BIter, typename EIter>
-  auto median(BIter begin, EIter end) {
-    
-    using value_type = typename BIter::value_type;
-    
-    std::vector<value_type> data{ begin, end };
-    assert(!data.empty());
-    
-    auto const middle = data.begin() + data.size() / 2;
-    std::nth_element(data.begin(), middle, data.end());
-    
-    return *middle;
-    
-  } // median()
-  
-} // local namespace
-
-
 //------------------------------------------------------------------------------
 //--- icarus::PMTWaveformBaselines
 //------------------------------------------------------------------------------
@@ -324,14 +308,26 @@ void icarus::PMTWaveformBaselines::produce(art::Event& event) {
   
   art::PtrMaker<icarus::WaveformBaseline> const makeBaselinePtr(event);
   
+  // waveforms are independent, and each task fills only its own baselines
+  baselines.resize(waveforms.size(), icarus::WaveformBaseline{ 0.0f });
+  tbb::parallel_for(
+    tbb::blocked_range<std::size_t>{ 0U, waveforms.size() },
+    [this,&waveforms,&baselines](tbb::blocked_range<std::size_t> const& range)
+      {
+        for (auto iWaveform = range.begin(); iWaveform != range.end();
+          ++iWaveform
+        ) {
+          baselines[iWaveform] = baselineFromMedian(waveforms[iWaveform]);
+        }
+      }
+    );
+  
   for (auto const& [ iWaveform, waveform ]: util::enumerate(waveforms)) {
-    assert(iWaveform == baselines.size());
     
-    icarus::WaveformBaseline const baseline { baselineFromMedian(waveform) };
+    icarus::WaveformBaseline const& baseline = baselines[iWaveform];
     
     if (!averages.empty())
       averages[waveform.ChannelNumber()].add(baseline.baseline());
-    baselines.push_back(baseline);
     
     baselineToWaveforms.addSingle(
       makeBaselinePtr(iWaveform),
@@ -478,8 +474,10 @@ icarus::WaveformBaseline icarus::PMTWaveformBaselines::baselineFromMedian
   (raw::OpDetWaveform const& waveform) const
 {
   
-  return icarus::WaveformBaseline
-    { waveform.empty()? 0.0f: median(waveform.begin(), waveform.end()) };
+  // median from a counting histogram, linear in the number of samples
+  return icarus::WaveformBaseline{
+    waveform.empty()? 0.0f: opdet::medianADC(waveform.begin(), waveform.end())
+    };
   
 } // icarus::PMTWaveformBaselines::baselineFromMedian()
 
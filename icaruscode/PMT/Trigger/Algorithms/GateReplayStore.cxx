@@ -0,0 +1,455 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/GateReplayStore.cxx
+ * @brief  Columnar storage of window trigger gates for offline pattern replay.
+ * @date   October 19, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h
+ */
+
+// library header
+#include "icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h"
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Utilities/DenseTriggerGates.h"
+#include "icaruscode/PMT/Trigger/Utilities/TrackedTriggerGate.h" // gateIn()
+
+// LArSoft libraries
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::CryostatID
+#include "larcoreobj/SimpleTypesAndConstants/geo_vectors.h" // geo::Point_t
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TTree.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::min(), std::find_if()
+#include <limits>
+#include <type_traits> // std::decay_t<>
+#include <utility> // std::move()
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Sets the address of a branch of `tree`, throwing if not possible.
+  template <typename T>
+  void setBranchAddress(TTree& tree, char const* name, T* address) {
+
+    if (tree.SetBranchAddress(name, address) >= 0) return;
+
+    throw cet::exception("GateReplayStore")
+      << "Failed to read branch '" << name << "' from tree '"
+      << tree.GetName() << "'.\n";
+
+  } // setBranchAddress()
+
+
+  /// Converts a window index into the stored format (`-1` if invalid).
+  Int_t windowIndexToStore(icarus::trigger::WindowChannelMap::WindowIndex_t i)
+  {
+    return icarus::trigger::WindowChannelMap::isValidWindow(i)
+      ? static_cast<Int_t>(i): -1;
+  } // windowIndexToStore()
+
+
+  /// Converts a stored window index into a `WindowChannelMap` one.
+  icarus::trigger::WindowChannelMap::WindowIndex_t windowIndexFromStore
+    (Int_t i)
+  {
+    return (i < 0)
+      ? icarus::trigger::WindowChannelMap::InvalidWindowIndex
+      : static_cast<icarus::trigger::WindowChannelMap::WindowIndex_t>(i);
+  } // windowIndexFromStore()
+
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+std::string icarus::trigger::gateReplayEventTreeName
+  (std::string const& storeName)
+  { return storeName + "Events"; }
+
+
+//------------------------------------------------------------------------------
+std::string icarus::trigger::gateReplayWindowTreeName
+  (std::string const& storeName)
+  { return storeName + "Windows"; }
+
+
+//------------------------------------------------------------------------------
+//--- icarus::trigger::GateReplayEvent
+//------------------------------------------------------------------------------
+void icarus::trigger::GateReplayEvent::clear() {
+
+  run = 0U;
+  subRun = 0U;
+  event = 0U;
+  beamGateStart = 0;
+  beamGateEnd = 0;
+  fired = false;
+  triggerTick = 0;
+  triggerWindow = -1;
+
+  gateBegin.assign(1U, 0U);
+  changeTicks.clear();
+  changeLevels.clear();
+  channelBegin.assign(1U, 0U);
+  channels.clear();
+  trackBegin.assign(1U, 0U);
+  trackChannels.clear();
+  trackStartTimes.clear();
+
+} // icarus::trigger::GateReplayEvent::clear()
+
+
+//------------------------------------------------------------------------------
+void icarus::trigger::GateReplayEvent::addWindowGate(TriggerGate_t const& gate)
+{
+  auto const& gateData = gateIn(gate);
+
+  //
+  // gate levels: one entry per change, except for the closed gate at start
+  //
+  details::forEachGateLevel(gateData, gateData.MinTick, gateData.MaxTick,
+    [this,MinTick=gateData.MinTick](auto begin, auto /* end */, auto level)
+      {
+        using Opening_t = decltype(level);
+        constexpr auto MaxLevel
+          = static_cast<Opening_t>(std::numeric_limits<Level_t>::max());
+        if ((begin == MinTick) && (level == 0)) return;
+        changeTicks.push_back(static_cast<Tick_t>(begin));
+        changeLevels.push_back(static_cast<Level_t>(std::min(level, MaxLevel)));
+      }
+    );
+  gateBegin.push_back(static_cast<Index_t>(changeTicks.size()));
+
+  //
+  // channels
+  //
+  for (raw::Channel_t const channel: gate.channels())
+    channels.push_back(channel);
+  channelBegin.push_back(static_cast<Index_t>(channels.size()));
+
+  //
+  // tracked waveforms
+  //
+  for (auto const* waveform: gate.tracking().getTracked()) {
+    trackChannels.push_back(waveform->channel);
+    trackStartTimes.push_back(waveform->startTime);
+  }
+  trackBegin.push_back(static_cast<Index_t>(trackChannels.size()));
+
+} // icarus::trigger::GateReplayEvent::addWindowGate()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::GateReplayEvent::gate(std::size_t iWindow) const
+  -> TriggerGate_t
+{
+  TriggerGate_t gate;
+  auto& gateData = gate.gate();
+  using GateData_t = std::decay_t<decltype(gateData)>;
+  using ClockTick_t = std::decay_t<decltype(gateData.MaxTick)>;
+  using OpeningDiff_t = typename GateData_t::OpeningDiff_t;
+
+  for (Index_t i = channelBegin[iWindow]; i < channelBegin[iWindow + 1]; ++i)
+    gateData.addChannel(channels[i]);
+
+  Level_t level = 0U;
+  for (Index_t i = gateBegin[iWindow]; i < gateBegin[iWindow + 1]; ++i) {
+    auto const tick = static_cast<ClockTick_t>(changeTicks[i]);
+    Level_t const newLevel = changeLevels[i];
+    if (newLevel > level)
+      gateData.openAt(tick, static_cast<OpeningDiff_t>(newLevel - level));
+    else
+      gateData.closeAt(tick, static_cast<OpeningDiff_t>(level - newLevel));
+    level = newLevel;
+  } // for
+
+  return gate;
+} // icarus::trigger::GateReplayEvent::gate()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::GateReplayEvent::gates() const -> TriggerGates_t {
+
+  TriggerGates_t gates;
+  gates.reserve(nWindows());
+  for (std::size_t iWindow = 0; iWindow < nWindows(); ++iWindow)
+    gates.push_back(gate(iWindow));
+  return gates;
+
+} // icarus::trigger::GateReplayEvent::gates()
+
+
+//------------------------------------------------------------------------------
+std::vector<sbn::OpDetWaveformMeta>
+icarus::trigger::GateReplayEvent::trackedWaveforms() const {
+
+  std::vector<sbn::OpDetWaveformMeta> waveforms;
+  for (std::size_t i = 0; i < trackChannels.size(); ++i) {
+    if (findTracked(waveforms, i) != waveforms.end()) continue;
+    sbn::OpDetWaveformMeta waveform;
+    waveform.channel = trackChannels[i];
+    waveform.startTime = trackStartTimes[i];
+    waveforms.push_back(std::move(waveform));
+  } // for
+  return waveforms;
+
+} // icarus::trigger::GateReplayEvent::trackedWaveforms()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::GateReplayEvent::gate(
+  std::size_t iWindow, std::vector<sbn::OpDetWaveformMeta> const& waveforms
+) const -> TriggerGate_t {
+
+  TriggerGate_t gate = this->gate(iWindow);
+
+  for (Index_t i = trackBegin[iWindow]; i < trackBegin[iWindow + 1]; ++i) {
+    auto const itWaveform = findTracked(waveforms, i);
+    if (itWaveform == waveforms.end()) {
+      throw cet::exception("GateReplayStore")
+        << "Waveform on channel " << trackChannels[i] << " starting at "
+        << trackStartTimes[i] << " tracked by the gate of window #" << iWindow
+        << " is not among the " << waveforms.size() << " supplied waveforms.\n";
+    }
+    gate.tracking().add(&*itWaveform);
+  } // for
+
+  return gate;
+} // icarus::trigger::GateReplayEvent::gate(waveforms)
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::GateReplayEvent::gates
+  (std::vector<sbn::OpDetWaveformMeta> const& waveforms) const
+  -> TriggerGates_t
+{
+  TriggerGates_t gates;
+  gates.reserve(nWindows());
+  for (std::size_t iWindow = 0; iWindow < nWindows(); ++iWindow)
+    gates.push_back(gate(iWindow, waveforms));
+  return gates;
+} // icarus::trigger::GateReplayEvent::gates(waveforms)
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::GateReplayEvent::findTracked
+  (std::vector<sbn::OpDetWaveformMeta> const& waveforms, Index_t iTrack) const
+  -> std::vector<sbn::OpDetWaveformMeta>::const_iterator
+{
+  return std::find_if(waveforms.begin(), waveforms.end(),
+    [channel=trackChannels[iTrack],startTime=trackStartTimes[iTrack]]
+      (sbn::OpDetWaveformMeta const& waveform)
+      {
+        return (waveform.channel == channel)
+          && (waveform.startTime == startTime);
+      }
+    );
+} // icarus::trigger::GateReplayEvent::findTracked()
+
+
+//------------------------------------------------------------------------------
+//--- icarus::trigger::GateReplayStoreWriter
+//------------------------------------------------------------------------------
+icarus::trigger::GateReplayStoreWriter::GateReplayStoreWriter
+  (TTree& eventTree, TTree& windowTree)
+  : fEventTree(&eventTree), fWindowTree(&windowTree)
+{
+
+  fEventTree->Branch("Run", &fEvent.run);
+  fEventTree->Branch("SubRun", &fEvent.subRun);
+  fEventTree->Branch("Event", &fEvent.event);
+  fEventTree->Branch("BeamGateStart", &fEvent.beamGateStart);
+  fEventTree->Branch("BeamGateEnd", &fEvent.beamGateEnd);
+  fEventTree->Branch("Fired", &fEvent.fired);
+  fEventTree->Branch("TriggerTick", &fEvent.triggerTick);
+  fEventTree->Branch("TriggerWindow", &fEvent.triggerWindow);
+  fEventTree->Branch("GateBegin", &fEvent.gateBegin);
+  fEventTree->Branch("ChangeTicks", &fEvent.changeTicks);
+  fEventTree->Branch("ChangeLevels", &fEvent.changeLevels);
+  fEventTree->Branch("ChannelBegin", &fEvent.channelBegin);
+  fEventTree->Branch("Channels", &fEvent.channels);
+  fEventTree->Branch("TrackBegin", &fEvent.trackBegin);
+  fEventTree->Branch("TrackChannels", &fEvent.trackChannels);
+  fEventTree->Branch("TrackStartTimes", &fEvent.trackStartTimes);
+
+  fWindowTree->Branch("Index", &fWindow.index);
+  fWindowTree->Branch("Opposite", &fWindow.opposite);
+  fWindowTree->Branch("Upstream", &fWindow.upstream);
+  fWindowTree->Branch("Downstream", &fWindow.downstream);
+  fWindowTree->Branch("Cryostat", &fWindow.cryostat);
+  fWindowTree->Branch("Center", fWindow.center, "Center[3]/D");
+  fWindowTree->Branch("Channels", &fWindow.channels);
+
+} // icarus::trigger::GateReplayStoreWriter::GateReplayStoreWriter()
+
+
+//------------------------------------------------------------------------------
+void icarus::trigger::GateReplayStoreWriter::setTopology
+  (icarus::trigger::WindowChannelMap const& topology)
+{
+  if (fTopologyWritten) return;
+
+  for (icarus::trigger::WindowChannelMap::WindowInfo_t const& info: topology)
+  {
+    fWindow.index = static_cast<UInt_t>(info.index);
+    fWindow.opposite = windowIndexToStore(info.opposite);
+    fWindow.upstream = windowIndexToStore(info.upstream);
+    fWindow.downstream = windowIndexToStore(info.downstream);
+    fWindow.cryostat
+      = info.hasCryostat()? static_cast<Int_t>(info.cryoid.Cryostat): -1;
+    fWindow.center[0] = info.center.X();
+    fWindow.center[1] = info.center.Y();
+    fWindow.center[2] = info.center.Z();
+    fWindow.channels.assign(info.channels.begin(), info.channels.end());
+    fWindowTree->Fill();
+  } // for
+
+  fTopologyWritten = true;
+
+} // icarus::trigger::GateReplayStoreWriter::setTopology()
+
+
+//------------------------------------------------------------------------------
+void icarus::trigger::GateReplayStoreWriter::add(
+  art::EventID const& id, Tick_t beamGateStart, Tick_t beamGateEnd,
+  TriggerGates_t const& gates, AllTriggerInfo_t const& response
+) {
+
+  fEvent.clear();
+
+  fEvent.run = id.run();
+  fEvent.subRun = id.subRun();
+  fEvent.event = id.event();
+  fEvent.beamGateStart = beamGateStart;
+  fEvent.beamGateEnd = beamGateEnd;
+
+  if (response) {
+    fEvent.fired = true;
+    fEvent.triggerTick = static_cast<Tick_t>(response.info.atTick().value());
+    fEvent.triggerWindow = windowIndexToStore(response.extra.windowIndex);
+  }
+
+  for (auto const& gate: gates) fEvent.addWindowGate(gate);
+
+  fEventTree->Fill();
+
+} // icarus::trigger::GateReplayStoreWriter::add()
+
+
+//------------------------------------------------------------------------------
+//--- icarus::trigger::GateReplayStoreReader
+//------------------------------------------------------------------------------
+icarus::trigger::GateReplayStoreReader::GateReplayStoreReader
+  (TTree& eventTree, TTree& windowTree)
+  : fEventTree(&eventTree)
+  , fColumns{
+      &fEvent.gateBegin, &fEvent.changeTicks, &fEvent.changeLevels,
+      &fEvent.channelBegin, &fEvent.channels,
+      &fEvent.trackBegin, &fEvent.trackChannels, &fEvent.trackStartTimes
+    }
+  , fTopology(readTopology(windowTree))
+{
+
+  setBranchAddress(*fEventTree, "Run", &fEvent.run);
+  setBranchAddress(*fEventTree, "SubRun", &fEvent.subRun);
+  setBranchAddress(*fEventTree, "Event", &fEvent.event);
+  setBranchAddress(*fEventTree, "BeamGateStart", &fEvent.beamGateStart);
+  setBranchAddress(*fEventTree, "BeamGateEnd", &fEvent.beamGateEnd);
+  setBranchAddress(*fEventTree, "Fired", &fEvent.fired);
+  setBranchAddress(*fEventTree, "TriggerTick", &fEvent.triggerTick);
+  setBranchAddress(*fEventTree, "TriggerWindow", &fEvent.triggerWindow);
+  setBranchAddress(*fEventTree, "GateBegin", &fColumns.gateBegin);
+  setBranchAddress(*fEventTree, "ChangeTicks", &fColumns.changeTicks);
+  setBranchAddress(*fEventTree, "ChangeLevels", &fColumns.changeLevels);
+  setBranchAddress(*fEventTree, "ChannelBegin", &fColumns.channelBegin);
+  setBranchAddress(*fEventTree, "Channels", &fColumns.channels);
+  setBranchAddress(*fEventTree, "TrackBegin", &fColumns.trackBegin);
+  setBranchAddress(*fEventTree, "TrackChannels", &fColumns.trackChannels);
+  setBranchAddress(*fEventTree, "TrackStartTimes", &fColumns.trackStartTimes);
+
+} // icarus::trigger::GateReplayStoreReader::GateReplayStoreReader()
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::trigger::GateReplayStoreReader::nEvents() const
+  { return static_cast<std::size_t>(fEventTree->GetEntries()); }
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::GateReplayStoreReader::read(std::size_t iEvent)
+  -> GateReplayEvent const&
+{
+  if (fEventTree->GetEntry(static_cast<Long64_t>(iEvent)) <= 0) {
+    throw cet::exception("GateReplayStore")
+      << "Failed to read event #" << iEvent << " from tree '"
+      << fEventTree->GetName() << "' (" << nEvents() << " events).\n";
+  }
+
+  if (fEvent.nWindows() != fTopology.nWindows()) {
+    throw cet::exception("GateReplayStore")
+      << "Event #" << iEvent << " from tree '" << fEventTree->GetName()
+      << "' has " << fEvent.nWindows() << " windows, while the topology has "
+      << fTopology.nWindows() << ".\n";
+  }
+
+  return fEvent;
+} // icarus::trigger::GateReplayStoreReader::read()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::GateReplayStoreReader::readTopology(TTree& windowTree)
+  -> icarus::trigger::WindowChannelMap
+{
+  GateReplayStoreWriter::WindowEntry_t entry;
+  std::vector<UInt_t>* channels = &entry.channels;
+
+  setBranchAddress(windowTree, "Index", &entry.index);
+  setBranchAddress(windowTree, "Opposite", &entry.opposite);
+  setBranchAddress(windowTree, "Upstream", &entry.upstream);
+  setBranchAddress(windowTree, "Downstream", &entry.downstream);
+  setBranchAddress(windowTree, "Cryostat", &entry.cryostat);
+  setBranchAddress(windowTree, "Center", entry.center);
+  setBranchAddress(windowTree, "Channels", &channels);
+
+  std::vector<icarus::trigger::WindowChannelMap::WindowInfo_t> windows;
+  Long64_t const nWindows = windowTree.GetEntries();
+  windows.reserve(nWindows);
+  for (Long64_t iWindow = 0; iWindow < nWindows; ++iWindow) {
+
+    windowTree.GetEntry(iWindow);
+    if (entry.index != static_cast<UInt_t>(iWindow)) {
+      windowTree.ResetBranchAddresses();
+      throw cet::exception("GateReplayStore")
+        << "Window #" << iWindow << " in tree '" << windowTree.GetName()
+        << "' has index " << entry.index << ".\n";
+    }
+
+    icarus::trigger::WindowChannelMap::WindowInfo_t info;
+    info.index = entry.index;
+    info.opposite = windowIndexFromStore(entry.opposite);
+    info.upstream = windowIndexFromStore(entry.upstream);
+    info.downstream = windowIndexFromStore(entry.downstream);
+    if (entry.cryostat >= 0) {
+      info.cryoid = geo::CryostatID
+        { static_cast<geo::CryostatID::CryostatID_t>(entry.cryostat) };
+    }
+    info.center
+      = geo::Point_t{ entry.center[0], entry.center[1], entry.center[2] };
+    info.channels.assign(entry.channels.begin(), entry.channels.end());
+
+    windows.push_back(std::move(info));
+  } // for
+
+  // the addresses point to local variables
+  windowTree.ResetBranchAddresses();
+
+  return icarus::trigger::WindowChannelMap{ std::move(windows) };
+} // icarus::trigger::GateReplayStoreReader::readTopology()
+
+
+//------------------------------------------------------------------------------
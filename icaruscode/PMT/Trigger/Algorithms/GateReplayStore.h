@@ -0,0 +1,344 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h
+ * @brief  Columnar storage of window trigger gates for offline pattern replay.
+ * @date   October 19, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/GateReplayStore.cxx
+ *
+ * The replay store is a pair of ROOT trees: one with an entry per event,
+ * holding the trigger gates of all the sliding windows, and one with an entry
+ * per window, holding the window topology.
+ * Trigger patterns can be applied to the stored gates with
+ * `icarus::trigger::SlidingWindowPatternAlg` without running _art_ again
+ * (see also `replayTriggerPatterns` executable).
+ */
+
+#ifndef ICARUSCODE_PMT_TRIGGER_ALGORITHMS_GATEREPLAYSTORE_H
+#define ICARUSCODE_PMT_TRIGGER_ALGORITHMS_GATEREPLAYSTORE_H
+
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowChannelMap.h"
+#include "icaruscode/IcarusObj/OpDetWaveformMeta.h"
+
+// framework libraries
+#include "canvas/Persistency/Provenance/EventID.h"
+
+// ROOT libraries
+#include "Rtypes.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+class TTree;
+
+namespace icarus::trigger {
+
+  struct GateReplayEvent;
+  class GateReplayStoreWriter;
+  class GateReplayStoreReader;
+
+  /// Name of the tree with the event gates of the replay store `storeName`.
+  std::string gateReplayEventTreeName(std::string const& storeName);
+
+  /// Name of the tree with the window topology of the replay store `storeName`.
+  std::string gateReplayWindowTreeName(std::string const& storeName);
+
+} // namespace icarus::trigger
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Content of one event in the gate replay store.
+ *
+ * The gates of all the windows are stored in columns: for each window, the
+ * level of the gate is recorded only at the ticks where it changes
+ * (`changeTicks` and `changeLevels`); the changes of window `i` are the ones
+ * from index `gateBegin[i]` to `gateBegin[i + 1]`, and before the first change
+ * of a window its gate is closed (level `0`).
+ * The same layout is used for the channels of each window gate (`channels`,
+ * starting at `channelBegin`) and for the waveforms tracked by each window gate
+ * (`trackChannels` and `trackStartTimes`, starting at `trackBegin`).
+ *
+ * Of the tracked waveforms only channel and start time are stored: the
+ * waveform information can be restored with `trackedWaveforms()`, and gates
+ * tracking it are returned by `gate(std::size_t, std::vector<sbn::OpDetWaveformMeta> const&) const`.
+ * The gates returned by `gate(std::size_t) const` carry no tracking.
+ *
+ * The stored gates are the ones the trigger simulation is applied to, that is
+ * already in coincidence with the beam gate, whose range is also stored.
+ * The response of the trigger simulation which produced the store is also
+ * recorded, for reference.
+ */
+struct icarus::trigger::GateReplayEvent {
+
+  using Tick_t = Long64_t; ///< Type of time in the gates [optical tick]
+  using Level_t = UShort_t; ///< Type of level of the gates.
+  using Index_t = UInt_t; ///< Type of index into the columns.
+
+  /// Type of trigger gate reconstructed from the store.
+  using TriggerGate_t
+    = icarus::trigger::SlidingWindowPatternAlg::InputTriggerGate_t;
+
+  /// A list of trigger gates (one per window).
+  using TriggerGates_t
+    = icarus::trigger::SlidingWindowPatternAlg::TriggerGates_t;
+
+
+  // --- BEGIN -- Event information --------------------------------------------
+  UInt_t run = 0U; ///< Run number.
+  UInt_t subRun = 0U; ///< Subrun number.
+  UInt_t event = 0U; ///< Event number.
+
+  Tick_t beamGateStart = 0; ///< Opening time of the beam gate [optical tick]
+  Tick_t beamGateEnd = 0; ///< Closing time of the beam gate [optical tick]
+
+  Bool_t fired = false; ///< Whether the recorded trigger fired.
+  Tick_t triggerTick = 0; ///< Time of the recorded trigger [optical tick]
+  Int_t triggerWindow = -1; ///< Window leading the recorded trigger.
+  // --- END ---- Event information --------------------------------------------
+
+
+  // --- BEGIN -- Columns ------------------------------------------------------
+  std::vector<Index_t> gateBegin { 0U }; ///< First change of each window.
+  std::vector<Tick_t> changeTicks; ///< Tick of each gate change.
+  std::vector<Level_t> changeLevels; ///< Level after each gate change.
+
+  std::vector<Index_t> channelBegin { 0U }; ///< First channel of each window.
+  std::vector<UInt_t> channels; ///< Channels of the window gates.
+
+  std::vector<Index_t> trackBegin { 0U }; ///< First tracked waveform of each.
+  std::vector<UInt_t> trackChannels; ///< Channel of each tracked waveform.
+  std::vector<Double_t> trackStartTimes; ///< Start of each tracked waveform.
+  // --- END ---- Columns ------------------------------------------------------
+
+
+  /// Returns the number of windows in the event.
+  std::size_t nWindows() const { return gateBegin.size() - 1U; }
+
+  /// Removes all the content.
+  void clear();
+
+  /// Appends the specified `gate` as the gate of the next window.
+  void addWindowGate(TriggerGate_t const& gate);
+
+  /// Returns the gate of the window `iWindow` (tracking is not restored).
+  TriggerGate_t gate(std::size_t iWindow) const;
+
+  /// Returns the gates of all the windows, in window order (no tracking).
+  TriggerGates_t gates() const;
+
+  /**
+   * @brief Returns the waveforms tracked by any of the window gates.
+   * @return the tracked waveforms, each one only once, in storage order
+   *
+   * Only `channel` and `startTime` of the returned waveforms are set.
+   * A waveform tracked by more than one window gate is returned only once.
+   */
+  std::vector<sbn::OpDetWaveformMeta> trackedWaveforms() const;
+
+  /**
+   * @brief Returns the gate of the window `iWindow`, with tracking.
+   * @param iWindow the window to return the gate of
+   * @param waveforms the waveforms to be tracked, from `trackedWaveforms()`
+   * @return the gate, tracking the pertinent waveforms from `waveforms`
+   * @throw cet::exception (category: `"GateReplayStore"`) if a waveform
+   *        tracked by the stored gate is not in `waveforms`
+   *
+   * The returned gate points to the elements of `waveforms`, which must then
+   * outlive it.
+   */
+  TriggerGate_t gate(
+    std::size_t iWindow, std::vector<sbn::OpDetWaveformMeta> const& waveforms
+    ) const;
+
+  /// Returns the gates of all the windows, in window order, with tracking.
+  /// @see `gate(std::size_t, std::vector<sbn::OpDetWaveformMeta> const&) const`
+  TriggerGates_t gates
+    (std::vector<sbn::OpDetWaveformMeta> const& waveforms) const;
+
+    private:
+
+  /// Returns the waveform in `waveforms` matching the tracked one `iTrack`.
+  std::vector<sbn::OpDetWaveformMeta>::const_iterator findTracked
+    (std::vector<sbn::OpDetWaveformMeta> const& waveforms, Index_t iTrack)
+    const;
+
+}; // icarus::trigger::GateReplayEvent
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Writes window trigger gates into a gate replay store.
+ *
+ * The trees are supplied by the caller, and this object creates their branches
+ * and fills them. The trees must outlive this object.
+ *
+ * Example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * icarus::trigger::GateReplayStoreWriter writer{ *eventTree, *windowTree };
+ *
+ * // on each event:
+ * auto const beamGates = beamGate.applyToAll(gates);
+ * auto const response = patternAlg.simulateResponse(beamGates);
+ * writer.setTopology(topology); // only the first time has effect
+ * writer.add(event.id(), beamGate.tickRange(), beamGates, response);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class icarus::trigger::GateReplayStoreWriter {
+
+    public:
+
+  using Tick_t = GateReplayEvent::Tick_t; ///< Type of gate time.
+
+  /// Type of list of window gates.
+  using TriggerGates_t = GateReplayEvent::TriggerGates_t;
+
+  /// Type of trigger response being recorded.
+  using AllTriggerInfo_t
+    = icarus::trigger::SlidingWindowPatternAlg::AllTriggerInfo_t;
+
+  /// Constructor: creates the branches in the specified trees.
+  GateReplayStoreWriter(TTree& eventTree, TTree& windowTree);
+
+  // the branches point to our data members
+  GateReplayStoreWriter(GateReplayStoreWriter const&) = delete;
+  GateReplayStoreWriter& operator= (GateReplayStoreWriter const&) = delete;
+
+  /// Writes the window topology; only the first call has any effect.
+  void setTopology(icarus::trigger::WindowChannelMap const& topology);
+
+  /// Returns whether the window topology has been written already.
+  bool hasTopology() const { return fTopologyWritten; }
+
+  /**
+   * @brief Records the gates of an event.
+   * @tparam TickRange type of range with `start()` and `end()` optical ticks
+   * @param id ID of the event
+   * @param beamGate the range of the beam gate [optical tick]
+   * @param gates the window gates, after the beam gate has been applied
+   * @param response the response of the trigger to those gates
+   */
+  template <typename TickRange>
+  void add(
+    art::EventID const& id, TickRange const& beamGate,
+    TriggerGates_t const& gates, AllTriggerInfo_t const& response
+    )
+    {
+      add(
+        id,
+        static_cast<Tick_t>(beamGate.start().value()),
+        static_cast<Tick_t>(beamGate.end().value()),
+        gates, response
+        );
+    }
+
+  /// Records the gates of an event (beam gate as ticks).
+  void add(
+    art::EventID const& id, Tick_t beamGateStart, Tick_t beamGateEnd,
+    TriggerGates_t const& gates, AllTriggerInfo_t const& response
+    );
+
+    private:
+
+  /// Content of the window tree.
+  struct WindowEntry_t {
+    UInt_t index = 0U;
+    Int_t opposite = -1;
+    Int_t upstream = -1;
+    Int_t downstream = -1;
+    Int_t cryostat = -1;
+    Double_t center[3] = { 0.0, 0.0, 0.0 };
+    std::vector<UInt_t> channels;
+  }; // WindowEntry_t
+
+  TTree* fEventTree = nullptr; ///< Tree with one entry per event.
+  TTree* fWindowTree = nullptr; ///< Tree with one entry per window.
+
+  GateReplayEvent fEvent; ///< Buffer for the event tree.
+  WindowEntry_t fWindow; ///< Buffer for the window tree.
+
+  bool fTopologyWritten = false; ///< Whether window tree is already filled.
+
+  friend class GateReplayStoreReader;
+
+}; // icarus::trigger::GateReplayStoreWriter
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Reads window trigger gates from a gate replay store.
+ *
+ * The window topology is read on construction; events are read on demand
+ * with `read()`, which returns a reference to an internal buffer that is
+ * overwritten on each call.
+ *
+ * Example of replay of a set of patterns on all the stored events:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * icarus::trigger::GateReplayStoreReader reader{ *eventTree, *windowTree };
+ * icarus::trigger::SlidingWindowPatternGridAlg const patternAlgs
+ *   { reader.topology(), patterns };
+ * for (std::size_t iEvent = 0; iEvent < reader.nEvents(); ++iEvent) {
+ *   auto const responses
+ *     = patternAlgs.simulateResponses(reader.read(iEvent).gates());
+ *   // ...
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The stored gates already include the beam gate, so no beam gate should be
+ * set in the pattern algorithms.
+ */
+class icarus::trigger::GateReplayStoreReader {
+
+    public:
+
+  /// Constructor: reads the topology and prepares to read the events.
+  /// @throw cet::exception (category: `"GateReplayStore"`) on format errors
+  GateReplayStoreReader(TTree& eventTree, TTree& windowTree);
+
+  // the branches point to our data members
+  GateReplayStoreReader(GateReplayStoreReader const&) = delete;
+  GateReplayStoreReader& operator= (GateReplayStoreReader const&) = delete;
+
+  /// Returns the topology of the windows of the stored gates.
+  icarus::trigger::WindowChannelMap const& topology() const
+    { return fTopology; }
+
+  /// Returns the number of stored events.
+  std::size_t nEvents() const;
+
+  /// Reads and returns the event with the specified index.
+  GateReplayEvent const& read(std::size_t iEvent);
+
+    private:
+
+  TTree* fEventTree = nullptr; ///< Tree with one entry per event.
+
+  GateReplayEvent fEvent; ///< Buffer for the event tree.
+
+  /// Pointers to the columns in `fEvent`, as required by ROOT.
+  struct ColumnAddresses_t {
+    std::vector<GateReplayEvent::Index_t>* gateBegin;
+    std::vector<GateReplayEvent::Tick_t>* changeTicks;
+    std::vector<GateReplayEvent::Level_t>* changeLevels;
+    std::vector<GateReplayEvent::Index_t>* channelBegin;
+    std::vector<UInt_t>* channels;
+    std::vector<GateReplayEvent::Index_t>* trackBegin;
+    std::vector<UInt_t>* trackChannels;
+    std::vector<Double_t>* trackStartTimes;
+  } fColumns;
+
+  icarus::trigger::WindowChannelMap fTopology; ///< The window topology.
+
+  /// Reads the window topology from `windowTree`.
+  static icarus::trigger::WindowChannelMap readTopology(TTree& windowTree);
+
+}; // icarus::trigger::GateReplayStoreReader
+
+
+//------------------------------------------------------------------------------
+
+#endif // ICARUSCODE_PMT_TRIGGER_ALGORITHMS_GATEREPLAYSTORE_H
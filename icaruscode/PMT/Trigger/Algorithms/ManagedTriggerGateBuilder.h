@@ -47,9 +47,17 @@ namespace icarus::trigger {
  * in a gate.
  * 
  * Note that actions are performed only when the sample crosses a threshold.
- * The algorithm keeps track at each time of which are the thresholds enclosing
- * the signal level, and if the level crosses one of them, the gates associated
- * to those thresholds, and only them, are offered a chance to react.
+ * The crossings of all the thresholds are found in a single scan of each
+ * waveform (see `icarus::opdet::ThresholdCrossingFinder`), and then the gate
+ * associated to each threshold, and only that gate, is offered a chance to
+ * react to the crossings of its threshold, in time order.
+ * 
+ * Channels are independent of each other: `unifiedBuild()` creates all the
+ * gates first, in channel order, and then processes the waveforms of each
+ * channel as a separate TBB task with its own gate information objects.
+ * Gate managers must then support concurrent calls to the gate information
+ * objects of different channels. The result does not depend on the order
+ * the channels are processed in.
  */
 class icarus::trigger::ManagedTriggerGateBuilder
   : public icarus::trigger::TriggerGateBuilder
@@ -105,6 +113,21 @@ class icarus::trigger::ManagedTriggerGateBuilder
     (std::vector<GateInfo>& channelGates, Waveforms const& channelWaveforms)
     const;
   
+  /**
+   * @brief Returns the sample levels corresponding to the `thresholds`.
+   * @param thresholds thresholds relative to the baseline, in increasing order
+   * @param waveOps waveform operations, including baseline and polarity
+   * @return the highest sample value passing each of the reachable thresholds
+   * 
+   * The returned levels include the rounding of the baseline-subtracted
+   * samples, so that a sample passes a threshold exactly when it is not
+   * larger than its level. Thresholds that no sample can pass are omitted,
+   * so the result may be shorter than `thresholds`.
+   */
+  template <typename WaveformOps>
+  static std::vector<raw::ADC_Count_t> thresholdSampleLevels
+    (std::vector<ADCCounts_t> const& thresholds, WaveformOps const& waveOps);
+  
 }; // class icarus::trigger::ManagedTriggerGateBuilder
 
 
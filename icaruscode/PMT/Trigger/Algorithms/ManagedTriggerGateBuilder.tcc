@@ -19,24 +19,33 @@
 
 // ICARUS libraries
 #include "icaruscode/PMT/Trigger/Algorithms/TriggerTypes.h" // icarus::trigger::ADCCounts_t
+#include "icaruscode/PMT/Algorithms/ThresholdCrossingFinder.h"
 #include "icarusalg/Utilities/WaveformOperations.h"
 
 // LArSoft libraries
 #include "lardataobj/RawData/OpDetWaveform.h"
-#include "larcorealg/CoreUtils/counter.h"
+#include "larcorealg/CoreUtils/zip.h"
 // #include "larcorealg/CoreUtils/StdUtils.h" // util::to_string()
 
 // framework libraries
 #include "messagefacility/MessageLogger/MessageLogger.h" // MF_LOG_TRACE()
 
 // range library
-#include "range/v3/view/group_by.hpp"
+#include "range/v3/view/subrange.hpp"
+
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
 
 // C/C++ standard libraries
-#include <optional>
-#include <iterator> // std::next(), std::prev()
-#include <cmath> // std::round()
-#include <cstddef> // std::ptrdiff_t
+#include <algorithm> // std::clamp(), std::find_if()
+#include <iterator> // std::distance()
+#include <utility> // std::pair, std::move()
+#include <type_traits> // std::decay_t
+#include <limits>
+#include <cmath> // std::round(), std::lround()
+#include <cstddef> // std::size_t
+#include <cassert>
 
 
 //------------------------------------------------------------------------------
@@ -47,58 +56,98 @@ auto icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild
   (GateMgr&& gateManager, std::vector<WaveformWithBaseline> const& waveforms)
   const -> std::vector<TriggerGates>
 {
-  using GateManager_t = GateMgr;
+  using GateManager_t = std::decay_t<GateMgr>;
   using GateInfo_t = typename GateManager_t::GateInfo_t;
+  using WaveformIter_t = std::vector<WaveformWithBaseline>::const_iterator;
   
   /*
    * This is the simple algorithm where each channel is treated independently,
    * and we have as many trigger gates as we have channels.
+   * 
+   * The gates of all channels are created first, in channel order, so that
+   * the result does not depend on the order of processing; then each channel
+   * is processed as an independent task, only touching its own gates.
    */
   
   // create an empty TriggerGates object for each threshold;
   // thresholds are kept relative
   std::vector<TriggerGates> allGates = prepareAllGates();
   
-  raw::Channel_t channel = InvalidChannel;
-  
-  // now group the waveforms by channel (must be already sorted!)
-  // and process waveforms channel by channel
-  auto sameChannel
-    = [] (WaveformWithBaseline const& a, WaveformWithBaseline const& b)
-      { return a.waveform().ChannelNumber() == b.waveform().ChannelNumber(); }
-    ;
-  
-  auto byChannel = waveforms | ranges::views::group_by(sameChannel);
-  for (auto const& channelWaveforms: byChannel) {
+  //
+  // group the waveforms by channel (must be already sorted!)
+  //
+  std::vector<std::pair<WaveformIter_t, WaveformIter_t>> channelRanges;
+  for (auto itWaveform = waveforms.begin(); itWaveform != waveforms.end(); ) {
     
-    auto const& firstWaveform = channelWaveforms.front().waveform();
+    raw::Channel_t const channel = itWaveform->waveform().ChannelNumber();
     
-    // assert that the waveforms are sorted by channel and then by time
-    // and not overlapping
-    assert(
-      !isValidChannel(channel)
-      || (firstWaveform.ChannelNumber() >= channel)
+    // assert that the waveforms are sorted by channel
+    assert(channelRanges.empty()
+      || (channelRanges.back().first->waveform().ChannelNumber() < channel)
       );
-    if (firstWaveform.ChannelNumber() != channel)
-      channel = firstWaveform.ChannelNumber();
     
-    // we don't know how many... (maybe C++20 ranges will tell us)
-    MF_LOG_TRACE(details::TriggerGateDebugLog)
-      << "Building trigger gates from waveforms on channel " << channel;
+    auto const itNext = std::find_if(itWaveform, waveforms.end(),
+      [channel](WaveformWithBaseline const& waveform)
+        { return waveform.waveform().ChannelNumber() != channel; }
+      );
+    channelRanges.emplace_back(itWaveform, itNext);
+    itWaveform = itNext;
+    
+  } // for
+  
+  //
+  // create the gates of all the channels (this changes `allGates` structure)
+  //
+  for (auto const& channelRange: channelRanges) {
+    auto const& firstWaveform = channelRange.first->waveform();
+    for (TriggerGates& thrGates: allGates) thrGates.gateFor(firstWaveform);
+  }
+  
+  // now the gates do not move any more and we can keep pointers to them
+  std::vector<std::vector<GateInfo_t>> allChannelGates;
+  allChannelGates.reserve(channelRanges.size());
+  for (auto const& channelRange: channelRanges) {
+    
+    auto const& firstWaveform = channelRange.first->waveform();
     
     std::vector<GateInfo_t> channelGates;
     channelGates.reserve(nChannelThresholds());
     for (TriggerGates& thrGates: allGates) {
-      channelGates.push_back 
-        (gateManager.create(thrGates.gateFor(firstWaveform)));
+      // the gate was created (and its first waveform tracked) above
+      auto* const gate = thrGates.findGate(firstWaveform.ChannelNumber());
+      assert(gate);
+      channelGates.push_back(gateManager.create(*gate));
     }
-    
-    // this method will update the channel gates referenced in `channelGates`,
-    // which are owned by `allGates`
-    buildChannelGates(channelGates, channelWaveforms);
+    allChannelGates.push_back(std::move(channelGates));
     
   } // for channels
   
+  //
+  // process waveforms channel by channel
+  //
+  auto processChannel = [this,&channelRanges,&allChannelGates](std::size_t i)
+    {
+      auto const& [ begin, end ] = channelRanges[i];
+      
+      MF_LOG_TRACE(details::TriggerGateDebugLog)
+        << "Building trigger gates from " << std::distance(begin, end)
+        << " waveforms on channel " << begin->waveform().ChannelNumber();
+      
+      // this method will update the channel gates referenced in
+      // `allChannelGates[i]`, which are owned by `allGates`
+      buildChannelGates
+        (allChannelGates[i], ranges::make_subrange(begin, end));
+    };
+  
+  tbb::parallel_for(
+    tbb::blocked_range<std::size_t>{ 0U, channelRanges.size() },
+    [&processChannel](tbb::blocked_range<std::size_t> const& range)
+      {
+        for (std::size_t i = range.begin(); i != range.end(); ++i)
+          processChannel(i);
+      }
+    );
+  
   return allGates;
 } // icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild()
 
@@ -111,6 +160,7 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
 ) const
 {
   using ops = icarus::waveform_operations::NegativePolarityOperations<float>;
+  using CrossingFinder_t = icarus::opdet::ThresholdCrossingFinder<raw::ADC_Count_t>;
   
   if (channelWaveforms.empty()) return;
   
@@ -132,6 +182,11 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
    * For example, while a dynamic gate duration algorithm will perform open and
    * close operations directly, a fixed gate duration algorithm may perform
    * both opening and closing at open time, and nothing at all at closing time.
+   * 
+   * All the thresholds are translated into sample levels of the waveform
+   * (i.e. including the baseline), and the crossings of all of them are found
+   * in a single scan of the waveform. Since each gate reacts only to its own
+   * threshold, the crossings are then delivered gate by gate.
    */
   unsigned int nWaveforms = 0U;
   for (auto const& waveformData: channelWaveforms) {
@@ -140,15 +195,6 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
     
     ops const waveOps { waveformData.baseline().baseline() };
     
-    // baseline subtraction is performed in floating point,
-    // but then rounding is applied again
-    auto subtractBaseline = [waveOps](float sample) -> ADCCounts_t
-      {
-        return
-          ADCCounts_t::castFrom(std::round(waveOps.subtractBaseline(sample)));
-      };
-    
-    
     ++nWaveforms;
     assert(waveform.ChannelNumber() == channel);
     
@@ -168,145 +214,35 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
     assert(lastWaveformTick <= waveformTickStart);
     lastWaveformTick = waveformTickEnd;
     
-    auto const tbegin = channelThresholds().begin();
-    auto const tend = channelThresholds().end();
-    
     // register this waveform with the gates (this feature is unused here)
     for (auto& gateInfo: channelGates) gateInfo.addTrackingInfo(waveform);
     
-    // all gates start closed; this gate is not necessarily closed, but the
-    // waveform is not above the gate threshold any more.
-    auto nextGateToOpen = channelGates.begin();
+    // all gates start closed at the beginning of each waveform;
+    // thresholds that can't be reached are not even looked for
+    CrossingFinder_t const findCrossings
+      { thresholdSampleLevels(channelThresholds(), waveOps), -1 };
+    std::vector<icarus::opdet::ThresholdCrossings_t> const crossings
+      = findCrossings(waveform.data(), waveform.size());
     
-    // we keep track of whether we have no lower or higher thresholds available
-    // to simplify the checks;
-    // we name them "pp" because they behave (almost) like pointers to pointers
-    #if defined( __GNUC__ )
-    # pragma GCC diagnostic push
-    # if (__GNUC__ <= 9) // last tested with: GCC 9.3.0
-    #  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-    # else
-    #  error "Maintenance required here. See comments in the code"
-    /* [20210715 petrillo@slac.stanford.edu] The comments in the code:
-     * GCC 9.3.0 erroneously thinks that `ppXxxerThreshold` value _might_ be
-     * used before initialization. Due to the logic of the program, that is
-     * not the case (unless I am wrong!), and the only "solution" I have found
-     * is to disable the warning; Clang 7 on the other end does not complain.
-     * When GCC is updated and support for GCC 9 is dropped, this situation
-     * should be revisited by attempting the compilation with the warning
-     * still enabled (by just commenting out the #error directive).
-     * If compilation succeeds, this whole block and the `pop` directive below
-     * have become unnecessary and should be removed. Otherwise, the GCC version
-     * in the check above should be bumped up to cover the last tested GCC
-     * (here I went lazy and stuck to just the major version).
-     * I do not know which newer GCC version, if any, solves this issue so far.
-     */
-    # endif // GCC version
-    #endif // GCC
-    using ThresholdIterPtr_t
-      = std::optional<std::vector<ADCCounts_t>::const_iterator>;
-    // start at bottom with no lower threshold:
-    ThresholdIterPtr_t ppLowerThreshold = std::nullopt;
-    ThresholdIterPtr_t ppUpperThreshold = std::nullopt;
-    if (!channelThresholds().empty())
-      ppUpperThreshold = channelThresholds().begin(); // std::optional behavior
-    
-    for (auto iSample: util::counter<std::ptrdiff_t>(waveform.size())) {
-      
-      // baseline subtraction is always a subtraction (as in "A minus B"),
-      // regardless the polarity of the waveform
-      auto const sample = waveform[iSample];
-      ADCCounts_t const relSample = subtractBaseline(sample);
+    for (auto const& [ thrCrossings, gateInfo ]
+      : util::zip(crossings, channelGates)
+    ) {
       
-      /* // this is too much also for regular debugging...
-      MF_LOG_TRACE(details::TriggerGateDebugLog)
-        << "Sample #" << iSample << ": " << sample << " [=> " << relSample
-        << "]; thresholds lower: "
-          << (ppLowerThreshold? util::to_string(**ppLowerThreshold): "none")
-        << ", upper: "
-          << (ppUpperThreshold? util::to_string(**ppUpperThreshold): "none")
-        ;
-      */
+      auto const& openings = thrCrossings.opening;
+      auto const& closings = thrCrossings.closing;
       
-      //
-      // if this sample is lower than the current lower threshold,
-      // we are just tracking the thresholds: gate closing has already happened
-      //
-      if (ppLowerThreshold && (relSample < **ppLowerThreshold)) {
-        
-        MF_LOG_TRACE(details::TriggerGateDebugLog)
-          << "Sample " << sample << " (" << relSample << " on "
-          << waveOps.baseline() << ") leaving thresholds at "
-          << waveformTickStart << " + " << optical_time_ticks{ iSample };
-        
-        do { // we keep opening gates at increasing thresholds
-          
-          // if there is an lower threshold, there must also be a open gate!
-          assert(nextGateToOpen != channelGates.begin());
-          
-          
-          (--nextGateToOpen)->belowThresholdAt
-            (waveformTickStart + optical_time_ticks{ iSample });
-          
-          MF_LOG_TRACE(details::TriggerGateDebugLog)
-            << "  => decreasing threshold " << **ppLowerThreshold;
-          
-          if (*ppLowerThreshold == tbegin) { // was this the bottom threshold?
-            ppLowerThreshold = std::nullopt;
-            break;
-          }
-          --*ppLowerThreshold; // point to previous threshold
-          
-        } while (relSample < **ppLowerThreshold);
-        
-        // we can't be at the top since we just closed a gate
-        ppUpperThreshold
-          = ppLowerThreshold? std::next(*ppLowerThreshold): tbegin;
-        
-      } // if closing gate
+      // crossings alternate, starting with an opening
+      assert(closings.size() <= openings.size());
+      assert(closings.size() + 1 >= openings.size());
+      for (std::size_t iCross = 0; iCross < openings.size(); ++iCross) {
+        gateInfo.aboveThresholdAt
+          (waveformTickStart + optical_time_ticks::castFrom(openings[iCross]));
+        if (iCross >= closings.size()) break;
+        gateInfo.belowThresholdAt
+          (waveformTickStart + optical_time_ticks::castFrom(closings[iCross]));
+      } // for crossings
       
-      //
-      // if this sample is greater or matching the next threshold,
-      // we *are* opening gate(s)
-      //
-      else if (ppUpperThreshold && (relSample >= **ppUpperThreshold)) {
-        
-        MF_LOG_TRACE(details::TriggerGateDebugLog)
-          << "Sample " << sample << " (" << relSample << " on "
-          << waveOps.baseline() << ") passing thresholds at "
-          << waveformTickStart << " + " << optical_time_ticks{ iSample };
-        
-        do { // we keep opening gates at increasing thresholds
-          
-          // note that it is not guaranteed that gates at lower thresholds are
-          // still open (that depends on the builder implementation)
-          
-          // if there is an upper threshold, there must also be a closed gate!
-          assert(nextGateToOpen != channelGates.end());
-          
-          MF_LOG_TRACE(details::TriggerGateDebugLog)
-            << "Opening thr=" << (**ppUpperThreshold);
-          
-          (nextGateToOpen++)->aboveThresholdAt
-            (waveformTickStart + optical_time_ticks{ iSample });
-          
-          if (++*ppUpperThreshold == tend) { // was this the top threshold?
-            ppUpperThreshold = std::nullopt;
-            break;
-          }
-          
-        } while (relSample >= **ppUpperThreshold);
-        
-        // we can't be at the bottom since we just opened a gate
-        ppLowerThreshold = std::prev(ppUpperThreshold? *ppUpperThreshold: tend);
-        
-      } // if opening gate
-      
-    } // for threshold
-
-    #if defined( __GNUC__ )
-    # pragma GCC diagnostic pop
-    #endif // __clang__
+    } // for thresholds
     
   } // for waveforms
   
@@ -317,6 +253,50 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
 } // icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates()
 
 
+//------------------------------------------------------------------------------
+template <typename WaveformOps>
+std::vector<raw::ADC_Count_t>
+icarus::trigger::ManagedTriggerGateBuilder::thresholdSampleLevels
+  (std::vector<ADCCounts_t> const& thresholds, WaveformOps const& waveOps)
+{
+  using Sample_t = raw::ADC_Count_t;
+  using SampleLimits_t = std::numeric_limits<Sample_t>;
+  
+  // baseline subtraction is performed in floating point,
+  // but then rounding is applied again;
+  // a sample passes the threshold if its rounded value reaches it
+  auto passes = [&waveOps](Sample_t sample, ADCCounts_t threshold)
+    {
+      return ADCCounts_t::castFrom(std::round(waveOps.subtractBaseline(sample)))
+        >= threshold;
+    };
+  
+  // thresholds are sorted and the polarity is negative: the lowest sample
+  // value is the first to pass any threshold, and if it fails one threshold
+  // it fails all the higher ones too
+  std::vector<Sample_t> levels;
+  levels.reserve(thresholds.size());
+  for (ADCCounts_t const threshold: thresholds) {
+    
+    if (!passes(SampleLimits_t::min(), threshold)) break;
+    
+    // the level is the highest sample value that passes the threshold;
+    // start from the estimate and adjust it with the actual rounding
+    Sample_t level = static_cast<Sample_t>(std::clamp(
+      std::lround(waveOps.baseline() - threshold.value()),
+      long{ SampleLimits_t::min() }, long{ SampleLimits_t::max() }
+      ));
+    while (!passes(level, threshold)) --level;
+    while ((level < SampleLimits_t::max()) && passes(Sample_t(level + 1), threshold))
+      ++level;
+    
+    levels.push_back(level);
+  } // for
+  
+  return levels;
+} // icarus::trigger::ManagedTriggerGateBuilder::thresholdSampleLevels()
+
+
 //------------------------------------------------------------------------------
 
 #endif // ICARUSCODE_PMT_TRIGGER_ALGORITHMS_MANAGEDTRIGGERGATEBUILDER_TCC
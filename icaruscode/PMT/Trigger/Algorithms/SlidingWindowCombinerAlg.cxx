@@ -10,6 +10,10 @@
 // library header
 #include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowCombinerAlg.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 // C/C++ standard libraries
 #include <algorithm> // std::sort()
 #include <utility> // std::move()
@@ -35,18 +39,45 @@ auto icarus::trigger::SlidingWindowCombinerAlg::combine
   -> std::vector<TrackedTriggerGate_t>
 {
 
-  TriggerGateIndex_t gateIndex { gates };
-
-  checkInput(gateIndex);
-
-  std::vector<TrackedTriggerGate_t> combinedGates;
-  for (std::vector<raw::Channel_t> const& channels: fWindowChannels) {
-    assert(!channels.empty());
+  return std::move(combine
+    (std::vector<std::vector<TrackedTriggerGate_t> const*>{ &gates }).front());
+} // icarus::trigger::SlidingWindowCombinerAlg::combine()
 
-    combinedGates.push_back(combineChannels(gateIndex, channels));
 
+// -----------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowCombinerAlg::combine(
+  std::vector<std::vector<TrackedTriggerGate_t> const*> const& thresholdGates
+) const -> std::vector<std::vector<TrackedTriggerGate_t>> {
+
+  // indexing and checks are serial, so that errors are reported in order
+  std::vector<TriggerGateIndex_t> gateIndices;
+  gateIndices.reserve(thresholdGates.size());
+  for (std::vector<TrackedTriggerGate_t> const* gates: thresholdGates) {
+    assert(gates);
+    gateIndices.emplace_back(*gates);
+    checkInput(gateIndices.back());
   } // for
 
+  std::size_t const nWindows = fWindowChannels.size();
+  std::vector<std::vector<TrackedTriggerGate_t>> combinedGates
+    (thresholdGates.size(), std::vector<TrackedTriggerGate_t>(nWindows));
+
+  // each task fills only its own window of its own threshold
+  tbb::parallel_for(
+    tbb::blocked_range<std::size_t>{ 0U, thresholdGates.size() * nWindows },
+    [this,nWindows,&gateIndices,&combinedGates]
+      (tbb::blocked_range<std::size_t> const& range)
+      {
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+          std::size_t const iThr = i / nWindows;
+          std::size_t const iWindow = i % nWindows;
+          assert(!fWindowChannels[iWindow].empty());
+          combinedGates[iThr][iWindow]
+            = combineChannels(gateIndices[iThr], fWindowChannels[iWindow]);
+        } // for
+      }
+    );
+
   return combinedGates;
 } // icarus::trigger::SlidingWindowCombinerAlg::combine()
 
@@ -199,7 +230,10 @@ auto icarus::trigger::SlidingWindowCombinerAlg::firstChannelPresent
 {
   auto iChannel = channels.begin();
   auto const cend = channels.end();
-  while (iChannel != cend) if (!isMissingChannel(*iChannel)) return iChannel;
+  while (iChannel != cend) {
+    if (!isMissingChannel(*iChannel)) return iChannel;
+    ++iChannel;
+  }
   return cend;
 } // icarus::trigger::SlidingWindowCombinerAlg::firstChannelPresent()
 
@@ -62,9 +62,23 @@ class icarus::trigger::SlidingWindowCombinerAlg {
     );
 
   /// Combines the `gates` according to the configured grouping.
+  /// The windows are combined in parallel.
   std::vector<TrackedTriggerGate_t> combine
     (std::vector<TrackedTriggerGate_t> const& gates) const;
 
+  /**
+   * @brief Combines the gates of many thresholds at once.
+   * @param thresholdGates the input gates of each threshold
+   * @return the combined gates, as `[iThreshold][iWindow]`
+   * @see `combine(std::vector<TrackedTriggerGate_t> const&)`
+   *
+   * All the windows of all the thresholds are combined in parallel.
+   * The result is the same as calling `combine()` on each threshold in turn.
+   */
+  std::vector<std::vector<TrackedTriggerGate_t>> combine(
+    std::vector<std::vector<TrackedTriggerGate_t> const*> const& thresholdGates
+    ) const;
+
   /// Returns if `channel` is configured to be missing.
   bool isMissingChannel(raw::Channel_t channel) const;
 
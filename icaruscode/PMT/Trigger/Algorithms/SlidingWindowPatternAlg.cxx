@@ -24,12 +24,92 @@
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 // C/C++ standard libraries
-#include <algorithm> // std::binary_search()
+#include <algorithm> // std::binary_search(), std::minmax()
 #include <utility> // std::pair<>, std::move()
-#include <optional>
 #include <cassert>
 
 
+//------------------------------------------------------------------------------
+//--- icarus::trigger::SlidingWindowPatternAlg::WindowGateCache
+//------------------------------------------------------------------------------
+icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::WindowGateCache
+  (TriggerGates_t const& gates)
+{
+  fGates.reserve(gates.size());
+  for (InputTriggerGate_t const& gate: gates) fGates.push_back(&gateIn(gate));
+} // icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::WindowGateCache()
+
+
+//------------------------------------------------------------------------------
+icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::WindowGateCache
+  (TriggerGates_t&& gates)
+  : fOwnedGates(std::move(gates))
+{
+  fGates.reserve(fOwnedGates.size());
+  for (InputTriggerGate_t const& gate: fOwnedGates)
+    fGates.push_back(&gateIn(gate));
+} // icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::WindowGateCache()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::discriminated
+  (std::size_t iWindow, unsigned int minCount) -> TriggerGateData_t const&
+{
+  auto const key = std::make_pair(iWindow, minCount);
+  auto iGate = fDiscriminated.find(key);
+  if (iGate == fDiscriminated.end()) {
+    iGate = fDiscriminated.emplace
+      (key, discriminate(gate(iWindow), minCount)).first;
+  }
+  return iGate->second;
+} // icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::discriminated()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::mainPlusOpposite
+  (WindowTopology_t::WindowInfo_t const& windowInfo) -> TriggerGateData_t const&
+{
+  if (!windowInfo.hasOppositeWindow()) return gate(windowInfo.index);
+  
+  // the sum is the same for both windows of the pair
+  WindowPair_t const key = sumKey(windowInfo);
+  auto iGate = fSums.find(key);
+  if (iGate == fSums.end()) {
+    iGate = fSums.emplace
+      (key, sumGates(gate(windowInfo.index), gate(windowInfo.opposite))).first;
+  }
+  return iGate->second;
+} // icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::mainPlusOpposite()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::discriminatedMainPlusOpposite
+  (WindowTopology_t::WindowInfo_t const& windowInfo, unsigned int minCount)
+  -> TriggerGateData_t const&
+{
+  if (!windowInfo.hasOppositeWindow())
+    return discriminated(windowInfo.index, minCount);
+  
+  auto const key = std::make_pair(sumKey(windowInfo), minCount);
+  auto iGate = fDiscriminatedSums.find(key);
+  if (iGate == fDiscriminatedSums.end()) {
+    iGate = fDiscriminatedSums.emplace
+      (key, discriminate(mainPlusOpposite(windowInfo), minCount)).first;
+  }
+  return iGate->second;
+} // icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::discriminatedMainPlusOpposite()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::sumKey
+  (WindowTopology_t::WindowInfo_t const& windowInfo) -> WindowPair_t
+{
+  return std::minmax(windowInfo.index, windowInfo.opposite);
+} // icarus::trigger::SlidingWindowPatternAlg::WindowGateCache::sumKey()
+
+
+//------------------------------------------------------------------------------
+//--- icarus::trigger::SlidingWindowPatternAlg
 //------------------------------------------------------------------------------
 icarus::trigger::SlidingWindowPatternAlg::SlidingWindowPatternAlg(
   WindowTopology_t windowTopology,
@@ -60,11 +140,30 @@ icarus::trigger::SlidingWindowPatternAlg::SlidingWindowPatternAlg(
 auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
   (TriggerGates_t const& gates) const -> AllTriggerInfo_t
 {
-  
+  WindowGateCache gateCache = makeGateCache(gates);
+  return simulateResponse(gateCache);
+} // icarus::trigger::SlidingWindowPatternAlg::simulateResponse()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::makeGateCache
+  (TriggerGates_t const& gates) const -> WindowGateCache
+{
   // ensures input gates are in the same order as the configured windows
   verifyInputTopology(gates);
   
-  auto const& inBeamGates = fBeamGate? fBeamGate->applyToAll(gates): gates;
+  return fBeamGate
+    ? WindowGateCache{ fBeamGate->applyToAll(gates) }
+    : WindowGateCache{ gates }
+    ;
+} // icarus::trigger::SlidingWindowPatternAlg::makeGateCache()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
+  (WindowGateCache& gateCache) const -> AllTriggerInfo_t
+{
+  assert(gateCache.nWindows() == fWindowTopology.nWindows());
   
   //
   // 2.   apply pattern:
@@ -78,7 +177,7 @@ auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
   for (std::size_t const iWindow: util::counter(nWindows)) {
     
     TriggerInfo_t const windowResponse
-      = applyWindowPattern(fWindowPattern, iWindow, inBeamGates);
+      = applyWindowPattern(fWindowPattern, iWindow, gateCache);
     
     if (!windowResponse) continue;
     
@@ -208,20 +307,31 @@ auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
   TriggerGates_t const& gates
   ) const -> TriggerInfo_t
 {
+  WindowGateCache gateCache{ gates };
+  return applyWindowPattern(windowInfo, pattern, gateCache);
+} // icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
+  WindowTopology_t::WindowInfo_t const& windowInfo,
+  WindowPattern_t const& pattern,
+  WindowGateCache& gateCache
+  ) const -> TriggerInfo_t
+{
   
   /*
    * 1. check that the pattern can be applied; if not, return no trigger
    * 2. discriminate all the relevant gates against their required minimum count
    * 3. combine them in AND
    * 4. find the trigger time, fill the trigger information accordingly
+   * 
+   * All the gates of step 2 come from the cache, and are computed only the
+   * first time any window or pattern requests them.
    */
   TriggerInfo_t res; // no trigger by default
   assert(!res);
   
-  // undress the gate to get its data
-  auto const gateAt = [&gates](std::size_t index) -> TriggerGateData_t const&
-    { return gateIn(gates[index]); };
-  
   //
   // 1. check that the pattern can be applied; if not, return no trigger
   //
@@ -241,29 +351,20 @@ auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
   mfLogTrace()
     << "Window info #" << windowInfo.index << " pattern " << pattern.tag();
   
-  // we have two different "modes" depending on whether we are constraining
-  // the sum of main and opposite window, or not;
-  std::optional<TriggerGateData_t> const mainPlusOpposite
-    = (pattern.minSumInOppositeWindows > 0U)
-    ? std::optional{
-      windowInfo.hasOppositeWindow()
-        ? sumGates(gateAt(windowInfo.index), gateAt(windowInfo.opposite))
-        : gateAt(windowInfo.index)
-    }
-    : std::nullopt
-    ;
-  
   // the basic trigger primitive gate has the levels of the main or
-  // main+opposite window depending on the requirements
-  TriggerGateData_t trigPrimitive
-    = mainPlusOpposite? *mainPlusOpposite: gateAt(windowInfo.index);
+  // main+opposite window depending on whether we are constraining
+  // the sum of main and opposite window, or not
+  TriggerGateData_t trigPrimitive = (pattern.minSumInOppositeWindows > 0U)
+    ? gateCache.mainPlusOpposite(windowInfo)
+    : gateCache.gate(windowInfo.index)
+    ;
     
   mfLogTrace() << "  base: " << compactdump(trigPrimitive);
   
   // main window
   if (pattern.minInMainWindow > 0U) {
     trigPrimitive.Mul
-      (discriminate(gateAt(windowInfo.index), pattern.minInMainWindow));
+      (gateCache.discriminated(windowInfo.index, pattern.minInMainWindow));
     mfLogTrace()
       << "  main >= " << pattern.minInMainWindow << ": "
       << compactdump(trigPrimitive);
@@ -271,36 +372,34 @@ auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
   
   // add opposite window requirement (if any)
   if ((pattern.minInOppositeWindow > 0U) && windowInfo.hasOppositeWindow()) {
-    trigPrimitive.Mul
-      (discriminate(gateAt(windowInfo.opposite), pattern.minInOppositeWindow));
+    trigPrimitive.Mul(gateCache.discriminated
+      (windowInfo.opposite, pattern.minInOppositeWindow));
     mfLogTrace() << "  opposite [#" << windowInfo.opposite << "]: "
-      << compactdump(gateAt(windowInfo.opposite))
+      << compactdump(gateCache.gate(windowInfo.opposite))
       << "\n  => " << compactdump(trigPrimitive);
   } // if
   
   // add main plus opposite window requirement (if any)
   if (pattern.minSumInOppositeWindows > 0U) {
-    assert(mainPlusOpposite.has_value());
-    trigPrimitive.Mul
-      (discriminate(*mainPlusOpposite, pattern.minSumInOppositeWindows));
+    trigPrimitive.Mul(gateCache.discriminatedMainPlusOpposite
+      (windowInfo, pattern.minSumInOppositeWindows));
     mfLogTrace() << "  sum [+ #" << windowInfo.opposite << "]: "
-      << compactdump(*mainPlusOpposite)
+      << compactdump(gateCache.mainPlusOpposite(windowInfo))
       << "\n  => " << compactdump(trigPrimitive);
     
   } // if
   
   // add upstream window requirement (if any)
   if ((pattern.minInUpstreamWindow > 0U) && windowInfo.hasUpstreamWindow()) {
-    trigPrimitive.Mul
-      (discriminate(gateAt(windowInfo.upstream), pattern.minInUpstreamWindow));
+    trigPrimitive.Mul(gateCache.discriminated
+      (windowInfo.upstream, pattern.minInUpstreamWindow));
   } // if
   
   // add downstream window requirement (if any)
   if ((pattern.minInDownstreamWindow > 0U) && windowInfo.hasDownstreamWindow())
   {
-    trigPrimitive.Mul(
-      discriminate(gateAt(windowInfo.downstream), pattern.minInDownstreamWindow)
-      );
+    trigPrimitive.Mul(gateCache.discriminated
+      (windowInfo.downstream, pattern.minInDownstreamWindow));
   } // if
   
   mfLogTrace() << "  final: " << compactdump(trigPrimitive);
@@ -328,14 +427,14 @@ auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
 auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
   WindowPattern_t const& pattern,
   std::size_t iWindow,
-  TriggerGates_t const& gates
+  WindowGateCache& gateCache
   ) const -> TriggerInfo_t
 {
   WindowTopology_t::WindowInfo_t const& windowInfo
     = fWindowTopology.info(iWindow);
   assert(windowInfo.index == iWindow);
   
-  return applyWindowPattern(windowInfo, pattern, gates);
+  return applyWindowPattern(windowInfo, pattern, gateCache);
 } // icarus::trigger::SlidingWindowTriggerEfficiencyPlots::applyWindowPattern()
 
 
@@ -24,6 +24,8 @@
 
 // C/C++ standard libraries
 #include <vector>
+#include <map>
+#include <utility> // std::pair
 #include <optional>
 #include <string>
 #include <limits> // std::numeric_limits<>
@@ -47,6 +49,18 @@ namespace icarus::trigger { class SlidingWindowPatternAlg; }
  * 
  * For the definition of the windows, see `icarus::trigger::WindowChannelMap`.
  * 
+ * The combinations of gates needed to evaluate a pattern on a window (window
+ * gates discriminated against a minimum count, sum of a window with its
+ * opposite) are computed once and kept in a `WindowGateCache` object, and
+ * shared among all the windows. When many patterns are evaluated on the same
+ * gates, the same cache can be shared by all of them too:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * auto gateCache = patternAlgs.front().makeGateCache(gates);
+ * for (icarus::trigger::SlidingWindowPatternAlg const& patternAlg: patternAlgs)
+ *   responses.push_back(patternAlg.simulateResponse(gateCache));
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * as long as all the algorithms share the same window topology and beam gate.
+ * 
  */
 class icarus::trigger::SlidingWindowPatternAlg
   : public icarus::ns::util::mfLoggingClass
@@ -91,6 +105,84 @@ class icarus::trigger::SlidingWindowPatternAlg
     bool operator!() const { return !info.fired(); }
   }; // AllTriggerInfo_t
   
+  
+  /**
+   * @brief Window gates and their combinations, computed on demand and kept.
+   * 
+   * The gate combinations that patterns require are computed the first time
+   * they are requested and then reused by all the windows and patterns which
+   * are evaluated with the same cache:
+   * 
+   * * `discriminated()`: a window gate discriminated against a minimum count;
+   * * `mainPlusOpposite()`: the sum of a window and its opposite window;
+   * * `discriminatedMainPlusOpposite()`: the same, discriminated.
+   * 
+   * Unless the cache is created from a temporary collection of gates, it refers
+   * to them, and they must stay valid as long as the cache is used.
+   * Since the cache is filled on demand, it can't be shared among threads.
+   */
+  class WindowGateCache {
+    
+      public:
+    
+    /// Constructor: refers to the `gates`, one per window.
+    explicit WindowGateCache(TriggerGates_t const& gates);
+    
+    /// Constructor: acquires and uses the `gates`, one per window.
+    explicit WindowGateCache(TriggerGates_t&& gates);
+    
+    // copies would point to the gates of the original object
+    WindowGateCache(WindowGateCache const&) = delete;
+    WindowGateCache(WindowGateCache&&) = default;
+    WindowGateCache& operator= (WindowGateCache const&) = delete;
+    WindowGateCache& operator= (WindowGateCache&&) = default;
+    
+    /// Returns the number of windows (gates).
+    std::size_t nWindows() const { return fGates.size(); }
+    
+    /// Returns the gate of the window `iWindow`.
+    TriggerGateData_t const& gate(std::size_t iWindow) const
+      { return *(fGates[iWindow]); }
+    
+    /// Returns the gate of window `iWindow` discriminated with `minCount`.
+    TriggerGateData_t const& discriminated
+      (std::size_t iWindow, unsigned int minCount);
+    
+    /// Returns the sum of the gates of the window and its opposite (if any).
+    TriggerGateData_t const& mainPlusOpposite
+      (WindowTopology_t::WindowInfo_t const& windowInfo);
+    
+    /// Returns `mainPlusOpposite(windowInfo)` discriminated with `minCount`.
+    TriggerGateData_t const& discriminatedMainPlusOpposite
+      (WindowTopology_t::WindowInfo_t const& windowInfo, unsigned int minCount);
+    
+      private:
+    
+    using WindowPair_t = std::pair<std::size_t, std::size_t>;
+    
+    TriggerGates_t fOwnedGates; ///< Storage for acquired gates.
+    
+    /// Gate data of each window.
+    std::vector<TriggerGateData_t const*> fGates;
+    
+    /// Discriminated window gates, by window and minimum count.
+    std::map<std::pair<std::size_t, unsigned int>, TriggerGateData_t>
+      fDiscriminated;
+    
+    /// Sums of opposite windows, by window pair (lower index first).
+    std::map<WindowPair_t, TriggerGateData_t> fSums;
+    
+    /// Discriminated sums of opposite windows, by window pair and count.
+    std::map<std::pair<WindowPair_t, unsigned int>, TriggerGateData_t>
+      fDiscriminatedSums;
+    
+    /// Returns the key of the window pair for the `windowInfo`.
+    static WindowPair_t sumKey
+      (WindowTopology_t::WindowInfo_t const& windowInfo);
+    
+  }; // class WindowGateCache
+  
+  
   /**
    * @brief Constructor: configures window topology and times.
    * @param windowTopology full composition and topology description of windows
@@ -151,6 +243,31 @@ class icarus::trigger::SlidingWindowPatternAlg
    */
   AllTriggerInfo_t simulateResponse(TriggerGates_t const& gates) const;
   
+  /**
+   * @brief Returns the trigger response from the gates in `gateCache`.
+   * @param gateCache the cache of gates, created by `makeGateCache()`
+   * @return the response to the configured pattern
+   * @see `simulateResponse(TriggerGates_t const&)`, `makeGateCache()`
+   * 
+   * The cache may have been created by a different algorithm object, as long
+   * as it shares the same window topology and beam gate as this one.
+   * The combinations of gates computed for this pattern are added to the cache
+   * and are available to the next patterns.
+   */
+  AllTriggerInfo_t simulateResponse(WindowGateCache& gateCache) const;
+  
+  /**
+   * @brief Returns a gate cache for the simulation of responses to `gates`.
+   * @param gates the trigger gates to be used as input, one per window
+   * @return a cache for `simulateResponse(WindowGateCache&)`
+   * @throw cet::exception if `gates` do not match the window topology
+   * 
+   * The beam gate, if any, is applied to the gates in the cache.
+   * If not, the cache refers to `gates`, which must stay valid as long as the
+   * cache is in use.
+   */
+  WindowGateCache makeGateCache(TriggerGates_t const& gates) const;
+  
 
   /// Returns a new collection of gates, set each in coincidence with beam gate.
   TriggerGates_t applyBeamGate(TriggerGates_t const& gates) const;
@@ -194,6 +311,20 @@ class icarus::trigger::SlidingWindowPatternAlg
     TriggerGates_t const& gates
     ) const;
   
+  /**
+   * @brief Returns the trigger response for the specified window pattern.
+   * @param windowInfo the topology of the windows
+   * @param pattern the trigger requirement pattern
+   * @param gateCache trigger gates, one per window, and their combinations
+   * @return a `TriggerInfo_t` record with the response of the pattern
+   * @see `applyWindowPattern(WindowChannelMap::WindowInfo const&, WindowPattern_t const&, TriggerGates_t const&)`
+   */
+  TriggerInfo_t applyWindowPattern(
+    WindowTopology_t::WindowInfo_t const& windowInfo,
+    WindowPattern_t const& pattern,
+    WindowGateCache& gateCache
+    ) const;
+  
   
     private:
   
@@ -239,7 +370,7 @@ class icarus::trigger::SlidingWindowPatternAlg
    */
   TriggerInfo_t applyWindowPattern(
     WindowPattern_t const& pattern, std::size_t iWindow,
-    TriggerGates_t const& gates
+    WindowGateCache& gateCache
     ) const;
   
   /**
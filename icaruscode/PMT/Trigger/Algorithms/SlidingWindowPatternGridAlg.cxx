@@ -0,0 +1,45 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.cxx
+ * @brief  Applies many sliding window trigger patterns at once.
+ * @date   October 19, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.h
+ */
+
+
+// library header
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.h"
+
+
+//------------------------------------------------------------------------------
+icarus::trigger::SlidingWindowPatternGridAlg::SlidingWindowPatternGridAlg(
+  WindowTopology_t const& windowTopology,
+  std::vector<WindowPattern_t> const& windowPatterns,
+  std::string const& logCategory /* = "SlidingWindowPatternGridAlg" */
+) {
+  fPatternAlgs.reserve(windowPatterns.size());
+  for (WindowPattern_t const& pattern: windowPatterns)
+    fPatternAlgs.emplace_back(windowTopology, pattern, logCategory);
+} // icarus::trigger::SlidingWindowPatternGridAlg::SlidingWindowPatternGridAlg()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternGridAlg::simulateResponses
+  (TriggerGates_t const& gates) const -> PatternResponses_t
+{
+  PatternResponses_t responses;
+  if (fPatternAlgs.empty()) return responses;
+  
+  // all the pattern algorithms share the topology and have no beam gate,
+  // so the cache from any of them serves all
+  PatternAlg_t::WindowGateCache gateCache
+    = fPatternAlgs.front().makeGateCache(gates);
+  
+  responses.reserve(fPatternAlgs.size());
+  for (PatternAlg_t const& patternAlg: fPatternAlgs)
+    responses.push_back(patternAlg.simulateResponse(gateCache));
+  
+  return responses;
+} // icarus::trigger::SlidingWindowPatternGridAlg::simulateResponses()
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.h
+ * @brief  Applies many sliding window trigger patterns at once.
+ * @date   October 19, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.cxx
+ */
+
+#ifndef ICARUSCODE_PMT_TRIGGER_ALGORITHMS_SLIDINGWINDOWPATTERNGRIDALG_H
+#define ICARUSCODE_PMT_TRIGGER_ALGORITHMS_SLIDINGWINDOWPATTERNGRIDALG_H
+
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::trigger { class SlidingWindowPatternGridAlg; }
+/**
+ * @brief Applies a list of sliding window patterns to the same trigger gates.
+ * @see `icarus::trigger::SlidingWindowPatternAlg`
+ * 
+ * This algorithm evaluates the response of many window patterns on the same
+ * input gates (one per window).
+ * The window gate combinations needed by the patterns are computed once and
+ * shared by all of them
+ * (see `icarus::trigger::SlidingWindowPatternAlg::WindowGateCache`).
+ * 
+ * All patterns share the same window topology, and no beam gate is applied:
+ * the input gates are expected to be already in coincidence with it.
+ * The responses are the same as the ones of a
+ * `icarus::trigger::SlidingWindowPatternAlg` configured with each pattern in
+ * turn.
+ */
+class icarus::trigger::SlidingWindowPatternGridAlg {
+  
+    public:
+  
+  /// Type of the algorithm evaluating a single pattern.
+  using PatternAlg_t = icarus::trigger::SlidingWindowPatternAlg;
+  
+  /// A list of trigger gates from input.
+  using TriggerGates_t = PatternAlg_t::TriggerGates_t;
+  
+  /// Complete information of the response to a single pattern.
+  using AllTriggerInfo_t = PatternAlg_t::AllTriggerInfo_t;
+  
+  /// Type holding information about composition and topology of all windows.
+  using WindowTopology_t = PatternAlg_t::WindowTopology_t;
+  
+  /// Type representing the requirement pattern for a window.
+  using WindowPattern_t = PatternAlg_t::WindowPattern_t;
+  
+  /// Responses to all the patterns, by pattern index.
+  using PatternResponses_t = std::vector<AllTriggerInfo_t>;
+  
+  
+  /**
+   * @brief Constructor: configures window topology and patterns.
+   * @param windowTopology full composition and topology description of windows
+   * @param windowPatterns the patterns that this algorithm applies
+   * @param logCategory category tag for algorithm messages on screen
+   */
+  SlidingWindowPatternGridAlg(
+    WindowTopology_t const& windowTopology,
+    std::vector<WindowPattern_t> const& windowPatterns,
+    std::string const& logCategory = "SlidingWindowPatternGridAlg"
+    );
+  
+  /// Returns the number of configured patterns.
+  std::size_t nPatterns() const { return fPatternAlgs.size(); }
+  
+  /// Returns the algorithm applying the pattern with index `iPattern`.
+  PatternAlg_t const& patternAlg(std::size_t iPattern) const
+    { return fPatternAlgs.at(iPattern); }
+  
+  
+  /**
+   * @brief Returns the response of all patterns to the `gates`.
+   * @param gates the trigger gates to be used as input, one per window
+   * @return the response to each pattern, in configuration order
+   * @throw cet::exception if `gates` do not match the window topology
+   * 
+   * No beam gate is applied to `gates`.
+   */
+  PatternResponses_t simulateResponses(TriggerGates_t const& gates) const;
+  
+  
+    private:
+  
+  /// One algorithm per pattern.
+  std::vector<PatternAlg_t> fPatternAlgs;
+  
+}; // class icarus::trigger::SlidingWindowPatternGridAlg
+
+
+//------------------------------------------------------------------------------
+
+#endif // ICARUSCODE_PMT_TRIGGER_ALGORITHMS_SLIDINGWINDOWPATTERNGRIDALG_H
@@ -123,6 +123,17 @@ auto icarus::trigger::TriggerGateBuilder::TriggerGates::gateFor
 } // icarus::trigger::TriggerGateBuilder::TriggerGates::gateFor()
 
 
+//------------------------------------------------------------------------------
+auto icarus::trigger::TriggerGateBuilder::TriggerGates::findGate
+  (raw::Channel_t channel) -> triggergate_t*
+{
+  auto const iGate = std::lower_bound
+    (fGates.begin(), fGates.end(), channel, ::ChannelComparison<>());
+  return ((iGate == fGates.end()) || (iGate->gate().channel() != channel))
+    ? nullptr: &*iGate;
+} // icarus::trigger::TriggerGateBuilder::TriggerGates::findGate()
+
+
 //------------------------------------------------------------------------------
 //--- icarus::trigger::TriggerGateBuilder
 //------------------------------------------------------------------------------
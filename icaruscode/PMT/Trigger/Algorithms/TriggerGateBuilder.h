@@ -151,6 +151,9 @@ class icarus::trigger::TriggerGateBuilder {
     /// Returns (and creates, if necessary) the gate for the specified waveform.
     triggergate_t& gateFor(raw::OpDetWaveform const& waveform);
     
+    /// Returns the gate of `channel` (`nullptr` if none), with no tracking.
+    triggergate_t* findGate(raw::Channel_t channel);
+    
     /// Dumps the content of this set of gates into the `out` stream.
     template <typename Stream>
     void dump(Stream& out) const;
@@ -9,6 +9,14 @@
 // library header
 #include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
 
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <charconv> // std::from_chars()
+#include <system_error> // std::errc
+#include <cctype> // std::isdigit()
+
 
 //------------------------------------------------------------------------------
 bool icarus::trigger::WindowPattern::isMainRequirementRelevant() const {
@@ -106,4 +114,80 @@ std::string icarus::trigger::WindowPattern::description() const {
 } // icarus::trigger::WindowPattern::description()
 
 
+//------------------------------------------------------------------------------
+icarus::trigger::WindowPattern icarus::trigger::makeWindowPattern
+  (std::string const& tag)
+{
+  WindowPattern pattern;
+  pattern.minInMainWindow = 0U;
+  
+  std::string seen;
+  std::size_t pos = 0U;
+  while (pos < tag.length()) {
+    char const letter = tag[pos++];
+    
+    if (seen.find(letter) != std::string::npos) {
+      throw cet::exception("WindowPattern")
+        << "Requirement '" << letter << "' repeated in pattern tag '"
+        << tag << "'.\n";
+    }
+    seen += letter;
+    
+    std::size_t const valueStart = pos;
+    while
+      ((pos < tag.length()) && std::isdigit(static_cast<unsigned char>(tag[pos])))
+      ++pos;
+    if (pos == valueStart) {
+      throw cet::exception("WindowPattern")
+        << "Requirement '" << letter << "' has no value in pattern tag '"
+        << tag << "'.\n";
+    }
+    unsigned int value = 0U;
+    auto const [ valueEnd, error ] = std::from_chars
+      (tag.data() + valueStart, tag.data() + pos, value);
+    if ((error != std::errc{}) || (valueEnd != tag.data() + pos)) {
+      throw cet::exception("WindowPattern")
+        << "Requirement '" << letter << "' has an invalid value ('"
+        << tag.substr(valueStart, pos - valueStart) << "') in pattern tag '"
+        << tag << "'.\n";
+    }
+    
+    bool const required = (tag.compare(pos, 3U, "req") == 0);
+    if (required) pos += 3U;
+    
+    switch (letter) {
+      case 'M': pattern.minInMainWindow = value; break;
+      case 'O': pattern.minInOppositeWindow = value; break;
+      case 'S': pattern.minSumInOppositeWindows = value; break;
+      case 'D':
+        pattern.minInDownstreamWindow = value;
+        pattern.requireDownstreamWindow = required;
+        break;
+      case 'U':
+        pattern.minInUpstreamWindow = value;
+        pattern.requireUpstreamWindow = required;
+        break;
+      default:
+        throw cet::exception("WindowPattern")
+          << "Unknown requirement '" << letter << "' in pattern tag '"
+          << tag << "'.\n";
+    } // switch
+    
+    if (required && (letter != 'D') && (letter != 'U')) {
+      throw cet::exception("WindowPattern")
+        << "Requirement '" << letter << "' can't be mandatory (pattern tag '"
+        << tag << "').\n";
+    }
+    
+  } // while
+  
+  if (seen.empty()) {
+    throw cet::exception("WindowPattern")
+      << "Empty pattern tag.\n";
+  }
+  
+  return pattern;
+} // icarus::trigger::makeWindowPattern()
+
+
 //------------------------------------------------------------------------------
@@ -27,6 +27,17 @@ namespace icarus::trigger {
   //----------------------------------------------------------------------------
   std::string to_string(WindowPattern const& pattern);
 
+  /**
+   * @brief Returns the pattern described by the specified `tag`.
+   * @param tag the tag of the pattern, in the format of `WindowPattern::tag()`
+   * @return the pattern described by `tag`
+   * @throw cet::exception (category: `"WindowPattern"`) if `tag` is malformed
+   *
+   * This is the inverse of `WindowPattern::tag()`: requirements not present
+   * in the tag are set to `0`.
+   */
+  WindowPattern makeWindowPattern(std::string const& tag);
+
   //----------------------------------------------------------------------------
 
 } // namespace icarus::trigger
@@ -39,6 +39,10 @@
 #include "fhiclcpp/types/Sequence.h"
 #include "cetlib_except/exception.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 
 // C/C++ standard libraries
 #include <map>
@@ -306,14 +310,29 @@ class icarus::trigger::LVDSgates: public art::EDProducer {
   // --- END Configuration variables -------------------------------------------
   
   
-  /// Completely processes the data for the specified threshold.
-  void produceThreshold(
-    art::Event& event,
+  /// Reads and checks the input gates for the specified threshold.
+  std::vector<TrackedTriggerGate_t> readThreshold(
+    art::Event const& event,
     icarus::trigger::OpDetWaveformMetaDataProductMap_t& waveformMap,
     std::string const& thresholdStr,
     SourceInfo_t const& srcInfo
     ) const;
 
+  /// Combines the channels of all the thresholds, as `[iThreshold][iGroup]`.
+  std::vector<std::vector<TrackedTriggerGate_t>> combineThresholds
+    (std::vector<std::vector<TrackedTriggerGate_t>> const& thresholdGates)
+    const;
+
+  /// Stores into `event` the `combinedGates` for the specified threshold.
+  void putThreshold(
+    art::Event& event,
+    icarus::trigger::OpDetWaveformMetaDataProductMap_t const& waveformMap,
+    std::string const& thresholdStr,
+    SourceInfo_t const& srcInfo,
+    std::size_t nInputGates,
+    std::vector<TrackedTriggerGate_t> combinedGates
+    ) const;
+
   /**
    * @brief Removes all the channel in `ignoreChannels` from `channelPairing`.
    * @return a copy of `channelPairing` with no element from `ignoreChannels`
@@ -470,10 +489,25 @@ void icarus::trigger::LVDSgates::produce(art::Event& event) {
   
   icarus::trigger::OpDetWaveformMetaDataProductMap_t waveformMap;
   
+  // reading is serial, since it also fills the waveform map
+  std::vector<std::vector<TrackedTriggerGate_t>> thresholdGates;
   for (auto const& [ thresholdStr, srcInfo ]: fADCthresholds) {
-    
-    produceThreshold(event, waveformMap, thresholdStr, srcInfo);
-    
+    thresholdGates.push_back
+      (readThreshold(event, waveformMap, thresholdStr, srcInfo));
+  } // for all thresholds
+  
+  // all thresholds and channel groups are combined together
+  std::vector<std::vector<TrackedTriggerGate_t>> combinedGates
+    = combineThresholds(thresholdGates);
+  
+  // output is serial and in threshold order
+  std::size_t iThr = 0U;
+  for (auto const& [ thresholdStr, srcInfo ]: fADCthresholds) {
+    putThreshold(
+      event, waveformMap, thresholdStr, srcInfo,
+      thresholdGates[iThr].size(), std::move(combinedGates[iThr])
+      );
+    ++iThr;
   } // for all thresholds
   
 } // icarus::trigger::LVDSgates::produce()
@@ -482,39 +516,78 @@ void icarus::trigger::LVDSgates::produce(art::Event& event) {
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-void icarus::trigger::LVDSgates::produceThreshold(
-  art::Event& event,
+auto icarus::trigger::LVDSgates::readThreshold(
+  art::Event const& event,
   icarus::trigger::OpDetWaveformMetaDataProductMap_t& waveformMap,
   std::string const& thresholdStr,
   SourceInfo_t const& srcInfo
-) const {
+) const -> std::vector<TrackedTriggerGate_t> {
   
-  auto const& [ dataTag, outputInstanceName ] = srcInfo;
+  art::InputTag const& dataTag = srcInfo.inputTag;
   
   mf::LogDebug(fLogCategory)
     << "Processing threshold " << thresholdStr
     << " from '" << dataTag.encode() << "'";
   
-  using icarus::trigger::OpticalTriggerGateData_t; // for convenience
-  
-  std::vector<TrackedTriggerGate_t> const& gates
+  std::vector<TrackedTriggerGate_t> gates
     = ReadTriggerGates(event, dataTag, waveformMap);
 
   checkInput(gates);
   
-  std::vector<TrackedTriggerGate_t> combinedGates;
+  return gates;
+} // icarus::trigger::LVDSgates::readThreshold()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::LVDSgates::combineThresholds
+  (std::vector<std::vector<TrackedTriggerGate_t>> const& thresholdGates) const
+  -> std::vector<std::vector<TrackedTriggerGate_t>>
+{
+  
+  // empty channel groups produce no gate
+  std::vector<std::vector<raw::Channel_t>> pairings;
+  for (auto& pairing: removeChannels(fChannelPairing, fIgnoreChannels))
+    if (!pairing.empty()) pairings.push_back(std::move(pairing));
+  
+  std::size_t const nPairings = pairings.size();
+  std::vector<std::vector<TrackedTriggerGate_t>> combinedGates
+    (thresholdGates.size(), std::vector<TrackedTriggerGate_t>(nPairings));
+  
+  // each task fills only its own gate, so the result is in the same order
+  // as if it were computed serially
+  tbb::parallel_for(
+    tbb::blocked_range<std::size_t>{ 0U, thresholdGates.size() * nPairings },
+    [this,nPairings,&pairings,&thresholdGates,&combinedGates]
+      (tbb::blocked_range<std::size_t> const& range)
+      {
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+          std::size_t const iThr = i / nPairings;
+          std::size_t const iPairing = i % nPairings;
+          combinedGates[iThr][iPairing] = combineChannels
+            (thresholdGates[iThr], pairings[iPairing], fComboMode);
+        } // for
+      }
+    );
   
-  std::vector<std::vector<raw::Channel_t>> const cleanedChannels
-    = removeChannels(fChannelPairing, fIgnoreChannels);
+  return combinedGates;
+} // icarus::trigger::LVDSgates::combineThresholds()
 
-  for (std::vector<raw::Channel_t> const& pairing: cleanedChannels) {
-    if (pairing.empty()) continue; // ???
-    
-    combinedGates.push_back(combineChannels(gates, pairing, fComboMode));
-    
-  } // for
+
+//------------------------------------------------------------------------------
+void icarus::trigger::LVDSgates::putThreshold(
+  art::Event& event,
+  icarus::trigger::OpDetWaveformMetaDataProductMap_t const& waveformMap,
+  std::string const& thresholdStr,
+  SourceInfo_t const& srcInfo,
+  std::size_t nInputGates,
+  std::vector<TrackedTriggerGate_t> combinedGates
+) const {
+  
+  auto const& [ dataTag, outputInstanceName ] = srcInfo;
+  
+  using icarus::trigger::OpticalTriggerGateData_t; // for convenience
   
-  // transform the data; after this line, `gates` is not usable any more
+  // transform the data; after this line, `combinedGates` is not usable any more
   art::PtrMaker<OpticalTriggerGateData_t> const makeGatePtr
     (event, outputInstanceName);
   auto [ outputGates, outputAssns ]
@@ -523,7 +596,7 @@ void icarus::trigger::LVDSgates::produceThreshold(
   
   mf::LogTrace(fLogCategory)
     << "Threshold " << thresholdStr << " ('" << dataTag.encode() << "'): "
-    << gates.size() << " input channels, "
+    << nInputGates << " input channels, "
     << outputGates.size() << " output channels (+"
     << outputAssns.size() << " associations to waveforms) into '"
     << moduleDescription().moduleLabel() << ":" << outputInstanceName << "'"
@@ -558,7 +631,7 @@ void icarus::trigger::LVDSgates::produceThreshold(
     outputInstanceName
     );
   
-} // icarus::trigger::LVDSgates::produceThreshold()
+} // icarus::trigger::LVDSgates::putThreshold()
 
 
 //------------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 // ICARUS libraries
 #include "icaruscode/PMT/Trigger/TriggerEfficiencyPlotsBase.h"
 #include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.h"
 #include "icaruscode/PMT/Trigger/Algorithms/WindowTopologyAlg.h" // WindowTopologyManager
 #include "icaruscode/PMT/Trigger/Algorithms/WindowPatternConfig.h"
 #include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
@@ -48,6 +49,7 @@
 #include <vector>
 #include <array>
 #include <memory> // std::unique_ptr
+#include <optional>
 #include <utility> // std::pair<>, std::move()
 #include <limits> // std::numeric_limits<>
 #include <type_traits> // std::is_pointer_v, ...
@@ -399,8 +401,8 @@ class icarus::trigger::SlidingWindowTriggerEfficiencyPlots
   // mutable = not thread-safe; optional to allow delayed construction
   mutable icarus::trigger::WindowTopologyManager fWindowMapMan;
   
-  /// All algorithm instances, one per pattern.
-  std::vector<icarus::trigger::SlidingWindowPatternAlg> fPatternAlgs;
+  /// Algorithm applying all the patterns.
+  std::optional<icarus::trigger::SlidingWindowPatternGridAlg> fPatternAlgs;
   
   std::unique_ptr<ResponseTree> fResponseTree; ///< Handler of ROOT tree output.
   
@@ -783,12 +785,16 @@ void icarus::trigger::SlidingWindowTriggerEfficiencyPlots::simulateAndPlot(
   //
   // 2. for each pattern:
   //
+  // the responses of all patterns are evaluated together
+  // (the beam gate is already applied)
+  assert(fPatternAlgs);
+  std::vector<WindowTriggerInfo_t> const responses
+    = fPatternAlgs->simulateResponses(inBeamGates);
+  assert(responses.size() == fPatterns.size());
+  
   for (auto const& [ iPattern, pattern ]: util::enumerate(fPatterns)) {
 
-    auto& patternAlg = fPatternAlgs[iPattern];
-    
-    WindowTriggerInfo_t const triggerInfo
-      = patternAlg.simulateResponse(inBeamGates);
+    WindowTriggerInfo_t const& triggerInfo = responses[iPattern];
     
     registerTriggerResult(thresholdIndex, iPattern, triggerInfo.info);
 
@@ -819,9 +825,7 @@ void
 icarus::trigger::SlidingWindowTriggerEfficiencyPlots::initializePatternAlgorithms
   ()
 {
-  fPatternAlgs.clear();
-  for (auto const& pattern: fPatterns)
-    fPatternAlgs.emplace_back(*fWindowMapMan, pattern, helper().logCategory());
+  fPatternAlgs.emplace(*fWindowMapMan, fPatterns, helper().logCategory());
 } // icarus::trigger::SlidingWindowTriggerEfficiencyPlots::initializePatternAlgorithms()
 
 
@@ -8,6 +8,7 @@
 
 // ICARUS libraries
 #include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h"
 #include "icaruscode/PMT/Trigger/Algorithms/WindowTopologyAlg.h" // WindowTopologyManager
 #include "icaruscode/PMT/Trigger/Algorithms/WindowPatternConfig.h"
 #include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
@@ -66,6 +67,7 @@
 #include "TH1F.h"
 #include "TH2F.h"
 #include "TGraph.h"
+#include "TTree.h"
 
 // C/C++ standard libraries
 #include <ostream>
@@ -156,6 +158,12 @@ namespace icarus::trigger { class SlidingWindowTriggerSimulation; }
  *     the actual beam gate opens at;
  * * `BeamBits` (bitmask as 32-bit integral number): bits to be set in the
  *     produced `raw::Trigger` objects (see also `daq::TriggerDecoder` tool).
+ * * `ReplayStore` (string, optional): if specified, the window gates of each
+ *     event, already in coincidence with the beam gate, are also written in a
+ *     gate replay store (`icarus::trigger::GateReplayStoreWriter`) in the
+ *     `TFileService` directory of the module, one store per threshold; the
+ *     name of each store is this parameter value followed by the threshold
+ *     tag (see also `replayTriggerPatterns` executable).
  * * `LogCategory` (string, default `SlidingWindowTriggerSimulation`): name of
  *     category used to stream messages from this module into message facility.
  * 
@@ -316,6 +324,11 @@ class icarus::trigger::SlidingWindowTriggerSimulation
       300 // 5 minutes
       };
     
+    fhicl::OptionalAtom<std::string> ReplayStore {
+      Name("ReplayStore"),
+      Comment("name of the gate replay store to write (omit not to write it)")
+      };
+    
     fhicl::Atom<std::string> LogCategory {
       Name("LogCategory"),
       Comment("name of the category used for the output"),
@@ -422,6 +435,10 @@ class icarus::trigger::SlidingWindowTriggerSimulation
   /// Pattern algorithm.
   std::optional<icarus::trigger::SlidingWindowPatternAlg> fPatternAlg;
   
+  /// Gate replay stores, one per threshold (empty if not requested).
+  std::vector<std::unique_ptr<icarus::trigger::GateReplayStoreWriter>>
+    fReplayStores;
+  
   /// All plots in one practical sandbox.
   icarus::trigger::PlotSandbox fPlots;
   
@@ -641,6 +658,27 @@ icarus::trigger::SlidingWindowTriggerSimulation::SlidingWindowTriggerSimulation
     fOutputInstances.push_back(outputInstance);
   }
   
+  //
+  // gate replay stores
+  //
+  if (std::optional<std::string> const storeName = config().ReplayStore()) {
+    for (std::string const& thrTag: util::get_elements<0U>(fADCthresholds)) {
+      std::string const name = *storeName + thrTag;
+      std::string const title = "threshold: " + thrTag
+        + ", pattern: " + fPattern.tag();
+      TTree* eventTree = fOutputDir.make<TTree>(
+        gateReplayEventTreeName(name).c_str(),
+        ("Window gates per event (" + title + ")").c_str()
+        );
+      TTree* windowTree = fOutputDir.make<TTree>(
+        gateReplayWindowTreeName(name).c_str(),
+        ("Window topology (" + title + ")").c_str()
+        );
+      fReplayStores.push_back(std::make_unique<GateReplayStoreWriter>
+        (*eventTree, *windowTree));
+    } // for
+  } // if replay store
+  
   {
     mf::LogInfo log(fLogCategory);
     log << "\nConfigured " << fADCthresholds.size() << " thresholds (ADC):";
@@ -975,8 +1013,16 @@ auto icarus::trigger::SlidingWindowTriggerSimulation::produceForThreshold(
   //
   // simulate the trigger response
   //
+  TriggerGates_t const beamGates = beamGate.applyToAll(gates);
   WindowTriggerInfo_t const triggerInfo
-    = fPatternAlg->simulateResponse(beamGate.applyToAll(gates));
+    = fPatternAlg->simulateResponse(beamGates);
+  
+  if (!fReplayStores.empty()) {
+    GateReplayStoreWriter& replayStore = *(fReplayStores[iThr]);
+    replayStore.setTopology(*fWindowMapMan);
+    replayStore.add(event.id(), beamGate.tickRange(), beamGates, triggerInfo);
+  }
+  
   if (triggerInfo) {
     ++fTriggerCount[iThr]; // keep the unique count
     plotInfo.eventTimes.add(eventTimestampInSeconds(event));
@@ -342,12 +342,14 @@ class icarus::trigger::SlidingWindowTrigger: public art::EDProducer {
   unsigned int nDisabledWindows() const noexcept
     { return fWindowChannels.size() - fEnabledWindows.size(); }
   
-  /// Performs the combination for data with a specified threshold.
-  void produceThreshold(
+  /// Stores into `event` the `combinedGates` for the specified threshold.
+  void putThreshold(
     art::Event& event,
-    icarus::trigger::OpDetWaveformMetaDataProductMap_t& waveformMap,
+    icarus::trigger::OpDetWaveformMetaDataProductMap_t const& waveformMap,
     std::string const& threshold,
-    art::InputTag const& dataTag
+    art::InputTag const& dataTag,
+    std::size_t nInputGates,
+    std::vector<TrackedTriggerGate_t> combinedGates
     ) const;
   
   /// Reads a set of input gates from the `event` and updates `waveformMap`.
@@ -486,10 +488,30 @@ void icarus::trigger::SlidingWindowTrigger::produce(art::Event& event) {
   
   icarus::trigger::OpDetWaveformMetaDataProductMap_t waveformMap;
 
+  // reading is serial, since it also fills the waveform map
+  std::vector<std::vector<TrackedTriggerGate_t>> thresholdGates;
   for (auto const& [ thresholdStr, dataTag ]: fADCthresholds) {
-
-    produceThreshold(event, waveformMap, thresholdStr, dataTag);
-    
+    mf::LogDebug(fLogCategory)
+      << "Processing threshold " << thresholdStr
+      << " from '" << dataTag.encode() << "'"
+      ;
+    thresholdGates.push_back(ReadTriggerGates(event, dataTag, waveformMap));
+  } // for all thresholds
+  
+  // all windows of all thresholds are combined together
+  std::vector<std::vector<TrackedTriggerGate_t> const*> thresholdGatePtrs;
+  for (auto const& gates: thresholdGates) thresholdGatePtrs.push_back(&gates);
+  std::vector<std::vector<TrackedTriggerGate_t>> combinedGates
+    = fCombiner.combine(thresholdGatePtrs);
+  
+  // output is serial and in threshold order
+  std::size_t iThr = 0U;
+  for (auto const& [ thresholdStr, dataTag ]: fADCthresholds) {
+    putThreshold(
+      event, waveformMap, thresholdStr, dataTag,
+      thresholdGates[iThr].size(), std::move(combinedGates[iThr])
+      );
+    ++iThr;
   } // for all thresholds
   
 } // icarus::trigger::SlidingWindowTrigger::produce()
@@ -512,28 +534,18 @@ auto icarus::trigger::SlidingWindowTrigger::defineWindows() const
 
 
 //------------------------------------------------------------------------------
-void icarus::trigger::SlidingWindowTrigger::produceThreshold(
+void icarus::trigger::SlidingWindowTrigger::putThreshold(
   art::Event& event,
-  icarus::trigger::OpDetWaveformMetaDataProductMap_t& waveformMap,
+  icarus::trigger::OpDetWaveformMetaDataProductMap_t const& waveformMap,
   std::string const& threshold,
-  art::InputTag const& dataTag
+  art::InputTag const& dataTag,
+  std::size_t nInputGates,
+  std::vector<TrackedTriggerGate_t> combinedGates
 ) const {
   
-  mf::LogDebug(fLogCategory)
-    << "Processing threshold " << threshold
-    << " from '" << dataTag.encode() << "'"
-    ;
-
   using icarus::trigger::OpticalTriggerGateData_t; // for convenience
-  using TrackedTriggerGate_t
-    = icarus::trigger::TrackedOpticalTriggerGate<sbn::OpDetWaveformMeta>;
-  
-  std::vector<TrackedTriggerGate_t> const& gates
-    = ReadTriggerGates(event, dataTag, waveformMap);
-  
-  std::vector<TrackedTriggerGate_t> combinedGates = fCombiner.combine(gates);
 
-  // transform the data; after this line, `gates` is not usable any more
+  // transform the data; after this line, `combinedGates` is not usable any more
   art::PtrMaker<OpticalTriggerGateData_t> const makeGatePtr
     (event, dataTag.instance());
   auto [ outputGates, outputAssns ]
@@ -544,7 +556,7 @@ void icarus::trigger::SlidingWindowTrigger::produceThreshold(
     mf::LogTrace log { fLogCategory };
     log
       << "Threshold " << threshold << " ('" << dataTag.encode() << "'): "
-      << gates.size() << " input channels, "
+      << nInputGates << " input channels, "
       << outputGates.size() << " output channels (+"
       << outputAssns.size() << " associations to waveforms) into '"
       << moduleDescription().moduleLabel() << ":" << dataTag.instance() << "'"
@@ -581,7 +593,7 @@ void icarus::trigger::SlidingWindowTrigger::produceThreshold(
     dataTag.instance()
     );
 
-} // icarus::trigger::SlidingWindowTrigger::produceThreshold()
+} // icarus::trigger::SlidingWindowTrigger::putThreshold()
 
 
 //------------------------------------------------------------------------------
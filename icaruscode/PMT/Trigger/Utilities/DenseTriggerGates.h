@@ -0,0 +1,423 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Utilities/DenseTriggerGates.h
+ * @brief  Dense representations of many trigger gates over a common window.
+ * @date   October 19, 2026
+ * @see    icaruscode/PMT/Trigger/Utilities/TriggerGateOperations.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef ICARUSCODE_PMT_TRIGGER_UTILITIES_DENSETRIGGERGATES_H
+#define ICARUSCODE_PMT_TRIGGER_UTILITIES_DENSETRIGGERGATES_H
+
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::min(), std::max(), std::fill_n(), std::copy_n()
+#include <iterator> // std::next()
+#include <type_traits> // std::decay_t
+#include <limits>
+#include <cstdint> // std::uint16_t
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <cassert>
+
+
+namespace icarus::trigger {
+
+  template <typename Level = std::uint16_t> class DenseGateLevels;
+
+  /**
+   * @brief Combines `gates` tick by tick through a `DenseGateLevels` object.
+   * @tparam Level type used to store the opening level at each tick
+   * @tparam Gate type of gate, with `icarus::trigger::TriggerGateData` interface
+   * @param gates pointers to the gates to be combined
+   * @param op the combination (`&DenseGateLevels<Level>::sum`, `max` or `min`)
+   * @param dest the gate to fill with the result
+   * @return `dest`
+   *
+   * The window of the dense representation spans from one tick before the
+   * earliest opening change of any of the `gates` to the latest one, so that
+   * the opening levels of `dest` are the same as the ones from the
+   * corresponding gate operation (`sumGates()`, `maxGates()` or `minGates()`)
+   * at every tick, up to `Level` saturation.
+   * Only the levels of `dest` are set: channels and tracking information, if
+   * any, are left to the caller.
+   */
+  template <typename Level = std::uint16_t, typename Gate>
+  Gate& combineDenseGates(
+    std::vector<Gate const*> const& gates,
+    typename DenseGateLevels<Level>::Combination_t op,
+    Gate& dest
+    );
+
+  namespace details {
+
+    /**
+     * @brief Calls `f(begin, end, level)` for each interval of constant opening
+     *        of `gate` between ticks `start` and `stop` (excluded).
+     *
+     * The gate object must support the query interface of
+     * `icarus::trigger::TriggerGateData`.
+     */
+    template <typename Gate, typename Tick, typename Func>
+    void forEachGateLevel(Gate const& gate, Tick start, Tick stop, Func&& f);
+
+  } // namespace details
+
+} // namespace icarus::trigger
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Opening levels of many gates, tick by tick, over a common window.
+ * @tparam Level type used to store the opening level at each tick
+ *
+ * This object stores the opening level of a number of gates at each tick of
+ * the same time window, with gates laid out one after the other in memory
+ * (each one padded to a multiple of `Alignment` ticks).
+ * Operations combining many gates (`sum()`, `max()`, `min()`) then become
+ * plain loops over contiguous memory which the compiler can vectorize,
+ * rather than the merging of the lists of opening changes that
+ * `icarus::trigger::TriggerGateData` objects require (see
+ * `icarus::trigger::sumGates()` etc.).
+ * With the default 16-bit levels, a sum must not exceed 65535.
+ *
+ * Gates are copied in with `setGate()` and out with `toGate()`; within the
+ * window, the conversion is exact (up to `Level` saturation).
+ *
+ * Example of majority of 12 discriminated gates:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * icarus::trigger::DenseGateLevels<> levels{ gates.size(), start, nTicks };
+ * for (auto const& [ iGate, gate ]: util::enumerate(gates))
+ *   levels.setGate(iGate, gateDataIn(gate));
+ *
+ * std::vector<std::uint16_t> const majority = levels.sum();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+template <typename Level /* = std::uint16_t */>
+class icarus::trigger::DenseGateLevels {
+
+    public:
+  using Level_t = Level; ///< Type of opening level of a gate.
+  using Tick_t = std::ptrdiff_t; ///< Type of tick in the window.
+  using Levels_t = std::vector<Level_t>; ///< Levels of a gate, tick by tick.
+
+  /// Type of the combination kernels (`sum()`, `max()`, `min()`).
+  using Combination_t
+    = void (DenseGateLevels::*)(std::vector<std::size_t> const&, Level_t*) const;
+
+  /// Each gate is padded to a multiple of this number of ticks.
+  static constexpr std::size_t Alignment = 64U / sizeof(Level_t);
+
+  /// Constructor: `nGates` closed gates, `nTicks` ticks from `firstTick` on.
+  DenseGateLevels(std::size_t nGates, Tick_t firstTick, std::size_t nTicks)
+    : fNGates(nGates), fFirstTick(firstTick), fNTicks(nTicks)
+    , fStride(((nTicks + Alignment - 1) / Alignment) * Alignment)
+    , fLevels(fNGates * fStride, Level_t{ 0 })
+    {}
+
+
+  // --- BEGIN -- Access -------------------------------------------------------
+  /// Number of gates.
+  std::size_t nGates() const { return fNGates; }
+
+  /// Number of ticks in the window.
+  std::size_t nTicks() const { return fNTicks; }
+
+  /// First tick of the window.
+  Tick_t firstTick() const { return fFirstTick; }
+
+  /// Tick after the last one in the window.
+  Tick_t endTick() const { return fFirstTick + Tick_t(fNTicks); }
+
+  /// Pointer to the levels of gate `iGate` (`nTicks()` of them).
+  Level_t const* gate(std::size_t iGate) const
+    { assert(iGate < fNGates); return fLevels.data() + iGate * fStride; }
+  Level_t* gate(std::size_t iGate)
+    { assert(iGate < fNGates); return fLevels.data() + iGate * fStride; }
+
+  /// Returns the level of gate `iGate` at `tick` (closed out of the window).
+  Level_t level(std::size_t iGate, Tick_t tick) const
+    {
+      return ((tick < fFirstTick) || (tick >= endTick()))
+        ? Level_t{ 0 }: gate(iGate)[tick - fFirstTick];
+    }
+
+  // --- END ---- Access -------------------------------------------------------
+
+
+  // --- BEGIN -- Conversions --------------------------------------------------
+  /**
+   * @brief Copies the levels of `gate` within the window into gate `iGate`.
+   * @tparam Gate type of gate, with `icarus::trigger::TriggerGateData` interface
+   * @param iGate index of the gate to be set
+   * @param gate the gate to copy the levels from
+   *
+   * Tracked gates need to be passed as their gate data (`gateDataIn()`).
+   */
+  template <typename Gate>
+  void setGate(std::size_t iGate, Gate const& gate);
+
+  /**
+   * @brief Fills `gate` with the levels `levels` from this window.
+   * @tparam Gate type of gate, with `icarus::trigger::TriggerGateData` interface
+   * @param levels pointer to the `nTicks()` levels to be converted
+   * @param gate the gate to fill (its previous content is removed)
+   * @return `gate`
+   *
+   * The level at the first tick of the window is extended to all the ticks
+   * before it, and the one at the last tick to all the ticks after it.
+   * This makes `toGate(gate(i), out)` equal to the gate `in` that was used for
+   * `setGate(i, in)`, as long as all of the changes of `in` are in the window.
+   */
+  template <typename Gate>
+  Gate& toGate(Level_t const* levels, Gate& gate) const;
+
+  /// Returns a gate of type `Gate` with the levels of gate `iGate`.
+  template <typename Gate>
+  Gate toGate(std::size_t iGate) const
+    { Gate gate; toGate(this->gate(iGate), gate); return gate; }
+
+  // --- END ---- Conversions --------------------------------------------------
+
+
+  // --- BEGIN -- Combination kernels ------------------------------------------
+  /**
+   * @name Combination of gates
+   *
+   * Each operation combines the gates with the specified indices, tick by tick,
+   * and writes the `nTicks()` results into `dest`.
+   * The versions without indices combine all the gates.
+   * An empty list of gates results in all levels at `0`.
+   */
+  /// @{
+
+  /// Writes into `dest` the sum of the gates in `gates`.
+  void sum(std::vector<std::size_t> const& gates, Level_t* dest) const;
+
+  /// Writes into `dest` the maximum level of the gates in `gates`.
+  void max(std::vector<std::size_t> const& gates, Level_t* dest) const;
+
+  /// Writes into `dest` the minimum level of the gates in `gates`.
+  void min(std::vector<std::size_t> const& gates, Level_t* dest) const;
+
+  /// Returns the result of the combination `op` of all the gates.
+  Levels_t combine(Combination_t op) const
+    {
+      Levels_t result(fNTicks);
+      (this->*op)(allGates(), result.data());
+      return result;
+    }
+
+  /// Returns the sum of all the gates.
+  Levels_t sum() const { return combine(&DenseGateLevels::sum); }
+
+  /// Returns the maximum level of all the gates, tick by tick.
+  Levels_t max() const { return combine(&DenseGateLevels::max); }
+
+  /// Returns the minimum level of all the gates, tick by tick.
+  Levels_t min() const { return combine(&DenseGateLevels::min); }
+
+  /// @}
+  // --- END ---- Combination kernels ------------------------------------------
+
+
+    private:
+
+  std::size_t fNGates; ///< Number of gates.
+  Tick_t fFirstTick; ///< First tick of the window.
+  std::size_t fNTicks; ///< Number of ticks in the window.
+  std::size_t fStride; ///< Distance between the start of two gates.
+
+  std::vector<Level_t> fLevels; ///< Levels of all gates.
+
+  /// Returns a list with the indices of all gates.
+  std::vector<std::size_t> allGates() const;
+
+}; // icarus::trigger::DenseGateLevels
+
+
+
+// =============================================================================
+// ===  template implementation
+// =============================================================================
+// ---  details
+// -----------------------------------------------------------------------------
+template <typename Gate, typename Tick, typename Func>
+void icarus::trigger::details::forEachGateLevel
+  (Gate const& gate, Tick start, Tick stop, Func&& f)
+{
+  using ClockTick_t = std::decay_t<decltype(gate.MaxTick)>;
+
+  // each change is either a rise above the current level
+  // or a drop below it, whichever comes first
+  auto tick = static_cast<ClockTick_t>(start);
+  auto const end = static_cast<ClockTick_t>(stop);
+  while (tick < end) {
+    auto const level = gate.openingCount(tick);
+    ClockTick_t next = gate.findOpen(level + 1, tick + 1);
+    if (level > 0) next = std::min(next, gate.findClose(level, tick + 1));
+    next = std::min(next, end);
+    f(static_cast<Tick>(tick), static_cast<Tick>(next), level);
+    tick = next;
+  } // while
+
+} // icarus::trigger::details::forEachGateLevel()
+
+
+// -----------------------------------------------------------------------------
+// ---  icarus::trigger::combineDenseGates()
+// -----------------------------------------------------------------------------
+template <typename Level /* = std::uint16_t */, typename Gate>
+Gate& icarus::trigger::combineDenseGates(
+  std::vector<Gate const*> const& gates,
+  typename DenseGateLevels<Level>::Combination_t op,
+  Gate& dest
+) {
+  using Tick_t = typename DenseGateLevels<Level>::Tick_t;
+
+  //
+  // find the earliest and latest opening changes of all gates;
+  // before the first change, all gates are at their starting level
+  //
+  Tick_t firstChange = std::numeric_limits<Tick_t>::max();
+  Tick_t lastChange = std::numeric_limits<Tick_t>::min();
+  for (Gate const* gate: gates) {
+    details::forEachGateLevel(*gate, gate->MinTick, gate->MaxTick,
+      [&firstChange,&lastChange,MinTick=gate->MinTick]
+        (auto begin, auto /* end */, auto /* level */)
+        {
+          if (begin == MinTick) return; // not a change
+          firstChange = std::min(firstChange, static_cast<Tick_t>(begin));
+          lastChange = std::max(lastChange, static_cast<Tick_t>(begin));
+        }
+      );
+  } // for gates
+  if (firstChange > lastChange) firstChange = lastChange = 0; // no change
+
+  DenseGateLevels<Level> levels{
+    gates.size(), firstChange - 1, std::size_t(lastChange - firstChange + 2)
+    };
+  for (std::size_t iGate = 0; iGate < gates.size(); ++iGate)
+    levels.setGate(iGate, *(gates[iGate]));
+
+  return levels.toGate(levels.combine(op).data(), dest);
+
+} // icarus::trigger::combineDenseGates()
+
+
+// -----------------------------------------------------------------------------
+// ---  icarus::trigger::DenseGateLevels
+// -----------------------------------------------------------------------------
+template <typename Level>
+template <typename Gate>
+void icarus::trigger::DenseGateLevels<Level>::setGate
+  (std::size_t iGate, Gate const& gate)
+{
+  Level_t* const levels = this->gate(iGate);
+  std::fill_n(levels, fNTicks, Level_t{ 0 });
+  details::forEachGateLevel(gate, firstTick(), endTick(),
+    [this,levels](Tick_t begin, Tick_t end, auto level)
+      {
+        using Opening_t = decltype(level);
+        constexpr auto MaxLevel
+          = static_cast<Opening_t>(std::numeric_limits<Level_t>::max());
+        if (level == 0) return;
+        std::fill(
+          levels + (begin - fFirstTick), levels + (end - fFirstTick),
+          static_cast<Level_t>(std::min(level, MaxLevel))
+          );
+      }
+    );
+
+} // icarus::trigger::DenseGateLevels<>::setGate()
+
+
+// -----------------------------------------------------------------------------
+template <typename Level>
+template <typename Gate>
+Gate& icarus::trigger::DenseGateLevels<Level>::toGate
+  (Level_t const* levels, Gate& gate) const
+{
+  using OpeningCount_t = typename Gate::OpeningCount_t;
+  using OpeningDiff_t = typename Gate::OpeningDiff_t;
+  using ClockTick_t = std::decay_t<decltype(gate.MaxTick)>;
+
+  gate.clear();
+  if (fNTicks == 0) return gate;
+
+  gate.setOpeningAt(gate.MinTick, static_cast<OpeningCount_t>(levels[0]));
+  for (std::size_t i = 1; i < fNTicks; ++i) {
+    if (levels[i] == levels[i - 1]) continue;
+    auto const tick = static_cast<ClockTick_t>(fFirstTick + Tick_t(i));
+    if (levels[i] > levels[i - 1])
+      gate.openAt(tick, static_cast<OpeningDiff_t>(levels[i] - levels[i - 1]));
+    else
+      gate.closeAt(tick, static_cast<OpeningDiff_t>(levels[i - 1] - levels[i]));
+  } // for
+  return gate;
+} // icarus::trigger::DenseGateLevels<>::toGate()
+
+
+// -----------------------------------------------------------------------------
+template <typename Level>
+void icarus::trigger::DenseGateLevels<Level>::sum
+  (std::vector<std::size_t> const& gates, Level_t* dest) const
+{
+  std::fill_n(dest, fNTicks, Level_t{ 0 });
+  for (std::size_t const iGate: gates) {
+    Level_t const* const levels = gate(iGate);
+    for (std::size_t i = 0; i < fNTicks; ++i) dest[i] += levels[i];
+  }
+} // icarus::trigger::DenseGateLevels<>::sum()
+
+
+// -----------------------------------------------------------------------------
+template <typename Level>
+void icarus::trigger::DenseGateLevels<Level>::max
+  (std::vector<std::size_t> const& gates, Level_t* dest) const
+{
+  std::fill_n(dest, fNTicks, Level_t{ 0 });
+  for (std::size_t const iGate: gates) {
+    Level_t const* const levels = gate(iGate);
+    for (std::size_t i = 0; i < fNTicks; ++i)
+      dest[i] = std::max(dest[i], levels[i]);
+  }
+} // icarus::trigger::DenseGateLevels<>::max()
+
+
+// -----------------------------------------------------------------------------
+template <typename Level>
+void icarus::trigger::DenseGateLevels<Level>::min
+  (std::vector<std::size_t> const& gates, Level_t* dest) const
+{
+  if (gates.empty()) {
+    std::fill_n(dest, fNTicks, Level_t{ 0 });
+    return;
+  }
+  std::copy_n(gate(gates.front()), fNTicks, dest);
+  for (auto iGate = std::next(gates.begin()); iGate != gates.end(); ++iGate) {
+    Level_t const* const levels = gate(*iGate);
+    for (std::size_t i = 0; i < fNTicks; ++i)
+      dest[i] = std::min(dest[i], levels[i]);
+  }
+} // icarus::trigger::DenseGateLevels<>::min()
+
+
+// -----------------------------------------------------------------------------
+template <typename Level>
+std::vector<std::size_t> icarus::trigger::DenseGateLevels<Level>::allGates()
+  const
+{
+  std::vector<std::size_t> gates(fNGates);
+  for (std::size_t i = 0; i < fNGates; ++i) gates[i] = i;
+  return gates;
+} // icarus::trigger::DenseGateLevels<>::allGates()
+
+
+
+
+// -----------------------------------------------------------------------------
+
+
+#endif // ICARUSCODE_PMT_TRIGGER_UTILITIES_DENSETRIGGERGATES_H
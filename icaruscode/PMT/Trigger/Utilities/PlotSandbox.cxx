@@ -18,6 +18,10 @@
 #include "messagefacility/MessageLogger/MessageLogger.h" // MF_XXX() macros
 
 // ROOT libraries
+#include "TMemFile.h"
+#include "TEfficiency.h"
+#include "TGraph.h"
+#include "TH1.h"
 
 // C/C++ standard libraries
 #include <string_view>
@@ -25,6 +29,129 @@
 #include <type_traits> // std::add_const_t<>
 
 
+//------------------------------------------------------------------------------
+//--- local helpers
+//------------------------------------------------------------------------------
+namespace {
+  
+  /// Moves `obj` into the ROOT directory `dir` (`nullptr` to detach it).
+  void attachToDirectory(TObject& obj, TDirectory* dir) {
+    if (auto hist = dynamic_cast<TH1*>(&obj)) hist->SetDirectory(dir);
+    else if (auto eff = dynamic_cast<TEfficiency*>(&obj))
+      eff->SetDirectory(dir);
+    else if (dir) dir->Append(&obj);
+  } // attachToDirectory()
+  
+  
+  /// Removes all the content of `obj`, keeping its binning and settings.
+  void resetObjectContent(TObject& obj) {
+    
+    if (auto hist = dynamic_cast<TH1*>(&obj)) {
+      hist->Reset();
+      return;
+    }
+    
+    if (auto eff = dynamic_cast<TEfficiency*>(&obj)) {
+      // TEfficiency has no reset: replace both histograms with empty ones
+      std::unique_ptr<TH1> empty
+        { static_cast<TH1*>(eff->GetTotalHistogram()->Clone()) };
+      empty->SetDirectory(nullptr);
+      empty->Reset();
+      eff->SetPassedHistogram(*empty, "f");
+      eff->SetTotalHistogram(*empty, "f");
+      return;
+    }
+    
+    if (auto graph = dynamic_cast<TGraph*>(&obj)) {
+      graph->Set(0);
+      return;
+    }
+    
+    throw cet::exception("PlotSandbox")
+      << "Shadowing of object '" << obj.GetName() << "' of type "
+      << obj.ClassName() << " is not supported.\n";
+    
+  } // resetObjectContent()
+  
+  
+  /// Removes all the content of the objects in `dir` and its subdirectories.
+  void resetDirectoryContent(TDirectory& dir) {
+    for (TObject* obj: *(dir.GetList())) {
+      if (auto subdir = dynamic_cast<TDirectory*>(obj))
+        resetDirectoryContent(*subdir);
+      else
+        resetObjectContent(*obj);
+    } // for
+  } // resetDirectoryContent()
+  
+  
+  /// Fills `dest` with empty copies of all objects and directories in `source`.
+  void shadowDirectoryContent(TDirectory const& source, TDirectory& dest) {
+    
+    for (TObject const* obj: *(source.GetList())) {
+      
+      if (auto subdir = dynamic_cast<TDirectory const*>(obj)) {
+        TDirectory* destSubdir
+          = dest.mkdir(subdir->GetName(), subdir->GetTitle());
+        if (!destSubdir) {
+          throw cet::exception("PlotSandbox")
+            << "Failed to create shadow directory '" << subdir->GetName()
+            << "' in '" << dest.GetPath() << "'.\n";
+        }
+        shadowDirectoryContent(*subdir, *destSubdir);
+        continue;
+      }
+      
+      std::unique_ptr<TObject> copy { obj->Clone() };
+      attachToDirectory(*copy, nullptr); // some clones join the original dir
+      resetObjectContent(*copy);
+      attachToDirectory(*copy.release(), &dest);
+      
+    } // for
+    
+  } // shadowDirectoryContent()
+  
+  
+  /// Adds the content of the objects in `source` to the ones in `dest`.
+  void mergeDirectoryContent(TDirectory& dest, TDirectory const& source) {
+    
+    for (TObject* obj: *(source.GetList())) {
+      
+      if (auto subdir = dynamic_cast<TDirectory const*>(obj)) {
+        TDirectory* destSubdir = dest.GetDirectory(subdir->GetName());
+        if (!destSubdir) {
+          throw cet::exception("PlotSandbox")
+            << "Directory '" << subdir->GetName() << "' not found in '"
+            << dest.GetPath() << "'.\n";
+        }
+        mergeDirectoryContent(*destSubdir, *subdir);
+        continue;
+      }
+      
+      TObject* destObj = dest.GetList()->FindObject(obj->GetName());
+      if (!destObj || (destObj->IsA() != obj->IsA())) {
+        throw cet::exception("PlotSandbox")
+          << "Object '" << obj->GetName() << "' of type " << obj->ClassName()
+          << " not found in '" << dest.GetPath() << "'.\n";
+      }
+      
+      ROOT::MergeFunc_t const merge = destObj->IsA()->GetMerge();
+      TList sources; // does not own the objects
+      sources.Add(obj);
+      if (!merge || (merge(destObj, &sources, nullptr) < 0)) {
+        throw cet::exception("PlotSandbox")
+          << "Failed to merge object '" << obj->GetName() << "' of type "
+          << obj->ClassName() << " into '" << dest.GetPath() << "'.\n";
+      }
+      
+    } // for
+    
+  } // mergeDirectoryContent()
+  
+  
+} // local namespace
+
+
 //------------------------------------------------------------------------------
 //--- icarus::trigger::PlotSandbox::TFileDirectoryHelper
 //------------------------------------------------------------------------------
@@ -97,6 +224,14 @@ icarus::trigger::PlotSandbox::PlotSandbox(PlotSandbox&& from)
 } // PlotSandbox::PlotSandbox(PlotSandbox&&)
 
 
+//------------------------------------------------------------------------------
+icarus::trigger::PlotSandbox::PlotSandbox(Data_t&& data)
+  : fData(std::move(data))
+{
+  fData.resetSubboxParents(this);
+} // PlotSandbox::PlotSandbox(Data_t&&)
+
+
 //------------------------------------------------------------------------------
 std::string icarus::trigger::PlotSandbox::ID() const
   { return fData.parent? (fData.parent->ID() + '/' + name()): name(); }
@@ -187,6 +322,40 @@ bool icarus::trigger::PlotSandbox::deleteSubSandbox(std::string const& name) {
 } // icarus::trigger::PlotSandbox::deleteSubSandbox()
 
 
+//------------------------------------------------------------------------------
+auto icarus::trigger::PlotSandbox::makeShadow() const
+  -> std::unique_ptr<PlotSandbox>
+{
+  // creating a ROOT file changes the current directory: we restore it at exit
+  TDirectory::TContext const restoreCurrentDir;
+  
+  std::unique_ptr<TDirectory> store
+    { new TMemFile("PlotSandboxShadow", "RECREATE") };
+  
+  shadowDirectoryContent(*getDirectory(), *store);
+  
+  std::unique_ptr<PlotSandbox> shadow = makeShadowOf(*this, *store);
+  shadow->fData.shadowStore = std::move(store);
+  return shadow;
+  
+} // icarus::trigger::PlotSandbox::makeShadow()
+
+
+//------------------------------------------------------------------------------
+void icarus::trigger::PlotSandbox::mergeShadow(PlotSandbox& shadow) {
+  
+  if (shadow.fData.shadowed != this) {
+    throw cet::exception("PlotSandbox")
+      << "PlotSandbox::mergeShadow(): sandbox '" << shadow.ID()
+      << "' is not a shadow of '" << ID() << "'.\n";
+  }
+  
+  mergeDirectoryContent(*getDirectory(), *shadow.getDirectory());
+  resetDirectoryContent(*shadow.getDirectory());
+  
+} // icarus::trigger::PlotSandbox::mergeShadow()
+
+
 //------------------------------------------------------------------------------
 icarus::trigger::PlotSandbox::PlotSandbox
   (PlotSandbox const& parent, std::string name, std::string desc)
@@ -195,6 +364,40 @@ icarus::trigger::PlotSandbox::PlotSandbox
   setParent(&parent);
 }
 
+//------------------------------------------------------------------------------
+auto icarus::trigger::PlotSandbox::makeShadowOf
+  (PlotSandbox const& original, TDirectory& shadowDir)
+  -> std::unique_ptr<PlotSandbox>
+{
+  Data_t data {
+    std::string{ original.name() }, std::string{ original.description() },
+    TFileDirectoryHelper{ original.fData.outputDir.fDir, &shadowDir }
+    };
+  data.parent = original.fData.parent;
+  data.shadowed = &original;
+  
+  // we can't use make_unique() because the constructor it needs is private:
+  std::unique_ptr<PlotSandbox> shadow { new PlotSandbox(std::move(data)) };
+  
+  // subboxes have their directory directly in the one of their parent,
+  // unless they are unnamed, in which case they share it
+  for (auto const& [ name, subbox ]: original.fData.subBoxes) {
+    TDirectory* subDir = subbox->hasName()
+      ? shadowDir.GetDirectory(subbox->getDirectory()->GetName()): &shadowDir;
+    if (!subDir) {
+      throw cet::exception("PlotSandbox")
+        << "PlotSandbox::makeShadow(): directory of subbox '" << subbox->ID()
+        << "' not found in the shadow.\n";
+    }
+    std::unique_ptr<PlotSandbox> subShadow = makeShadowOf(*subbox, *subDir);
+    subShadow->setParent(shadow.get());
+    shadow->fData.subBoxes.emplace(name, std::move(subShadow));
+  } // for
+  
+  return shadow;
+} // icarus::trigger::PlotSandbox::makeShadowOf()
+
+
 //------------------------------------------------------------------------------
 std::string icarus::trigger::PlotSandbox::processPlotTitle
   (std::string const& title) const
@@ -91,6 +91,43 @@ namespace icarus::trigger { class PlotSandbox; }
  * 
  * @note By convention the subdirectory names are not processed.
  * 
+ * 
+ * Shadow sandboxes
+ * -----------------
+ * 
+ * ROOT objects can't be filled from different threads at the same time.
+ * To fill the plots of a sandbox from multiple threads, each thread can be
+ * assigned its own _shadow_ of the sandbox (`makeShadow()`). A shadow has the
+ * same structure as the original sandbox (subboxes included) and holds a copy
+ * of each of its objects, with the same name but with no content.
+ * The shadow objects are accessed in the same way as the original ones
+ * (`use()`, `demand()`, `demandSandbox()`...), and they are kept in memory
+ * only, never written into the output file.
+ * When all filling is done (e.g. at `endJob()`), the content of the shadow is
+ * added to the original sandbox with `mergeShadow()`.
+ * 
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * // in the constructor (or `beginJob()`), after the plots have been created:
+ * for (std::size_t i = 0; i < nThreads; ++i)
+ *   fShadowPlots.push_back(fPlots.makeShadow());
+ * 
+ * // in the task run by thread `iThread`:
+ * fShadowPlots[iThread]->demand<TH1>("HEnergy").Fill(energy);
+ * 
+ * // in `endJob()`:
+ * for (auto& shadow: fShadowPlots) fPlots.mergeShadow(*shadow);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Only histograms (`TH1`), efficiency plots (`TEfficiency`) and graphs
+ * (`TGraph`) are supported in a shadowed sandbox.
+ * A shadow and its subboxes are always plain `PlotSandbox` objects, even when
+ * the original ones are of a derived type: object names are still looked up
+ * through the original sandbox (so an overridden `processName()` applies),
+ * but other overridden functions and the data of the derived class are not
+ * available through the shadow, which can't be cast to the derived type.
+ * Creation and merging of shadows manipulate ROOT directories and must not
+ * happen concurrently with any other ROOT operation.
+ * 
  */
 class icarus::trigger::PlotSandbox {
   
@@ -132,6 +169,12 @@ class icarus::trigger::PlotSandbox {
     
     TFileDirectoryHelper outputDir; ///< Output ROOT directory of the sandbox.
     
+    /// The sandbox this one is a shadow of (`nullptr` if not a shadow).
+    PlotSandbox const* shadowed = nullptr;
+    
+    /// In-memory storage of all the objects of a shadow sandbox hierarchy.
+    std::unique_ptr<TDirectory> shadowStore;
+    
     Data_t() = default;
     Data_t(Data_t const&) = delete;
     Data_t(Data_t&&) = default;
@@ -157,6 +200,17 @@ class icarus::trigger::PlotSandbox {
   template <typename SandboxType>
   static auto& demandSandbox(SandboxType& sandbox, std::string const& name);
   
+  /// Constructor: steals all the `data`.
+  explicit PlotSandbox(Data_t&& data);
+  
+  /// Creates a shadow of `original` sandbox (and its subboxes) in `shadowDir`.
+  static std::unique_ptr<PlotSandbox> makeShadowOf
+    (PlotSandbox const& original, TDirectory& shadowDir);
+  
+  /// Returns the sandbox in charge of processing the names of the objects.
+  PlotSandbox const& nameSource() const
+    { return fData.shadowed? *fData.shadowed: *this; }
+  
   
     public:
   
@@ -325,9 +379,11 @@ class icarus::trigger::PlotSandbox {
    * @param args additional arguments for the sandbox constructor
    * @return a reference to the created sandbox
    * @throw cet::exception (category: `"PlotSandbox"`) if a sandbox with this
-   *        name already exists.
+   *        name already exists, or if this sandbox is a shadow.
    * 
    * The arguments of this method are equivalent to the ones of the constructor.
+   * Shadow sandboxes can't have new subboxes, since those would be created in
+   * the output file rather than in the shadow.
    * 
    * The new sand box parent is set to point to this sand box.
    */
@@ -380,6 +436,45 @@ class icarus::trigger::PlotSandbox {
   // --- END -- Contained sandboxes --------------------------------------------
   
   
+  // --- BEGIN -- Shadow sandboxes ---------------------------------------------
+  /// @name Shadow sandboxes
+  /// @{
+  
+  /// Returns whether this sandbox is the shadow of another one.
+  bool isShadow() const { return fData.shadowed != nullptr; }
+  
+  /**
+   * @brief Creates a shadow of this sandbox.
+   * @return a new sandbox, shadow of this one
+   * @throw cet::exception (category: `"PlotSandbox"`) if the sandbox contains
+   *        objects of an unsupported type
+   * 
+   * The shadow contains a copy of all the objects in this sandbox and in its
+   * subboxes, with the same names but with no content.
+   * The shadow sandbox can't create new objects (`make()`) nor new subboxes
+   * (`addSubSandbox()`).
+   * This sandbox must outlive its shadow.
+   * 
+   * The shadow is a `PlotSandbox` also when this sandbox is of a derived type
+   * (see the "Shadow sandboxes" section in the class documentation).
+   */
+  std::unique_ptr<PlotSandbox> makeShadow() const;
+  
+  /**
+   * @brief Adds the content of the `shadow` sandbox to this one.
+   * @param shadow a shadow of this sandbox
+   * @throw cet::exception (category: `"PlotSandbox"`) if `shadow` is not a
+   *        shadow of this sandbox, or if an object can't be merged
+   * 
+   * After the merge, the objects of the `shadow` are emptied, so that the same
+   * content is never merged twice.
+   */
+  void mergeShadow(PlotSandbox& shadow);
+  
+  /// @}
+  // --- END -- Shadow sandboxes -----------------------------------------------
+  
+  
   /// Dumps the hierarchy of sandboxes into the specified stream.
   template <typename Stream>
   void dump(Stream&& out, std::string indent, std::string firstIndent) const;
@@ -656,7 +751,7 @@ Obj* icarus::trigger::PlotSandbox::use(std::string const& name) const {
   TDirectory* dir = getDirectory(objDir);
   if (!dir) return nullptr;
   
-  std::string const processedName = processName(objName);
+  std::string const processedName = nameSource().processName(objName);
   return dir->Get<Obj>(processedName.c_str());
   
 } // icarus::trigger::PlotSandbox::use()
@@ -700,6 +795,12 @@ template <typename Obj, typename... Args>
 Obj* icarus::trigger::PlotSandbox::make
   (std::string const& name, std::string const& title, Args&&... args)
 {
+  if (isShadow()) {
+    throw cet::exception("PlotSandbox")
+      << "PlotSandbox::make(): can't create object '" << name
+      << "' in the shadow sandbox '" << ID() << "'.\n";
+  }
+  
   auto [ objDir, objName ] = splitPath(name);
   
   std::string const processedName = processName(objName);
@@ -722,6 +823,12 @@ template
 SandboxType& icarus::trigger::PlotSandbox::addSubSandbox
   (std::string const& name, std::string const& desc, Args&&... args)
 {
+  if (isShadow()) {
+    throw cet::exception("PlotSandbox")
+      << "PlotSandbox::addSubSandbox(): can't create subbox '" << name
+      << "' in the shadow sandbox '" << ID() << "'.\n";
+  }
+  
   // we can't use make_unique() because the constructor it needs is protected:
   auto [ it, bInserted ] = fData.subBoxes.try_emplace
     (name, new SandboxType(*this, name, desc, std::forward<Args>(args)...));
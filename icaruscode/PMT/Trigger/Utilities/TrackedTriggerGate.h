@@ -17,8 +17,9 @@
 #include "larcorealg/CoreUtils/span.h" // util::make_transformed_span()
 
 // C/C++ standard libraries
+#include <algorithm> // std::lower_bound(), std::unique(), ...
 #include <iosfwd>
-#include <set>
+#include <vector>
 #include <functional> // std::mem_fn()
 #include <utility> // std::in_place_t, std::forward(), ...
 #include <type_traits> // std::true_type...
@@ -93,6 +94,11 @@ namespace icarus::trigger {
   * as tracking object instead of the object itself.
   * If an object is already present, it is not added again into the tracking.
   * 
+  * The tracked objects are kept in a sorted, contiguous list rather than in a
+  * node-based set: gate combinations merge the tracking of their operands
+  * many times per event, and merging two sorted lists in place requires at
+  * most one allocation and no pointer chasing.
+  * 
   * The `Gate` type is expected to be a trigger gate type, like
   * `icarus::trigger::ReadoutTriggerGate`.
   */
@@ -107,7 +113,7 @@ class icarus::trigger::TrackedTriggerGate {
   /// Tracked information. Interface is pretty minimal so far.
   class TrackingInfo {
     
-    std::set<Tracked_t> fTracked; ///< All tracked objects.
+    std::vector<Tracked_t> fTracked; ///< All tracked objects, sorted, unique.
     
       public:
     
@@ -123,8 +129,8 @@ class icarus::trigger::TrackedTriggerGate {
     /// Whether any tracked object is present.
     bool hasTracked() const;
     
-    /// Returns an iterable of all tracked objects.
-    auto getTracked() const;
+    /// Returns an iterable of all tracked objects (sorted).
+    std::vector<Tracked_t> const& getTracked() const;
     
   }; // class TrackingInfo
   
@@ -197,14 +203,44 @@ namespace icarus::trigger {
 template <typename Gate, typename TrackedType>
 void icarus::trigger::TrackedTriggerGate<Gate, TrackedType>::TrackingInfo::add
   (TrackedType tracked)
-  { fTracked.insert(std::move(tracked)); }
+{
+  // objects are often added in order: appending is the fast path
+  if (fTracked.empty() || (fTracked.back() < tracked)) {
+    fTracked.push_back(std::move(tracked));
+    return;
+  }
+  auto const it = std::lower_bound(fTracked.begin(), fTracked.end(), tracked);
+  if (tracked < *it) fTracked.insert(it, std::move(tracked));
+} // icarus::trigger::TrackedTriggerGate<>::TrackingInfo::add()
 
 
 // -----------------------------------------------------------------------------
 template <typename Gate, typename TrackedType>
 void icarus::trigger::TrackedTriggerGate<Gate, TrackedType>::TrackingInfo::add
   (TrackingInfo const& tracked)
-  { fTracked.insert(begin(tracked.fTracked), end(tracked.fTracked)); }
+{
+  std::vector<Tracked_t> const& other = tracked.fTracked;
+  if (other.empty() || (&other == &fTracked)) return;
+  if (fTracked.empty() || (fTracked.back() < other.front())) {
+    fTracked.insert(fTracked.end(), other.begin(), other.end());
+    return;
+  }
+  
+  // merge from the back into the enlarged list, then drop the duplicates
+  std::size_t const nOld = fTracked.size();
+  fTracked.resize(nOld + other.size());
+  auto iOld = fTracked.rend() - nOld; // last of the old elements
+  auto iOther = other.rbegin();
+  auto iDest = fTracked.rbegin();
+  while (iOther != other.rend()) {
+    if ((iOld != fTracked.rend()) && (*iOther < *iOld))
+      *iDest++ = std::move(*iOld++);
+    else
+      *iDest++ = *iOther++;
+  } // while
+  fTracked.erase(std::unique(fTracked.begin(), fTracked.end()), fTracked.end());
+  
+} // icarus::trigger::TrackedTriggerGate<>::TrackingInfo::add()
 
 
 // -----------------------------------------------------------------------------
@@ -226,7 +262,7 @@ icarus::trigger::TrackedTriggerGate<Gate, TrackedType>::TrackingInfo::hasTracked
 // -----------------------------------------------------------------------------
 template <typename Gate, typename TrackedType>
 auto icarus::trigger::TrackedTriggerGate<Gate, TrackedType>::TrackingInfo::getTracked()
-  const
+  const -> std::vector<Tracked_t> const&
   { return fTracked; }
 
 
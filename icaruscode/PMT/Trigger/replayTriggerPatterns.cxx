@@ -0,0 +1,310 @@
+/**
+ * @file   icaruscode/PMT/Trigger/replayTriggerPatterns.cxx
+ * @brief  Applies sliding window patterns to the gates of a gate replay store.
+ * @date   October 19, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h
+ *
+ * The gate replay store is written by `SlidingWindowTriggerSimulation` module
+ * when its `ReplayStore` parameter is set. This program applies any number of
+ * patterns to the stored gates without running _art_, and optionally checks
+ * the replay against the trigger response recorded by the module.
+ *
+ * Exit codes:
+ * * `0`: success (and, with `--check`, the replay matches the record)
+ * * `1`: usage error (wrong command line options or pattern tags)
+ * * `2`: input file or replay store not found
+ * * `3`: error while reading the store or applying the patterns
+ * * `4`: the replay does not match the recorded response (`--check`)
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h"
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
+
+// LArSoft libraries
+#include "larcorealg/CoreUtils/enumerate.h"
+#include "larcorealg/CoreUtils/zip.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TFile.h"
+#include "TTree.h"
+
+// C++/Boost libraries
+#include "boost/program_options.hpp"
+#include <iostream>
+#include <iomanip> // std::setw()
+#include <memory> // std::unique_ptr
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdlib> // std::exit()
+
+/*
+ * Notable changes here:
+ *
+ * [20261019] [1.0]
+ *     initial version
+ *
+ */
+static std::string const ProgramVersion = "v1.0";
+
+/// Exit codes of the program.
+enum ExitCode_t: int {
+  ExitSuccess  = 0, ///< Success.
+  ExitUsage    = 1, ///< Error in the command line options.
+  ExitInput    = 2, ///< Input file or replay store not available.
+  ExitReplay   = 3, ///< Error while replaying.
+  ExitMismatch = 4  ///< Replay does not match the recorded response.
+}; // ExitCode_t
+
+// -----------------------------------------------------------------------------
+boost::program_options::variables_map parseCommandLine(int argc, char** argv) {
+
+  namespace po = boost::program_options;
+
+  //
+  // Declare the supported options.
+  //
+  po::options_description inputopt("Input/output");
+  inputopt.add_options()
+    ("input", po::value<std::string>(), "input ROOT file")
+    ("store,s", po::value<std::string>(),
+      "name of the replay store, including its ROOT directory"
+      " (e.g. `simSlidingORM1/GateReplay400`)")
+    ;
+
+  po::options_description replayopt("Replay");
+  replayopt.add_options()
+    ("pattern,p", po::value<std::vector<std::string>>()->composing(),
+      "pattern to apply, as a tag (e.g. `M5O2`); can be repeated")
+    ("check,c", po::value<std::string>(),
+      "pattern used to write the store (tag): the replay is compared with"
+      " the recorded response")
+    ("verbose,v", "print the response of each event")
+    ;
+
+  po::options_description genopt("General");
+  genopt.add_options()
+    ("help,?", "print usage instructions and exit")
+    ("version,V", "print version and exit")
+    ;
+
+  po::options_description allopt("Options");
+  allopt.add(inputopt).add(replayopt).add(genopt);
+
+  po::positional_options_description pos;
+  pos.add("input", 1);
+
+  //
+  // proceed with parsing
+  //
+  po::variables_map optmap;
+  po::store(
+    po::command_line_parser(argc, argv)
+      .options(allopt).positional(pos).run(),
+    optmap
+    );
+  po::notify(optmap);
+
+  //
+  // deal with general options
+  //
+  std::optional<int> exitWithCode;
+  if (optmap.count("version")) {
+    std::cout << argv[0] << " version " << ProgramVersion << std::endl;
+    exitWithCode = ExitSuccess;
+  }
+  if (optmap.count("help")) {
+    std::cout
+      <<   "Applies sliding window trigger patterns to the gates stored in a"
+        " gate replay store,"
+      << "\nand prints how many events each pattern triggers."
+      << "\n" << allopt
+      << std::endl
+      ;
+    exitWithCode = ExitSuccess;
+  }
+  if (!exitWithCode
+    && (!optmap.count("input") || !optmap.count("store"))
+  ) {
+    std::cerr << "Both input file and replay store name must be specified."
+      << "\n" << allopt << std::endl;
+    exitWithCode = ExitUsage;
+  }
+  if (!exitWithCode && !optmap.count("pattern") && !optmap.count("check")) {
+    std::cerr << "At least one pattern (or a check) must be specified."
+      << std::endl;
+    exitWithCode = ExitUsage;
+  }
+
+  if (exitWithCode) std::exit(*exitWithCode);
+  return optmap;
+
+} // parseCommandLine()
+
+
+// -----------------------------------------------------------------------------
+/// Returns whether the two trigger responses are the same.
+bool sameResponse(
+  icarus::trigger::SlidingWindowPatternAlg::AllTriggerInfo_t const& replay,
+  icarus::trigger::GateReplayEvent const& recorded
+) {
+  if (replay.info.fired() != recorded.fired) return false;
+  if (!recorded.fired) return true;
+  if (replay.info.atTick().value() != recorded.triggerTick) return false;
+  return replay.extra.windowIndex == std::size_t(recorded.triggerWindow);
+} // sameResponse()
+
+
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  boost::program_options::variables_map const options
+    = parseCommandLine(argc, argv);
+
+  std::string const inputFilePath = options["input"].as<std::string>();
+  std::string const storeName = options["store"].as<std::string>();
+  bool const verbose = options.count("verbose");
+
+  //
+  // patterns
+  //
+  std::vector<std::string> patternTags;
+  if (options.count("pattern"))
+    patternTags = options["pattern"].as<std::vector<std::string>>();
+  std::optional<std::size_t> checkPattern;
+  if (options.count("check")) {
+    checkPattern = patternTags.size();
+    patternTags.push_back(options["check"].as<std::string>());
+  }
+
+  std::vector<icarus::trigger::WindowPattern> patterns;
+  try {
+    for (std::string const& tag: patternTags)
+      patterns.push_back(icarus::trigger::makeWindowPattern(tag));
+  }
+  catch (cet::exception const& e) {
+    std::cerr << "FATAL: " << e.what() << std::endl;
+    return ExitUsage;
+  }
+
+  //
+  // input
+  //
+  std::unique_ptr<TFile> inputFile{ TFile::Open(inputFilePath.c_str()) };
+  if (!inputFile || inputFile->IsZombie()) {
+    std::cerr << "FATAL: can't open input file '" << inputFilePath << "'."
+      << std::endl;
+    return ExitInput;
+  }
+  std::string const eventTreeName
+    = icarus::trigger::gateReplayEventTreeName(storeName);
+  std::string const windowTreeName
+    = icarus::trigger::gateReplayWindowTreeName(storeName);
+  TTree* eventTree = inputFile->Get<TTree>(eventTreeName.c_str());
+  TTree* windowTree = inputFile->Get<TTree>(windowTreeName.c_str());
+  if (!eventTree || !windowTree) {
+    std::cerr << "FATAL: no replay store '" << storeName << "' in '"
+      << inputFilePath << "' (looking for trees '" << eventTreeName
+      << "' and '" << windowTreeName << "')." << std::endl;
+    return ExitInput;
+  }
+
+  //
+  // replay
+  //
+  std::vector<unsigned int> fireCounts(patterns.size(), 0U);
+  unsigned int nMismatches = 0U;
+  std::size_t nEvents = 0U;
+  try {
+    icarus::trigger::GateReplayStoreReader reader{ *eventTree, *windowTree };
+    icarus::trigger::SlidingWindowPatternGridAlg const patternAlgs
+      { reader.topology(), patterns, "replayTriggerPatterns" };
+
+    nEvents = reader.nEvents();
+    std::clog << "Replaying " << patterns.size() << " patterns on " << nEvents
+      << " events from '" << inputFilePath << "' (store: '" << storeName
+      << "')." << std::endl;
+
+    for (std::size_t iEvent = 0U; iEvent < nEvents; ++iEvent) {
+
+      icarus::trigger::GateReplayEvent const& event = reader.read(iEvent);
+      auto const responses = patternAlgs.simulateResponses(event.gates());
+
+      if (verbose) {
+        std::cout << "Event " << event.run << ":" << event.subRun << ":"
+          << event.event << ":";
+      }
+      for (auto const& [ iPattern, response ]: util::enumerate(responses)) {
+        if (response.info.fired()) ++fireCounts[iPattern];
+        if (verbose) {
+          std::cout << " " << patternTags[iPattern] << "=";
+          if (response.info.fired())
+            std::cout << response.info.atTick().value();
+          else
+            std::cout << "-";
+        }
+      } // for patterns
+      if (verbose) std::cout << std::endl;
+
+      if (checkPattern && !sameResponse(responses[*checkPattern], event)) {
+        ++nMismatches;
+        std::cerr << "Mismatch in event " << event.run << ":" << event.subRun
+          << ":" << event.event << ": recorded ";
+        if (event.fired) {
+          std::cerr << "trigger at tick " << event.triggerTick
+            << " (window #" << event.triggerWindow << ")";
+        }
+        else std::cerr << "no trigger";
+        std::cerr << ", replayed " << patternTags[*checkPattern] << " ";
+        auto const& replay = responses[*checkPattern];
+        if (replay.info.fired()) {
+          std::cerr << "trigger at tick " << replay.info.atTick().value()
+            << " (window #" << replay.extra.windowIndex << ")";
+        }
+        else std::cerr << "no trigger";
+        std::cerr << std::endl;
+      } // if mismatch
+
+    } // for events
+  }
+  catch (cet::exception const& e) {
+    std::cerr << "FATAL: " << e.what() << std::endl;
+    return ExitReplay;
+  }
+
+  //
+  // summary
+  //
+  std::cout << "Triggers on " << nEvents << " events:";
+  for (auto const& [ tag, count ]: util::zip(patternTags, fireCounts)) {
+    std::cout << "\n  " << std::setw(16) << tag << "  " << std::setw(8)
+      << count;
+    if (nEvents > 0U) {
+      std::cout << "  (" << std::setw(6) << std::fixed << std::setprecision(2)
+        << (100.0 * count / nEvents) << "%)";
+    }
+  } // for
+  std::cout << std::endl;
+
+  if (checkPattern) {
+    if (nMismatches > 0U) {
+      std::cerr << "Replay of " << patternTags[*checkPattern]
+        << " differs from the recorded response in " << nMismatches << "/"
+        << nEvents << " events." << std::endl;
+    }
+    else {
+      std::cout << "Replay of " << patternTags[*checkPattern]
+        << " matches the recorded response in all events." << std::endl;
+    }
+  } // if check
+
+  return (nMismatches == 0U)? ExitSuccess: ExitMismatch;
+} // main()
+
+
+// -----------------------------------------------------------------------------
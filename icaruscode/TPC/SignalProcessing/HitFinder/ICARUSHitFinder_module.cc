@@ -50,6 +50,7 @@
 
 #include "larreco/RecoAlg/GausFitCache.h" // hit::GausFitCache
 #include "larreco/HitFinder/HitFinderTools/ICandidateHitFinder.h"
+#include "icaruscode/TPC/Utilities/ChannelGeometryCache.h"
 //#include "icaruscode/HitFinder/PeakFitterICARUS.h"
 
 //ROOT from CalData
@@ -331,6 +332,7 @@ double                fChi2NDF;                  ///maximum Chisquared / NDF all
       
     //GET THE GEOMETRY.
     art::ServiceHandle<geo::Geometry> geom;
+    icarus::ChannelGeometryCache const& channelGeom = icarus::ChannelGeometryCache::shared(*geom);
       
       // ###############################################
       // ### Making a ptr vector to put on the event ###
@@ -431,9 +433,8 @@ double                fChi2NDF;                  ///maximum Chisquared / NDF all
 
           
           // get the WireID for this hit
-          std::vector<geo::WireID> wids = geom->ChannelToWire(channel);
           // for now, just take the first option returned from ChannelToWire
-          geo::WireID wid  = wids[0];
+          geo::WireID wid  = channelGeom.wireID(channel);
           // We need to know the plane to look up parameters
           geo::PlaneID::PlaneID_t plane = wid.Plane;
           size_t cryostat=wid.Cryostat;
@@ -448,8 +449,7 @@ double                fChi2NDF;                  ///maximum Chisquared / NDF all
       channel   = rawdigits->Channel();
       fDataSize = rawdigits->Samples();
 
-        std::vector<geo::WireID> widVec = geom->ChannelToWire(channel);
-        size_t                   iwire  = widVec[0].Wire;
+        size_t                   iwire  = channelGeom.wire(channel);
      //   size_t plane = widVec[0].Plane;
 
         
@@ -524,7 +524,6 @@ double                fChi2NDF;                  ///maximum Chisquared / NDF all
 
       reco_tool::ICandidateHitFinder::MergeHitCandidateVec mergedCandidateHitVec;
           
-    std::vector<geo::WireID> wids = geom->ChannelToWire(channel);
           
           std::vector<float> tempVec = holder;
           recob::Wire::RegionsOfInterest_t::datarange_t rangeData(size_t(0),std::move(tempVec));
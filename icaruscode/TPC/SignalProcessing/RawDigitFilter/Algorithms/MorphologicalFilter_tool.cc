@@ -15,6 +15,7 @@
 
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/IRawDigitFilter.h"
 #include "icarus_signal_processing/WaveformTools.h"
+#include "icaruscode/TPC/Utilities/MorphologicalFilters.h"
 
 #include "TH1F.h"
 #include "TH2F.h"
@@ -150,11 +151,13 @@ void MorphologicalFilter::FilterWaveform(RawDigitVector& waveform, size_t channe
     // The plan here is to use a morphological filtering technique to find the slowly varying baseline
     // movement and remove it
 
-    // We make lots of vectors... erosion, dilation, average and difference
-    Waveform erosionVec;
-    Waveform dilationVec;
-    Waveform averageVec;
-    Waveform differenceVec;
+    // We make lots of vectors... erosion, dilation, average and difference; each thread keeps its own
+    icarus::morphology::Buffers<short>& buffers = icarus::morphology::threadBuffers<short>();
+    
+    Waveform& erosionVec    = buffers.erosion;
+    Waveform& dilationVec   = buffers.dilation;
+    Waveform& averageVec    = buffers.average;
+    Waveform& differenceVec = buffers.difference;
     
     // Define histograms for this particular channel?
     caldata::HistogramMap histogramMap = initializeHistograms(channel, cnt, waveform.size());
@@ -162,20 +165,22 @@ void MorphologicalFilter::FilterWaveform(RawDigitVector& waveform, size_t channe
     // If histogramming, then keep track of the original input channel
     if (!histogramMap.empty()) for(size_t idx = 0; idx < waveform.size(); idx++) histogramMap.at(caldata::WAVEFORM)->Fill(idx, waveform.at(idx), 1.);
     
-    Waveform smoothWaveform = waveform;
+    Waveform& smoothWaveform = buffers.smoothed;
+    
+    smoothWaveform.assign(waveform.begin(),waveform.end());
     
     // If the input pedestal is non-zero then baseline correct
     if (std::abs(pedestal) > std::numeric_limits<float>::epsilon())
         std::transform(waveform.begin(),waveform.end(),smoothWaveform.begin(),[pedestal](const auto& val){return val - short(std::round(pedestal));});
 
-    // Compute the morphological filter vectors
-    fWaveformTool.getErosionDilationAverageDifference(smoothWaveform, fStructuringElement, erosionVec, dilationVec, averageVec, differenceVec);
+    // Compute the morphological filter vectors (in linear time, whatever the structuring element)
+    icarus::morphology::erosionDilationAverageDifference(smoothWaveform, fStructuringElement, erosionVec, dilationVec, averageVec, differenceVec, buffers.workspace);
     
     // What we are really interested in here is the closing vector but compute both
-    Waveform openingVec;
-    Waveform closingVec;
+    Waveform& openingVec = buffers.opening;
+    Waveform& closingVec = buffers.closing;
     
-    fWaveformTool.getOpeningAndClosing(erosionVec,dilationVec,fStructuringElement,openingVec,closingVec);
+    icarus::morphology::openingAndClosing(erosionVec, dilationVec, fStructuringElement, openingVec, closingVec, buffers.workspace);
     
     // Ok, get an average of the two
     std::transform(openingVec.begin(),openingVec.end(),closingVec.begin(),averageVec.begin(),[](const auto& left, const auto& right){return (left + right)/2;});
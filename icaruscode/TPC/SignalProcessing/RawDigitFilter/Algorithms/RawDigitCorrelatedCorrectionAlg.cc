@@ -7,8 +7,7 @@
 
 #include "art/Framework/Core/ModuleMacros.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
-#include "lardata/Utilities/LArFFTWPlan.h"
-#include "lardata/Utilities/LArFFTW.h"
+#include "icaruscode/TPC/Utilities/FFTPlanCache.h"
 
 #include <cmath>
 #include <algorithm>
@@ -125,8 +124,7 @@ void RawDigitCorrelatedCorrectionAlg::removeCorrelatedNoise(RawDigitAdcIdxPair&
                                                             std::vector<float>& skewnessWireVec,
                                                             std::vector<float>& neighborRatioWireVec,
                                                             std::vector<float>& pedCorWireVec,
-                                                            unsigned int& fftSize, unsigned int& halfFFTSize,
-							    void* fplan, void* rplan) const
+                                                            unsigned int& fftSize, unsigned int& halfFFTSize) const
 {
     // This method represents and enhanced implementation of "Corey's Algorithm" for correcting the
     // correlated noise across a group of wires. The primary enhancement involves using a FFT to
@@ -178,9 +176,10 @@ void RawDigitCorrelatedCorrectionAlg::removeCorrelatedNoise(RawDigitAdcIdxPair&
 
         // Get the FFT correction
         if (fApplyFFTCorrection) {
-          std::vector<std::complex<double>> fftOutputVec(halfFFTSize);
-          util::LArFFTW lfftw(fftSize, fplan, rplan, 0);
-          lfftw.DoFFT(corValVec, fftOutputVec);
+          // The plans and the spectrum buffer belong to this thread and are made once per size
+          icarus::RealFFTPlan<double>&       fft          = icarus::FFTPlanCache<double>::threadCache().plan(fftSize);
+          std::vector<std::complex<double>>& fftOutputVec = fft.spectrumBuffer();
+          fft.forward(corValVec, fftOutputVec);
 
           std::vector<double> powerVec(halfFFTSize);
           std::transform(fftOutputVec.begin(), fftOutputVec.begin() + halfFFTSize, powerVec.begin(), [](const auto& val){return std::abs(val);});
@@ -220,7 +219,7 @@ void RawDigitCorrelatedCorrectionAlg::removeCorrelatedNoise(RawDigitAdcIdxPair&
         
               std::vector<double> tmpVec(corValVec.size());
         
-              lfftw.DoInvFFT(fftOutputVec, tmpVec);
+              fft.inverse(fftOutputVec, tmpVec);
         
               std::transform(corValVec.begin(),corValVec.end(),tmpVec.begin(),corValVec.begin(),std::minus<double>());
           }
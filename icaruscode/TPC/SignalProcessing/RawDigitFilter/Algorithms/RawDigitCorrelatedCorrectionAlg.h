@@ -64,8 +64,7 @@ public:
                                std::vector<float>& skewnessWireVec,
                                std::vector<float>& neighborRatioWireVec,
                                std::vector<float>& pedCorWireVec,
-                               unsigned int& fftSize, unsigned int& halfFFTSize,
-                               void* fplan, void* rplan) const;
+                               unsigned int& fftSize, unsigned int& halfFFTSize) const;
 
 private:
 
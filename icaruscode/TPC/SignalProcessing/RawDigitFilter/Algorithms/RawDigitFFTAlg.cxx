@@ -12,6 +12,7 @@
 
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icaruscode/TPC/Utilities/tools/IFilter.h"
+#include "icaruscode/TPC/Utilities/FFTPlanCache.h"
 
 #include <cmath>
 #include <algorithm>
@@ -65,8 +66,6 @@ template <class T> void RawDigitFFTAlg<T>::reconfigure(fhicl::ParameterSet const
         fFilterToolMap.insert(std::pair<size_t,std::unique_ptr<icarus_tool::IFilter>>(planeIdx,art::make_tool<icarus_tool::IFilter>(filterToolParamSet)));
         fFilterVecMap[planeIdx] = std::vector<std::complex<float>>();
     }
-    
-    fEigenFFT = std::make_unique<Eigen::FFT<float>>();
 }
     
 //----------------------------------------------------------------------------
@@ -132,11 +131,11 @@ template <class T> void RawDigitFFTAlg<T>::getFFTCorrection(std::vector<T>& corV
     // than the threshold input above.
     size_t const fftDataSize = corValVec.size();
     
-    Eigen::FFT<T> eigenFFT;
-    
-    std::vector<std::complex<T>> fftOutputVec(corValVec.size());
+    // The plans of this thread for this size are made only once, and the transforms are real to complex
+    icarus::RealFFTPlan<T>&       fft          = icarus::FFTPlanCache<T>::threadCache().plan(fftDataSize);
+    std::vector<std::complex<T>>& fftOutputVec = fft.spectrumBuffer();
     
-    eigenFFT.fwd(fftOutputVec, corValVec);
+    fft.forward(corValVec, fftOutputVec);
     
     size_t halfFFTDataSize(fftDataSize/2 + 1);
     
@@ -177,7 +176,7 @@ template <class T> void RawDigitFFTAlg<T>::getFFTCorrection(std::vector<T>& corV
         
         std::vector<T> tmpVec(corValVec.size());
         
-        eigenFFT.inv(tmpVec, fftOutputVec);
+        fft.inverse(fftOutputVec, tmpVec);
         
         std::transform(corValVec.begin(),corValVec.end(),tmpVec.begin(),corValVec.begin(),std::minus<T>());
     }
@@ -191,18 +190,18 @@ template<class T> void RawDigitFFTAlg<T>::getFFTCorrection(std::vector<T>& corVa
     // cutoff frequency defined by maxBin passed in above
     size_t const fftDataSize = corValVec.size();
     
-    Eigen::FFT<T> eigenFFT;
+    // The plans of this thread for this size are made only once, and the transforms are real to complex
+    icarus::RealFFTPlan<T>&       fft          = icarus::FFTPlanCache<T>::threadCache().plan(fftDataSize);
+    std::vector<std::complex<T>>& fftOutputVec = fft.spectrumBuffer();
     
-    std::vector<std::complex<T>> fftOutputVec(corValVec.size());
-    
-    eigenFFT.fwd(fftOutputVec, corValVec);
+    fft.forward(corValVec, fftOutputVec);
     
     size_t halfFFTDataSize(fftDataSize/2);
 
-    std::fill(fftOutputVec.begin() + maxBin,     fftOutputVec.begin() + halfFFTDataSize, std::complex<T>(0.,0.));
-    std::fill(fftOutputVec.end()   - maxBin - 1, fftOutputVec.end(),                     std::complex<T>(0.,0.));
+    // Only the non-redundant half of the spectrum is kept, the inverse transform takes care of the other one
+    if (maxBin < halfFFTDataSize) std::fill(fftOutputVec.begin() + maxBin, fftOutputVec.begin() + halfFFTDataSize, std::complex<T>(0.,0.));
 
-    eigenFFT.inv(corValVec, fftOutputVec);
+    fft.inverse(fftOutputVec, corValVec);
 
     return;
 }
@@ -223,9 +222,9 @@ template <class T> void RawDigitFFTAlg<T>::filterFFT(detinfo::DetectorClocksData
     
     std::transform(rawadc.begin(),rawadc.end(),fFFTInputVec.begin(),[pedestal](const auto& val){return float(float(val) - pedestal);});
     
-    if (fFFTOutputVec.size() != fftDataSize) fFFTOutputVec.resize(fftDataSize);
+    icarus::RealFFTPlan<float>& fft = icarus::FFTPlanCache<float>::threadCache().plan(fftDataSize);
 
-    fEigenFFT->fwd(fFFTOutputVec,fFFTInputVec);
+    fft.forward(fFFTInputVec, fFFTOutputVec);
     
     size_t halfFFTDataSize(fftDataSize/2 + 1);
 
@@ -253,9 +252,8 @@ template <class T> void RawDigitFFTAlg<T>::filterFFT(detinfo::DetectorClocksData
     
     std::transform(fFFTOutputVec.begin(), fFFTOutputVec.begin() + halfFFTDataSize, filterVec.begin(), fFFTOutputVec.begin(), std::multiplies<std::complex<float>>());
 
-    for(size_t idx = 1; idx < fFFTOutputVec.size()/2; idx++) fFFTOutputVec[fFFTOutputVec.size() - idx] = fFFTOutputVec[idx];
-
-    fEigenFFT->inv(fFFTInputVec, fFFTOutputVec);
+    // The spectrum of the real to complex transform has only the non-redundant half
+    fft.inverse(fFFTOutputVec, fFFTInputVec);
 
     // Fill hists
     if (fFillHistograms)
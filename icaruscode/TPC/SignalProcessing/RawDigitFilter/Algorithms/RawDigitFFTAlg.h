@@ -28,9 +28,6 @@
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "icarus_signal_processing/WaveformTools.h"
 
-#include <Eigen/Core>
-#include <unsupported/Eigen/FFT>
-
 #include "TProfile.h"
 
 namespace icarus_tool
@@ -71,7 +68,7 @@ private:
     std::vector<size_t>                                    fLoWireByPlane;         ///< Low wire for individual wire histograms
     std::vector<size_t>                                    fHiWireByPlane;         ///< Hi wire for individual wire histograms
     
-    // Try to optimize the filter FFT function with static memory...
+    // Try to optimize the filter FFT function with static memory (the FFT plans are cached by each thread)...
     std::map<size_t,std::vector<std::complex<float>>>      fFilterVecMap;
     std::vector<float>                                     fFFTInputVec;
     std::vector<std::complex<float>>                       fFFTOutputVec;
@@ -84,8 +81,6 @@ private:
 
     icarus_signal_processing::WaveformTools<T>                        fWaveformTool;
     std::map<size_t,std::unique_ptr<icarus_tool::IFilter>> fFilterToolMap;
-    
-    std::unique_ptr<Eigen::FFT<float>>                     fEigenFFT;
 
     // Useful services, keep copies for now (we can update during begin run periods)
 };
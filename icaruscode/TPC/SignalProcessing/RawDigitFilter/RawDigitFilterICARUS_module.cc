@@ -53,8 +53,6 @@
 #include "larevt/CalibrationDBI/Interface/DetPedestalProvider.h"
 #include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
 #include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
-#include "lardata/Utilities/LArFFTWPlan.h"
-#include "lardata/Utilities/LArFFTW.h"
 
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/RawDigitNoiseFilterDefs.h"
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/RawDigitBinAverageAlg.h"
@@ -62,13 +60,11 @@
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/RawDigitCorrelatedCorrectionAlg.h"
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/IRawDigitFilter.h"
 #include "icaruscode/TPC/Utilities/tools/IFilter.h"
+#include "icaruscode/TPC/Utilities/FFTPlanCache.h"
 
 #include "lardataobj/RawData/RawDigit.h"
 #include "lardataobj/RawData/raw.h"
 
-#include <Eigen/Core>
-#include <unsupported/Eigen/FFT>
-
 
 class RawDigitFilterICARUS : public art::ReplicatedProducer
 {
@@ -294,9 +290,6 @@ void RawDigitFilterICARUS::produce(art::Event & event, art::ProcessingFrame cons
             }
         }
 
-        // .. Now set up the fftw plan
-        util::LArFFTWPlan lfftwp(fftSize,"ES");
-
         // Declare a temporary digit holder and resize it if downsizing the waveform
         caldata::RawDigitVector tempVec(fDataSize);
 
@@ -376,16 +369,9 @@ void RawDigitFilterICARUS::produce(art::Event & event, art::ProcessingFrame cons
 
                 std::transform(rawadc.begin(),rawadc.end(),holder.begin(),[pedestal](const auto& val){return float(float(val) - pedestal);});
 
-                // .. Do the correction
-                Eigen::FFT<icarusutil::SigProcPrecision> eigenFFT;
-
-                icarusutil::FrequencyVec holderFFT(rawadc.size());
-
-                eigenFFT.fwd(holderFFT, holder);
-
-                std::transform(fFilterVec.at(plane).begin(),fFilterVec.at(plane).end(),holderFFT.begin(),holderFFT.begin(),std::multiplies<std::complex<double>>());
+                // .. Do the correction (with the plans kept by this thread for this size)
+                icarus::FFTPlanCache<icarusutil::SigProcPrecision>::threadCache().plan(fftSize).convolute(holder, fFilterVec.at(plane));
 
-                eigenFFT.inv(holder, holderFFT);
                // .. Restore the pedestal
                 std::transform(holder.begin(), holder.end(), rawadc.begin(), [pedestal](const float& adc){return std::round(adc + pedestal);});
             }
@@ -468,7 +454,7 @@ void RawDigitFilterICARUS::produce(art::Event & event, art::ProcessingFrame cons
                                                          skewnessWireVec,
                                                          neighborRatioWireVec,
                                                          pedCorWireVec,
-                                                         fftSize, halfFFTSize, lfftwp.fPlan, lfftwp.rPlan);
+                                                         fftSize, halfFFTSize);
                 }
 
                 // One more pass through to store the good channels
@@ -20,8 +20,6 @@
 #include "larcore/Geometry/Geometry.h"
 #include "larevt/CalibrationDBI/Interface/DetPedestalService.h"
 #include "larevt/CalibrationDBI/Interface/DetPedestalProvider.h"
-#include "lardata/Utilities/LArFFTWPlan.h"
-#include "lardata/Utilities/LArFFTW.h"
 
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/RawDigitNoiseFilterDefs.h"
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/RawDigitBinAverageAlg.h"
@@ -30,6 +28,7 @@
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/IRawDigitFilter.h"
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/ChannelGroups.h"
 #include "icaruscode/TPC/Utilities/tools/IFilter.h"
+#include "icaruscode/TPC/Utilities/FFTPlanCache.h"
 
 #include "lardataobj/RawData/RawDigit.h"
 #include "lardataobj/RawData/raw.h"
@@ -80,14 +79,14 @@ public:
     virtual void produce(art::Event & e, art::ProcessingFrame const& frame);
     virtual void beginJob(art::ProcessingFrame const& frame);
     virtual void endJob(art::ProcessingFrame const& frame);
-    void WaveformChar(unsigned int i, unsigned int& fDataSize, unsigned int& fftsize, void* fplan, void* rplan,
+    void WaveformChar(unsigned int i, unsigned int& fDataSize, unsigned int& fftsize,
                       vector<GroupWireDigIndx>& igwvec,
                       std::vector<const raw::RawDigit*>& rawDigitVec,
                       vector<vector<caldata::RawDigitVector>>& rawadcgvec,
                       vector<vector<WireChar>>& wgcvec,
                       vector<vector<vector <int>>>& wgqvec,
                       std::unique_ptr<std::vector<raw::RawDigit> >& filteredRawDigit)const;
-    void RemoveCorrelatedNoise(unsigned int igrp, unsigned int& fftSize, unsigned int& halfFFTSize, void* fplan, void* rplan,
+    void RemoveCorrelatedNoise(unsigned int igrp, unsigned int& fftSize, unsigned int& halfFFTSize,
                                vector<vector<caldata::RawDigitVector>>& rawadcgvec,
                                vector<vector<WireChar>>& wgcvec,
                                vector<vector<vector <int>>>& wgqvec,
@@ -153,7 +152,6 @@ class lartbb_WaveformChar {
     lartbb_WaveformChar(RawDigitFilterICARUS const & prod,
       unsigned int & fdatasize,
       unsigned int & fftsize,
-      void* fplan, void* rplan,
       vector<GroupWireDigIndx>& igwv,
       std::vector<const raw::RawDigit*>& rawdigitvec,
       vector<vector<caldata::RawDigitVector>>& rawadcgv,
@@ -163,8 +161,6 @@ class lartbb_WaveformChar {
       : prod(prod),
         fDataSize(fdatasize),
         fftSize(fftsize),
-        fplan(fplan),
-        rplan(rplan),
         igwvec(igwv),
         rawDigitVec(rawdigitvec),
         rawadcgvec(rawadcgv),
@@ -174,14 +170,12 @@ class lartbb_WaveformChar {
     void operator()(const tbb::blocked_range<size_t>& range) const{
       //std::cout << " !!!!!!!!!! range.begin(): " << range.begin() << " and range.end(): " << range.end() << std::endl;
       for (size_t i = range.begin(); i < range.end(); ++i)
-        prod.WaveformChar(i, fDataSize, fftSize, fplan, rplan, igwvec, rawDigitVec, rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
+        prod.WaveformChar(i, fDataSize, fftSize, igwvec, rawDigitVec, rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
     }
   private:
     RawDigitFilterICARUS const & prod;
     unsigned int & fDataSize;
     unsigned int & fftSize;
-    void* fplan;
-    void* rplan;
     vector<GroupWireDigIndx>& igwvec;
     std::vector<const raw::RawDigit*>& rawDigitVec;
     vector<vector<caldata::RawDigitVector>>& rawadcgvec;
@@ -196,7 +190,6 @@ class lartbb_RemoveCorrelatedNoise {
     lartbb_RemoveCorrelatedNoise(RawDigitFilterICARUS const & prod,
       unsigned int & fftsize,
       unsigned int & halffftsize,
-      void* fplan, void* rplan,
       vector<vector<caldata::RawDigitVector>>& rawadcgv,
       vector<vector<WireChar>>& wgcv,
       vector<vector<vector <int>>>& wgqv,
@@ -204,22 +197,18 @@ class lartbb_RemoveCorrelatedNoise {
       : prod(prod),
         fftSize(fftsize),
         halfFFTSize(halffftsize),
-        fplan(fplan),
-        rplan(rplan),
         rawadcgvec(rawadcgv),
         wgcvec(wgcv),
         wgqvec(wgqv),
         filteredRawDigit(filteredrawdigit){}
     void operator()(const tbb::blocked_range<size_t>& range) const{
       for (size_t i = range.begin(); i < range.end(); ++i)
-        prod.RemoveCorrelatedNoise(i, fftSize, halfFFTSize, fplan, rplan, rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
+        prod.RemoveCorrelatedNoise(i, fftSize, halfFFTSize, rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
     }
   private:
     RawDigitFilterICARUS const & prod;
     unsigned int & fftSize;
     unsigned int & halfFFTSize;
-    void* fplan;
-    void* rplan;
     vector<vector<caldata::RawDigitVector>>& rawadcgvec;
     vector<vector<WireChar>>& wgcvec;
     vector<vector<vector <int>>>& wgqvec;
@@ -450,16 +439,13 @@ void RawDigitFilterICARUS::produce(art::Event & event, art::ProcessingFrame cons
         fFilterVec[plne] = fFilterToolMap.at(plne)->getResponseVec();
     }
 
-    // .. Now set up the fftw plan
-    util::LArFFTWPlan lfftwp(fftSize,"ES");
-
     //int nwavedump = 0;
 
     //for (std::size_t i=0; i<igwvec.size(); i++){
     //  WaveformChar(i, fDataSize, igwvec, rawDigitVec, rawadcgvec, wgcvec, filteredRawDigit);
     //}
     // ... Launch multiple threads with TBB to do the waveform characterization and fft correction in parallel
-    auto func = lartbb_WaveformChar(*this, fDataSize, fftSize, lfftwp.fPlan, lfftwp.rPlan, igwvec, rawDigitVec,
+    auto func = lartbb_WaveformChar(*this, fDataSize, fftSize, igwvec, rawDigitVec,
                                     rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
     tbb::parallel_for(tbb::blocked_range<size_t>(0, igwvec.size()), func);
 
@@ -471,10 +457,10 @@ void RawDigitFilterICARUS::produce(art::Event & event, art::ProcessingFrame cons
 
       // .. Loop over each group of wires
       //for (size_t igrp = 0; igrp < wgcvec.size(); igrp++) {
-      //  RemoveCorrelatedNoise(igrp, fftSize, halfFFTSize, lfftwp.fPlan, lfftwp.rPlan, rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
+      //  RemoveCorrelatedNoise(igrp, fftSize, halfFFTSize, rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
       //} // loop over igrp
-      auto func = lartbb_RemoveCorrelatedNoise(*this, fftSize, halfFFTSize, lfftwp.fPlan, lfftwp.rPlan,
-                                               rawadcgvec, wgcvec, wgqvec, filteredRawDigit);
+      auto func = lartbb_RemoveCorrelatedNoise(*this, fftSize, halfFFTSize, rawadcgvec,
+                                               wgcvec, wgqvec, filteredRawDigit);
       tbb::parallel_for(tbb::blocked_range<size_t>(0, wgcvec.size()), func);
     } // if do and smooth correlated noise
 
@@ -496,7 +482,7 @@ void RawDigitFilterICARUS::produce(art::Event & event, art::ProcessingFrame cons
 }
 
 //----------------------------------------------------------------------------
-void RawDigitFilterICARUS::RemoveCorrelatedNoise(unsigned int igrp, unsigned int& fftSize, unsigned int& halfFFTSize, void* fplan, void* rplan,
+void RawDigitFilterICARUS::RemoveCorrelatedNoise(unsigned int igrp, unsigned int& fftSize, unsigned int& halfFFTSize,
                                                  vector<vector<caldata::RawDigitVector>>& rawadcgvec,
                                                  vector<vector<WireChar>>& wgcvec,
                                                  vector<vector<vector <int>>>& wgqvec,
@@ -588,9 +574,10 @@ void RawDigitFilterICARUS::RemoveCorrelatedNoise(unsigned int igrp, unsigned int
 
     // ... Get the FFT correction
     if (fApplyFFTCorrection) {
+      // .. the plans of this thread are reused from group to group
+      icarus::RealFFTPlan<double>& fft = icarus::FFTPlanCache<double>::threadCache().plan(fftSize);
       std::vector<std::complex<double>> fftOutputVec(halfFFTSize);
-      util::LArFFTW lfftw(fftSize, fplan, rplan, 0);
-      lfftw.DoFFT(corValVec, fftOutputVec);
+      fft.forward(corValVec, fftOutputVec);
 
       std::vector<double> powerVec(halfFFTSize);
       std::transform(fftOutputVec.begin(), fftOutputVec.begin() + halfFFTSize, powerVec.begin(), [](const auto& val){return std::abs(val);});
@@ -630,7 +617,7 @@ void RawDigitFilterICARUS::RemoveCorrelatedNoise(unsigned int igrp, unsigned int
       
           std::vector<double> tmpVec(corValVec.size());
       
-          lfftw.DoInvFFT(fftOutputVec, tmpVec);
+          fft.inverse(fftOutputVec, tmpVec);
       
           std::transform(corValVec.begin(),corValVec.end(),tmpVec.begin(),corValVec.begin(),std::minus<double>());
       }
@@ -696,7 +683,7 @@ void RawDigitFilterICARUS::RemoveCorrelatedNoise(unsigned int igrp, unsigned int
 }
 
 //----------------------------------------------------------------------------
-void RawDigitFilterICARUS::WaveformChar(unsigned int i, unsigned int& fDataSize, unsigned int& fftSize, void* fplan, void* rplan,
+void RawDigitFilterICARUS::WaveformChar(unsigned int i, unsigned int& fDataSize, unsigned int& fftSize,
                                         vector<GroupWireDigIndx>& igwvec,
                                         std::vector<const raw::RawDigit*>& rawDigitVec,
                                         vector<vector<caldata::RawDigitVector>>& rawadcgvec,
@@ -729,16 +716,8 @@ void RawDigitFilterICARUS::WaveformChar(unsigned int i, unsigned int& fDataSize,
       std::vector<float> holder(fftSize);
       std::transform(rawADC.begin(),rawADC.end(),holder.begin(),[pedestal](const auto& val){return float(float(val) - pedestal);});
 
-      const icarusutil::FrequencyVec& filterVecPlane = fFilterVec.at(plane);
-
-      std::vector<std::complex<double>> filterVec(filterVecPlane.size());
-
-      for(size_t idx = 0; idx < filterVecPlane.size(); idx++) 
-          filterVec[idx] = filterVecPlane[idx];
-
-      // .. Do the correction
-      util::LArFFTW lfftw(fftSize, fplan, rplan, 0);
-      lfftw.Convolute(holder, filterVec);
+      // .. Do the correction (the filter is applied directly, the plans of this thread are reused)
+      icarus::FFTPlanCache<double>::threadCache().plan(fftSize).convolute(holder, fFilterVec.at(plane));
 
       // .. Restore the pedestal
       std::transform(holder.begin(), holder.end(), rawADC.begin(), [pedestal](const float& adc){return std::round(adc + pedestal);});
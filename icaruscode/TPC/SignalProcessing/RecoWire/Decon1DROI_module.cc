@@ -16,6 +16,9 @@
 #include <iomanip>
 #include <fstream>
 #include <random>
+#include <optional>
+#include <map>
+#include <numeric> // std::iota()
 
 // ROOT libraries
 #include "TH1D.h"
@@ -51,18 +54,16 @@
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IROIFinder.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IDeconvolution.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IBaseline.h"
+#include "icaruscode/TPC/Utilities/ChannelGeometryCache.h"
 #include "icarus_signal_processing/WaveformTools.h"
 
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 #include "tbb/task_arena.h"
-#include "tbb/spin_mutex.h"
 
 ///creation of calibrated signals on wires
 namespace caldata {
     
-tbb::spin_mutex deconvolutionSpinMutex;
-
 class Decon1DROI : public art::ReplicatedProducer
 {
   public:
@@ -77,36 +78,58 @@ class Decon1DROI : public art::ReplicatedProducer
     
   private:
 
+    // Output of the processing of a single RawDigit; each thread writes only in the slots of its own digits
+    struct ChannelOutput
+    {
+        std::optional<recob::Wire> wire;                ///< The wire, if any was made
+        size_t                     plane   = 0;         ///< Plane of the channel (for histograms)
+        float                      fullRMS = 0.;        ///< RMS of the deconvolved waveform (for histograms)
+        std::vector<size_t>        roiLengths;          ///< Length of the candidate ROIs (for histograms)
+        bool                       hasHistInfo = false; ///< Whether the histogram information is filled
+    };
+
+    // Work area of a channel, from its preparation to the deconvolution of its batch
+    struct ChannelWork
+    {
+        bool                                     ready    = false; ///< Whether the channel is to be deconvolved
+        raw::ChannelID_t                         channel  = 0;
+        float                                    rawNoise = 0.;
+        icarus_tool::IROIFinder::Waveform        waveform;         ///< Pedestal subtracted waveform
+        icarus_tool::IROIFinder::CandidateROIVec deconROIVec;      ///< Range to deconvolve (the full waveform)
+        recob::Wire::RegionsOfInterest_t         deconVec;         ///< The deconvolved waveform
+    };
+
     // Define a class to handle processing for individual threads
     class multiThreadDeconvolutionProcessing 
     {
     public:
         multiThreadDeconvolutionProcessing(Decon1DROI const&                        parent,
-                                           art::Event&                              event,
+                                           double                                   samplingRate,
                                            art::Handle<std::vector<raw::RawDigit>>& rawDigitHandle, 
-                                           std::vector<recob::Wire>&                wireColVec,
-                                           art::Assns<raw::RawDigit,recob::Wire>&   wireAssns,
-                                           std::string const&                       instance)
+                                           std::vector<ChannelOutput>&              outputVec)
             : fDecon1DROI(parent),
-              fEvent(event),
+              fSamplingRate(samplingRate),
               fRawDigitHandle(rawDigitHandle),
-              fWireColVec(wireColVec),
-              fWireAssns(wireAssns),
-              fInstance(instance)
+              fOutputVec(outputVec)
         {}
 
         void operator()(const tbb::blocked_range<size_t>& range) const
         {
-            for (size_t idx = range.begin(); idx < range.end(); idx++)
-                fDecon1DROI.processChannel(idx, fEvent, fRawDigitHandle, fWireColVec, fWireAssns, fInstance);
+            // The channels are deconvolved in batches, so that the tool can share the FFT work among them
+            for (size_t first = range.begin(); first < range.end(); first += fDecon1DROI.fChannelsPerBatch)
+            {
+                std::vector<size_t> digitIdxVec(std::min(range.end(), first + fDecon1DROI.fChannelsPerBatch) - first);
+                
+                std::iota(digitIdxVec.begin(), digitIdxVec.end(), first);
+                
+                fDecon1DROI.processBatch(digitIdxVec, fSamplingRate, fRawDigitHandle, fOutputVec);
+            }
         }
     private:
         const Decon1DROI&                        fDecon1DROI;
-        art::Event&                              fEvent;
+        double                                   fSamplingRate;
         art::Handle<std::vector<raw::RawDigit>>& fRawDigitHandle;
-        std::vector<recob::Wire>&                fWireColVec;
-        art::Assns<raw::RawDigit,recob::Wire>&   fWireAssns;
-        std::string                              fInstance;
+        std::vector<ChannelOutput>&              fOutputVec;
     };
 
     // It seems there are pedestal shifts that need correcting
@@ -114,13 +137,23 @@ class Decon1DROI : public art::ReplicatedProducer
     
     float getTruncatedRMS(const std::vector<float>&) const;
 
-    // Function to do the work
-    void  processChannel(size_t,
-                         art::Event&,
+    // Functions to do the work
+    void  processBatch(const std::vector<size_t>&,
+                       double,
+                       art::Handle<std::vector<raw::RawDigit>>,
+                       std::vector<ChannelOutput>&) const;
+    
+    void  prepareChannel(size_t,
                          art::Handle<std::vector<raw::RawDigit>>, 
-                         std::vector<recob::Wire>&, 
-                         art::Assns<raw::RawDigit,recob::Wire>&,
-                         const std::string&) const;
+                         ChannelWork&) const;
+    
+    void  finishChannel(size_t,
+                        art::Handle<std::vector<raw::RawDigit>>, 
+                        ChannelWork&,
+                        ChannelOutput&) const;
+    
+    // Fills the histograms with the information of the processed channels, in digit order
+    void  fillHistograms(const std::vector<ChannelOutput>&) const;
     
     std::vector<art::InputTag>                                 fRawDigitLabelVec;           ///< Contains the input tags for finding RawDigits
                                                                                             ///< it is set by the DigitModuleLabel
@@ -133,6 +166,7 @@ class Decon1DROI : public art::ReplicatedProducer
     float                                                      fTruncRMSThreshold;          ///< Calculate RMS up to this threshold...
     float                                                      fTruncRMSMinFraction;        ///< or at least this fraction of time bins
     bool                                                       fOutputHistograms;           ///< Output histograms?
+    size_t                                                     fChannelsPerBatch;           ///< Channels given to the deconvolution at once (0: a whole plane)
     
     std::vector<std::unique_ptr<icarus_tool::IROIFinder>>      fROIFinderVec;               ///< ROI finders per plane
     std::unique_ptr<icarus_tool::IDeconvolution>               fDeconvolution;
@@ -143,6 +177,7 @@ class Decon1DROI : public art::ReplicatedProducer
     const geo::GeometryCore*                                   fGeometry        = lar::providerFrom<geo::Geometry>();
     const lariov::ChannelStatusProvider*                       fChannelFilter   = lar::providerFrom<lariov::ChannelStatusService>();
     const lariov::DetPedestalProvider*                         fPedRetrievalAlg = lar::providerFrom<lariov::DetPedestalService>();
+    const icarus::ChannelGeometryCache&                        fChannelGeometry = icarus::ChannelGeometryCache::shared(*fGeometry);
     
     // Define here a temporary set of histograms...
     std::vector<TH1F*>     fPedestalOffsetVec;
@@ -183,6 +218,7 @@ void Decon1DROI::reconfigure(fhicl::ParameterSet const& pset)
     fTruncRMSThreshold    = pset.get< float                     > ("TruncRMSThreshold",              6.);
     fTruncRMSMinFraction  = pset.get< float                     > ("TruncRMSMinFraction",           0.6);
     fOutputHistograms     = pset.get< bool                      > ("OutputHistograms",             true);
+    fChannelsPerBatch     = pset.get< size_t                    > ("ChannelsPerBatch",               64);
     
     // Recover the vector of fhicl parameters for the ROI tools
     const fhicl::ParameterSet& roiFinderTools = pset.get<fhicl::ParameterSet>("ROIFinderToolVec");
@@ -284,13 +320,67 @@ void Decon1DROI::produce(art::Event& evt, art::ProcessingFrame const& frame)
             return;
         }
     
-        // Reserve the room for the output
-        wireCol->reserve(digitVecHandle->size());
+        // One output slot per digit, so the threads need no lock and the result does not depend on their scheduling
+        std::vector<ChannelOutput> outputVec(digitVecHandle->size());
+    
+        // The sampling rate is the same for all the channels of the event
+        auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
     
-        // ... Launch multiple threads with TBB to do the deconvolution and find ROIs in parallel
-        multiThreadDeconvolutionProcessing deconvolutionProcessing(*this, evt, digitVecHandle, *wireCol, *wireDigitAssn, rawDigitLabel.instance());
+        // A tool working on whole planes needs all the channels of a plane in a single batch...
+        if (!fChannelsPerBatch)
+        {
+            // ... and the planes are processed one after the other, so that only the work area of one plane is in memory
+            // (channels with no wire are not deconvolved, they share a batch with an invalid plane ID)
+            std::map<geo::PlaneID, std::vector<size_t>> planeDigitIdxMap;
+            
+            for(size_t idx = 0; idx < digitVecHandle->size(); idx++)
+            {
+                raw::ChannelID_t channel = digitVecHandle->at(idx).Channel();
+                
+                planeDigitIdxMap[fChannelGeometry.hasWire(channel) ? fChannelGeometry.planeID(channel) : geo::PlaneID()].push_back(idx);
+            }
+            
+            for(const auto& planeDigitIdx : planeDigitIdxMap)
+                processBatch(planeDigitIdx.second, sampling_rate(clockData), digitVecHandle, outputVec);
+        }
+        else
+        {
+            // ... otherwise launch multiple threads with TBB to do the deconvolution and find ROIs in parallel
+            multiThreadDeconvolutionProcessing deconvolutionProcessing(*this, sampling_rate(clockData), digitVecHandle, outputVec);
     
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, digitVecHandle->size()), deconvolutionProcessing);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, digitVecHandle->size()), deconvolutionProcessing);
+        }
+        
+        if (fOutputHistograms) fillHistograms(outputVec);
+        
+        // Collect the wires sorted by channel, and associate them with their digits
+        std::vector<size_t> digitOrder(outputVec.size());
+        
+        std::iota(digitOrder.begin(), digitOrder.end(), 0);
+        
+        std::stable_sort(digitOrder.begin(), digitOrder.end(), [&digitVecHandle](size_t left, size_t right){return digitVecHandle->at(left).Channel() < digitVecHandle->at(right).Channel();});
+        
+        wireCol->reserve(digitVecHandle->size());
+        
+        for(size_t idx : digitOrder)
+        {
+            std::optional<recob::Wire>& wire = outputVec[idx].wire;
+            
+            if (!wire) continue;
+            
+            wireCol->push_back(std::move(*wire));
+            
+            art::Ptr<raw::RawDigit> digitVec(digitVecHandle, idx);
+            
+            // add an association between the last object in wirecol
+            // (that we just inserted) and digitVec
+            if (!util::CreateAssn(evt, *wireCol, digitVec, *wireDigitAssn, rawDigitLabel.instance()))
+            {
+                throw art::Exception(art::errors::ProductRegistrationFailure)
+                    << "Can't associate wire #" << (wireCol->size() - 1)
+                    << " with raw digit #" << digitVec.key();
+            } // if failed to add association
+        }
         
         // Time to stroe everything
         if(wireCol->size() == 0)
@@ -309,9 +399,6 @@ void Decon1DROI::produce(art::Event& evt, art::ProcessingFrame const& frame)
                 }
             }
         }
-    
-        // Make sure the collection is sorted
-        std::sort(wireCol->begin(), wireCol->end(), [](const auto& left, const auto& right){return left.Channel() < right.Channel();});
        
         evt.put(std::move(wireCol), rawDigitLabel.instance());
         evt.put(std::move(wireDigitAssn), rawDigitLabel.instance());
@@ -388,20 +475,15 @@ float Decon1DROI::fixTheFreakingWaveform(const std::vector<float>& waveform, raw
     // Fill histograms
     if (fOutputHistograms)
     {
-        std::vector<geo::WireID> wids;
-        try
-        {
-           wids = fGeometry->ChannelToWire(channel);
-        }
-        catch(...)
+        if (!fChannelGeometry.hasWire(channel))
         {
             std::cout << "Caught exception looking up channel" << std::endl;
             return localRMS;
         }
     
         // Recover plane and wire in the plane
-        size_t plane = wids[0].Plane;
-        size_t wire  = wids[0].Wire;
+        size_t plane = fChannelGeometry.plane(channel);
+        size_t wire  = fChannelGeometry.wire(channel);
         
 //        float fullRMS = std::inner_product(locWaveform.begin(), locWaveform.end(), locWaveform.begin(), 0.);
         
@@ -418,17 +500,65 @@ float Decon1DROI::fixTheFreakingWaveform(const std::vector<float>& waveform, raw
     return localRMS;
 }
 
-void  Decon1DROI::processChannel(size_t                                  idx,
-                                 art::Event&                             event,
-                                 art::Handle<std::vector<raw::RawDigit>> digitVecHandle, 
-                                 std::vector<recob::Wire>&               wireColVec, 
-                                 art::Assns<raw::RawDigit,recob::Wire>&  wireAssns,
-                                 const std::string&                      instance) const
+void Decon1DROI::fillHistograms(const std::vector<ChannelOutput>& outputVec) const
 {
-    // vector that will be moved into the Wire object
-    recob::Wire::RegionsOfInterest_t deconVec;
-    recob::Wire::RegionsOfInterest_t ROIVec;
+    for(const ChannelOutput& output : outputVec)
+    {
+        if (!output.hasHistInfo) continue;
+        
+        fNumROIsHistVec.at(output.plane)->Fill(output.roiLengths.size(), 1.);
+        
+        for(size_t roiLen : output.roiLengths)
+            fROILenHistVec.at(output.plane)->Fill(roiLen, 1.);
+        
+        fFullRMSVec[output.plane]->Fill(output.fullRMS, 1.);
+    }
+    
+    return;
+}
 
+void Decon1DROI::processBatch(const std::vector<size_t>&              digitIdxVec,
+                              double                                  samplingRate,
+                              art::Handle<std::vector<raw::RawDigit>> digitVecHandle,
+                              std::vector<ChannelOutput>&             outputVec) const
+{
+    std::vector<ChannelWork>                   workVec(digitIdxVec.size());
+    icarus_tool::IDeconvolution::BatchChannelVec batch;
+    
+    // The channels of a batch are independent before and after the deconvolution (with a whole plane batch this is where the threads are)
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, digitIdxVec.size()),
+        [this, &digitIdxVec, &digitVecHandle, &workVec](const tbb::blocked_range<size_t>& range)
+        {
+            for(size_t workIdx = range.begin(); workIdx < range.end(); workIdx++) prepareChannel(digitIdxVec[workIdx], digitVecHandle, workVec[workIdx]);
+        });
+    
+    for(ChannelWork& work : workVec)
+    {
+        if (work.ready) batch.push_back({&work.waveform, work.channel, &work.deconROIVec, &work.deconVec});
+    }
+    
+    // Do the deconvolution on the full waveforms of the batch
+    fDeconvolution->DeconvolveBatch(batch, samplingRate);
+    
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, digitIdxVec.size()),
+        [this, &digitIdxVec, &digitVecHandle, &workVec, &outputVec](const tbb::blocked_range<size_t>& range)
+        {
+            for(size_t workIdx = range.begin(); workIdx < range.end(); workIdx++)
+            {
+                ChannelWork& work = workVec[workIdx];
+                size_t       idx  = digitIdxVec[workIdx];
+        
+                if (work.ready) finishChannel(idx, digitVecHandle, work, outputVec[idx]);
+            }
+        });
+    
+    return;
+}
+
+void  Decon1DROI::prepareChannel(size_t                                  idx,
+                                 art::Handle<std::vector<raw::RawDigit>> digitVecHandle, 
+                                 ChannelWork&                            work) const
+{
     // get the reference to the current raw::RawDigit
     art::Ptr<raw::RawDigit> digitVec(digitVecHandle, idx);
 
@@ -436,20 +566,16 @@ void  Decon1DROI::processChannel(size_t                                  idx,
     
     // The following test is meant to be temporary until the "correct" solution is implemented
     if (!fChannelFilter->IsPresent(channel)) return;
+    if (!fChannelGeometry.hasWire(channel)) return;
 
     // The waveforms should have been set to a 0. pedestal...
     float pedestal = 0.;
         
-    // Recover the plane info
-    std::vector<geo::WireID> wids = fGeometry->ChannelToWire(channel);
-    
     // skip bad channels
     if( fChannelFilter->Status(channel) < fMinAllowedChanStatus) return;
 
     size_t dataSize = digitVec->Samples();
     
-    const geo::PlaneID& planeID = wids[0].planeID();
-
     // vector holding uncompressed adc values
     std::vector<short> rawadc(dataSize);
     
@@ -470,13 +596,15 @@ void  Decon1DROI::processChannel(size_t                                  idx,
     
     
     // Get the pedestal subtracted data, centered in the deconvolution vector
-    std::vector<float> rawAdcLessPedVec(dataSize);
+    std::vector<float>& rawAdcLessPedVec = work.waveform;
+    
+    rawAdcLessPedVec.resize(dataSize);
     
     std::transform(rawadc.begin(),rawadc.end(),rawAdcLessPedVec.begin(),std::bind(std::minus<short>(),std::placeholders::_1,pedestal));
     
     // It seems there are deviations from the pedestal when using wirecell for noise filtering
     //float raw_noise = fixTheFreakingWaveform(rawAdcLessPedVec, channel, rawAdcLessPedVec);
-    float raw_noise = digitVec->GetSigma();
+    work.rawNoise = digitVec->GetSigma();
     
     // Recover a measure of the noise on the channel for use in the ROI finder
     //float raw_noise = getTruncatedRMS(rawAdcLessPedVec);
@@ -486,22 +614,38 @@ void  Decon1DROI::processChannel(size_t                                  idx,
 //        fWaveformTool->medianSmooth(rawAdcLessPedVec,rawAdcSmoothVec);
         
     // Make a dummy candidate roi vec
-    icarus_tool::IROIFinder::CandidateROIVec deconROIVec;
+    work.deconROIVec.push_back(icarus_tool::IROIFinder::CandidateROI(0,rawAdcLessPedVec.size() - 1));
     
-    deconROIVec.push_back(icarus_tool::IROIFinder::CandidateROI(0,rawAdcLessPedVec.size() - 1));
+    work.channel = channel;
+    work.ready   = true;
     
-    // Do the deconvolution on the full waveform
-    auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
-    fDeconvolution->Deconvolve(rawAdcLessPedVec, sampling_rate(clockData), channel, deconROIVec, deconVec);
+    return;
+}
+
+void  Decon1DROI::finishChannel(size_t                                  idx,
+                                art::Handle<std::vector<raw::RawDigit>> digitVecHandle, 
+                                ChannelWork&                            work,
+                                ChannelOutput&                          output) const
+{
+    // vector that will be moved into the Wire object
+    recob::Wire::RegionsOfInterest_t ROIVec;
+
+    // get the reference to the current raw::RawDigit
+    art::Ptr<raw::RawDigit> digitVec(digitVecHandle, idx);
+
+    raw::ChannelID_t channel = work.channel;
     
+    // Recover the plane info
+    const geo::PlaneID& planeID = fChannelGeometry.planeID(channel);
+
     // Recover the deconvolved waveform
-    const std::vector<float>& deconvolvedWaveform = deconVec.get_ranges().front().data();
+    const std::vector<float>& deconvolvedWaveform = work.deconVec.get_ranges().front().data();
 
     // vector of candidate ROI begin and end bins
     icarus_tool::IROIFinder::CandidateROIVec candRoiVec;
     
     // Now find the candidate ROI's
-    fROIFinderVec.at(planeID.Plane)->FindROIs(deconvolvedWaveform, channel, fEventCount, raw_noise, candRoiVec);
+    fROIFinderVec.at(planeID.Plane)->FindROIs(deconvolvedWaveform, channel, fEventCount, work.rawNoise, candRoiVec);
     
     std::vector<float> holder;
     
@@ -525,38 +669,25 @@ void  Decon1DROI::processChannel(size_t                                  idx,
         ROIVec.add_range(candROI.first, std::move(holder));
     }
 
-    // Make some histograms?
+    // Keep the information for the histograms, which are filled after all channels are processed
     if (fOutputHistograms)
     {
-        fNumROIsHistVec.at(planeID.Plane)->Fill(candRoiVec.size(), 1.);
+        output.plane       = planeID.Plane;
+        output.hasHistInfo = true;
         
         for(const auto& pair : candRoiVec)
-            fROILenHistVec.at(planeID.Plane)->Fill(pair.second-pair.first, 1.);
+            output.roiLengths.push_back(pair.second-pair.first);
     
         float fullRMS = std::inner_product(deconvolvedWaveform.begin(), deconvolvedWaveform.end(), deconvolvedWaveform.begin(), 0.);
     
-        fullRMS = std::sqrt(std::max(float(0.),fullRMS / float(deconvolvedWaveform.size())));
-
-        fFullRMSVec[planeID.Plane]->Fill(fullRMS, 1.);
+        output.fullRMS = std::sqrt(std::max(float(0.),fullRMS / float(deconvolvedWaveform.size())));
     }
 
     // Don't save empty wires
     if (ROIVec.empty()) return;
 
-    // First get a lock to make sure we are clear to run
-    tbb::spin_mutex::scoped_lock lock(deconvolutionSpinMutex);
-
-    // create the new wire directly in wirecol
-    wireColVec.push_back(recob::WireCreator(std::move(ROIVec),*digitVec).move());
-
-    // add an association between the last object in wirecol
-    // (that we just inserted) and digitVec
-    if (!util::CreateAssn(event, wireColVec, digitVec, wireAssns, instance))
-    {
-        throw art::Exception(art::errors::ProductRegistrationFailure)
-            << "Can't associate wire #" << (wireColVec.size() - 1)
-            << " with raw digit #" << digitVec.key();
-    } // if failed to add association
+    // create the new wire in the slot of this digit
+    output.wire = recob::WireCreator(std::move(ROIVec),*digitVec).move();
 
     return;
 }
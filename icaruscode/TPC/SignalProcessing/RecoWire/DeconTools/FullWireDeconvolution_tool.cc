@@ -14,14 +14,22 @@
 #include "larcore/Geometry/Geometry.h"
 #include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
 #include "icaruscode/TPC/Utilities/SignalShapingICARUSService_service.h"
+#include "icaruscode/TPC/Utilities/FFTPlanCache.h" // icarus::fftwPlannerMutex()
 
 #include "art/Utilities/make_tool.h"
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icarus_signal_processing/Filters/ICARUSFFT.h"
 
+#include "tbb/enumerable_thread_specific.h"
+
 #include "TH1D.h"
 
+#include "fftw3.h"
+
 #include <fstream>
+#include <complex>
+#include <algorithm>
+#include <mutex>
 
 namespace icarus_tool
 {
@@ -42,8 +50,76 @@ public:
                     IROIFinder::CandidateROIVec const&,
                     recob::Wire::RegionsOfInterest_t& )    const override;
     
+    void DeconvolveBatch(BatchChannelVec const&,
+                         double samplingRate)                const override;
+    
 private:
     
+    using FloatTimeVec      = std::vector<float>;
+    using FloatFrequencyVec = std::vector<std::complex<float>>;
+    
+    // Single precision FFTW plans transforming a block of channels at once
+    struct BatchPlans
+    {
+        BatchPlans(size_t size, size_t nChannels);
+        ~BatchPlans();
+        
+        BatchPlans(const BatchPlans&)            = delete;
+        BatchPlans& operator=(const BatchPlans&) = delete;
+        
+        size_t         fftSize;    ///< Samples of each channel
+        size_t         nChannels;  ///< Channels in the block
+        size_t         nFreq;      ///< Frequencies of each channel (`fftSize / 2 + 1`)
+        float*         timeBlock   = nullptr;  ///< Waveforms of the block, one after the other
+        fftwf_complex* freqBlock   = nullptr;  ///< Spectra of the block, one after the other
+        fftwf_plan     forwardPlan = nullptr;
+        fftwf_plan     inversePlan = nullptr;
+    };
+    
+    // Deconvolution kernel for the batched transforms
+    struct BatchKernel
+    {
+        std::vector<float> re;     ///< Real part (half spectrum, normalization and time offset included)
+        std::vector<float> im;     ///< Imaginary part (half spectrum, normalization and time offset included)
+    };
+    
+    // FFT plans and buffers of a single thread, so that threads never share them
+    struct FFTWorkspace
+    {
+        size_t                                                       fftSize = 0;
+        std::unique_ptr<icarus_signal_processing::ICARUSFFT<float>>  floatFFT;
+        std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>> doubleFFT;
+        FloatTimeVec                                                 floatVec;
+        std::map<const IResponse*, FloatFrequencyVec>                floatKernels;  ///< Kernels converted to single precision
+        std::unique_ptr<BatchPlans>                                  batchPlans;
+        std::map<const IResponse*, BatchKernel>                      batchKernels;  ///< Kernels for the batched transforms
+        
+        // Prepares the plans for the specified size (noop if already done)
+        void setSize(size_t size, bool singlePrecision, bool doublePrecision);
+        
+        // Prepares the batched plans for the current size (noop if already done)
+        void setBatchSize(size_t nChannels);
+        
+        // Returns the single precision copy of the deconvolution kernel of the response
+        const FloatFrequencyVec& floatKernel(const IResponse& response);
+        
+        // Returns the kernel of the response for the batched transforms
+        const BatchKernel& batchKernel(const IResponse& response, int timeOffset);
+    };
+    
+    // Deconvolutes in single precision, optionally comparing with double precision
+    void deconvoluteSinglePrecision(FFTWorkspace&, icarusutil::TimeVec&, const IResponse&, int, raw::ChannelID_t) const;
+    
+    // Deconvolutes the channels of a batch sharing the same response and waveform size
+    void deconvoluteBatchGroup(FFTWorkspace&, const std::vector<const BatchChannel*>&, double) const;
+    
+    // Warns if the single precision result differs too much from the double precision one
+    void checkSinglePrecision(raw::ChannelID_t, const icarusutil::TimeVec&, const FloatTimeVec&) const;
+    
+    // Copies the candidate ROI's from the deconvolved waveform, with normalization and calibration
+    template <typename Waveform>
+    void extractROIs(const Waveform&, raw::ChannelID_t, IROIFinder::CandidateROIVec const&, recob::Wire::RegionsOfInterest_t&) const;
+    
     // Member variables from the fhicl file
     bool                                                         fDodQdxCalib;                ///< Do we apply wire-by-wire calibration?
     std::string                                                  fdQdxCalibFileName;          ///< Text file for constants to do wire-by-wire calibration
@@ -51,7 +127,12 @@ private:
 
     icarus_signal_processing::WaveformTools<float>               fWaveformTool;
 
-    std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>> fFFT;                        ///< Object to handle thread safe FFT
+    bool                                                         fSinglePrecisionFFT;         ///< Deconvolute in single precision?
+    bool                                                         fValidateSinglePrecision;    ///< Compare single with double precision result?
+    double                                                       fSinglePrecisionTolerance;   ///< Tolerance relative to the largest deconvoluted value
+    size_t                                                       fBatchSize;                  ///< Channels transformed together (single precision only)
+
+    mutable tbb::enumerable_thread_specific<FFTWorkspace>        fWorkspaces;                 ///< FFT plans and buffers, one per thread
 
     const geo::GeometryCore*                                     fGeometry           = lar::providerFrom<geo::Geometry>();
     art::ServiceHandle<icarusutil::SignalShapingICARUSService>   fSignalShaping;
@@ -71,6 +152,11 @@ FullWireDeconvolution::~FullWireDeconvolution()
 void FullWireDeconvolution::configure(const fhicl::ParameterSet& pset)
 {
     // Start by recovering the parameters
+    fSinglePrecisionFFT       = pset.get< bool   >("SinglePrecisionFFT",       false);
+    fValidateSinglePrecision  = pset.get< bool   >("ValidateSinglePrecision",  false);
+    fSinglePrecisionTolerance = pset.get< double >("SinglePrecisionTolerance", 1.e-4);
+    fBatchSize                = pset.get< size_t >("BatchSize",                16   );
+    
     //wire-by-wire calibration
     fDodQdxCalib   = pset.get< bool >("DodQdxCalib", false);
     
@@ -106,13 +192,199 @@ void FullWireDeconvolution::configure(const fhicl::ParameterSet& pset)
     // Get signal shaping service.
     fSignalShaping = art::ServiceHandle<icarusutil::SignalShapingICARUSService>();
 
-    // Now set up our plans for doing the convolution
-    auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
-    fFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(detProp.NumberTimeSamples());
+    // The FFT plans are made by each thread on its first waveform, drop the old ones
+    fWorkspaces.clear();
      
     return;
 }
     
+void FullWireDeconvolution::FFTWorkspace::setSize(size_t size, bool singlePrecision, bool doublePrecision)
+{
+    if (size != fftSize)
+    {
+        floatFFT.reset();
+        doubleFFT.reset();
+        batchPlans.reset();
+        batchKernels.clear();
+        fftSize = size;
+    }
+    
+    if ((!singlePrecision || floatFFT) && (!doublePrecision || doubleFFT)) return;
+    
+    // The FFTW plans are made when the objects are created and on their first transform,
+    // and the FFTW planner must not run in more than one thread at a time
+    std::lock_guard<std::mutex> lock(icarus::fftwPlannerMutex());
+    
+    if (singlePrecision && !floatFFT)
+    {
+        floatFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<float>>(size);
+        
+        FloatTimeVec timeVec(size, 0.);
+        
+        floatFFT->deconvolute(timeVec, FloatFrequencyVec(size, std::complex<float>(1.,0.)), 0);
+    }
+    
+    if (doublePrecision && !doubleFFT)
+    {
+        doubleFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(size);
+        
+        icarusutil::TimeVec timeVec(size, 0.);
+        
+        doubleFFT->deconvolute(timeVec, icarusutil::FrequencyVec(size, std::complex<double>(1.,0.)), 0);
+    }
+    
+    return;
+}
+    
+void FullWireDeconvolution::FFTWorkspace::setBatchSize(size_t nChannels)
+{
+    if (batchPlans && batchPlans->nChannels == nChannels) return;
+    
+    batchPlans.reset();
+    batchPlans = std::make_unique<BatchPlans>(fftSize, nChannels);
+    
+    return;
+}
+    
+FullWireDeconvolution::BatchPlans::BatchPlans(size_t size, size_t nChannels)
+    : fftSize(size), nChannels(nChannels), nFreq(size / 2 + 1)
+{
+    std::lock_guard<std::mutex> lock(icarus::fftwPlannerMutex());
+    
+    int n = fftSize;
+    
+    // FFTW allocation guarantees the alignment needed by the SIMD transforms
+    timeBlock = fftwf_alloc_real(nChannels * fftSize);
+    freqBlock = fftwf_alloc_complex(nChannels * nFreq);
+    
+    if (timeBlock && freqBlock)
+    {
+        forwardPlan = fftwf_plan_many_dft_r2c(1, &n, nChannels, timeBlock, nullptr, 1, fftSize, freqBlock, nullptr, 1, nFreq, FFTW_ESTIMATE);
+        inversePlan = fftwf_plan_many_dft_c2r(1, &n, nChannels, freqBlock, nullptr, 1, nFreq, timeBlock, nullptr, 1, fftSize, FFTW_ESTIMATE);
+    }
+    
+    // The destructor is not called if the constructor throws, so clean up here
+    if (!forwardPlan || !inversePlan)
+    {
+        if (forwardPlan) fftwf_destroy_plan(forwardPlan);
+        if (inversePlan) fftwf_destroy_plan(inversePlan);
+        
+        fftwf_free(timeBlock);
+        fftwf_free(freqBlock);
+        
+        throw cet::exception("FullWireDeconvolution") << "Can't create batched FFT plans for " << nChannels << " channels of " << fftSize << " samples\n";
+    }
+}
+    
+FullWireDeconvolution::BatchPlans::~BatchPlans()
+{
+    std::lock_guard<std::mutex> lock(icarus::fftwPlannerMutex());
+    
+    if (forwardPlan) fftwf_destroy_plan(forwardPlan);
+    if (inversePlan) fftwf_destroy_plan(inversePlan);
+    
+    fftwf_free(timeBlock);
+    fftwf_free(freqBlock);
+}
+    
+const FullWireDeconvolution::BatchKernel& FullWireDeconvolution::FFTWorkspace::batchKernel(const IResponse& response, int timeOffset)
+{
+    auto kernelItr = batchKernels.find(&response);
+    
+    if (kernelItr != batchKernels.end()) return kernelItr->second;
+    
+    BatchKernel& kernel = batchKernels[&response];
+    
+    // The batched transforms must reproduce the single channel deconvolution:
+    // - the inverse transform from FFTW is not normalized, so the kernel includes 1/N
+    // - the result is delayed by the time offset, which is a phase ramp exp(-2 pi i k offset / N)
+    const FloatFrequencyVec& deconvKernel = floatKernel(response);
+    size_t                   nFreq        = fftSize / 2 + 1;
+    long long                offset       = timeOffset % static_cast<long long>(fftSize);
+    
+    if (offset < 0) offset += fftSize;
+
+    if (deconvKernel.size() < nFreq)
+        throw cet::exception("FullWireDeconvolution") << "Deconvolution kernel has " << deconvKernel.size() << " frequencies, " << nFreq << " needed for " << fftSize << " samples\n";
+
+    kernel.re.resize(nFreq);
+    kernel.im.resize(nFreq);
+    
+    // The waveforms are real, so half of the spectrum is enough
+    for(size_t idx = 0; idx < nFreq; idx++)
+    {
+        // Reduce the phase to a single turn before converting, to keep the precision at high frequency
+        double               phase  = -2. * M_PI * double((idx * offset) % fftSize) / double(fftSize);
+        std::complex<double> factor = std::polar(1. / double(fftSize), phase) * std::complex<double>(deconvKernel[idx]);
+        
+        kernel.re[idx] = factor.real();
+        kernel.im[idx] = factor.imag();
+    }
+    
+    return kernel;
+}
+    
+const FullWireDeconvolution::FloatFrequencyVec& FullWireDeconvolution::FFTWorkspace::floatKernel(const IResponse& response)
+{
+    FloatFrequencyVec& kernel = floatKernels[&response];
+    
+    if (kernel.empty())
+    {
+        const icarusutil::FrequencyVec& deconvKernel = response.getDeconvKernel();
+        
+        kernel.resize(deconvKernel.size());
+        
+        std::transform(deconvKernel.begin(),deconvKernel.end(),kernel.begin(),[](const auto& val){return std::complex<float>(val);});
+    }
+    
+    return kernel;
+}
+    
+void FullWireDeconvolution::deconvoluteSinglePrecision(FFTWorkspace&        workspace,
+                                                       icarusutil::TimeVec& timeVec,
+                                                       const IResponse&     response,
+                                                       int                  timeOffset,
+                                                       raw::ChannelID_t     channel) const
+{
+    workspace.floatVec.resize(timeVec.size());
+    
+    std::copy(timeVec.begin(),timeVec.end(),workspace.floatVec.begin());
+    
+    workspace.floatFFT->deconvolute(workspace.floatVec, workspace.floatKernel(response), timeOffset);
+    
+    // In validation mode the double precision result is computed as reference
+    if (fValidateSinglePrecision)
+    {
+        workspace.doubleFFT->deconvolute(timeVec, response.getDeconvKernel(), timeOffset);
+        
+        checkSinglePrecision(channel, timeVec, workspace.floatVec);
+    }
+    
+    std::copy(workspace.floatVec.begin(),workspace.floatVec.end(),timeVec.begin());
+    
+    return;
+}
+    
+void FullWireDeconvolution::checkSinglePrecision(raw::ChannelID_t           channel,
+                                                 const icarusutil::TimeVec& reference,
+                                                 const FloatTimeVec&        result) const
+{
+    double maxValue(0.);
+    double maxDiff(0.);
+    
+    for(size_t idx = 0; idx < reference.size(); idx++)
+    {
+        maxValue = std::max(maxValue, std::abs(reference[idx]));
+        maxDiff  = std::max(maxDiff,  std::abs(reference[idx] - result[idx]));
+    }
+    
+    if (maxDiff > fSinglePrecisionTolerance * maxValue)
+        mf::LogWarning("FullWireDeconvolution") << "Channel " << channel << ": single precision deconvolution differs by " << maxDiff
+                                                << " from double precision (largest value: " << maxValue << ", tolerance: " << fSinglePrecisionTolerance << ")";
+    
+    return;
+}
+    
 void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        waveform,
                                        double const                       samplingRate,
                                        raw::ChannelID_t                   channel,
@@ -132,15 +404,152 @@ void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        wavefo
     icarusutil::TimeVec rawAdcLessPedVec(dataSize,0.);
     
     size_t binOffset    = 0; //transformSize > dataSize ? (transformSize - dataSize) / 2 : 0;
-    float  deconNorm       = fSignalShaping->GetDeconNorm();
-    float  normFactor      = 1. / deconNorm; // This is what we had previously: (samplingRate * deconNorm);
-    bool   applyNormFactor = std::abs(normFactor - 1.) > std::numeric_limits<float>::epsilon() ? true : false;
     
     // Copy the input (assumed pedestal subtracted) waveforms into our zero padded deconvolution buffer
     std::copy(waveform.begin(),waveform.end(),rawAdcLessPedVec.begin()+binOffset);
     
     // Strategy is to run deconvolution on the entire channel and then pick out the ROI's we found above
-    fFFT->deconvolute(rawAdcLessPedVec, fSignalShaping->GetResponse(channel).getDeconvKernel(), fSignalShaping->ResponseTOffset(channel));
+    // Each thread uses its own FFT plans and buffers
+    FFTWorkspace&    workspace  = fWorkspaces.local();
+    const IResponse& response   = fSignalShaping->GetResponse(channel);
+    int              timeOffset = fSignalShaping->ResponseTOffset(channel);
+    
+    workspace.setSize(dataSize, fSinglePrecisionFFT, !fSinglePrecisionFFT || fValidateSinglePrecision);
+    
+    if (fSinglePrecisionFFT) deconvoluteSinglePrecision(workspace, rawAdcLessPedVec, response, timeOffset, channel);
+    else                     workspace.doubleFFT->deconvolute(rawAdcLessPedVec, response.getDeconvKernel(), timeOffset);
+    
+    extractROIs(rawAdcLessPedVec, channel, roiVec, ROIVec);
+    
+    return;
+}
+    
+void FullWireDeconvolution::DeconvolveBatch(BatchChannelVec const& batch,
+                                            double const           samplingRate) const
+{
+    // The batched transforms are in single precision only
+    if (!fSinglePrecisionFFT || fBatchSize < 2)
+    {
+        IDeconvolution::DeconvolveBatch(batch, samplingRate);
+        return;
+    }
+    
+    // Group the channels sharing the response and the waveform size, hence the kernel and the plans
+    std::vector<std::pair<const IResponse*, size_t>>      groupKeys;
+    std::vector<std::vector<const BatchChannel*>>         groups;
+    
+    for(const BatchChannel& chan : batch)
+    {
+        std::pair<const IResponse*, size_t> key(&fSignalShaping->GetResponse(chan.channel), chan.waveform->size());
+        
+        size_t groupIdx = std::distance(groupKeys.begin(),std::find(groupKeys.begin(),groupKeys.end(),key));
+        
+        if (groupIdx == groupKeys.size())
+        {
+            groupKeys.push_back(key);
+            groups.emplace_back();
+        }
+        
+        groups[groupIdx].push_back(&chan);
+    }
+    
+    FFTWorkspace& workspace = fWorkspaces.local();
+    
+    for(const auto& group : groups) deconvoluteBatchGroup(workspace, group, samplingRate);
+    
+    return;
+}
+    
+void FullWireDeconvolution::deconvoluteBatchGroup(FFTWorkspace&                           workspace,
+                                                  const std::vector<const BatchChannel*>& group,
+                                                  double const                            samplingRate) const
+{
+    raw::ChannelID_t firstChannel = group.front()->channel;
+    size_t           dataSize     = group.front()->waveform->size();
+    
+    // Make sure the deconvolution size is set correctly (this will probably be a noop after first call)
+    fSignalShaping->SetDecon(samplingRate, dataSize, firstChannel);
+    
+    const IResponse& response   = fSignalShaping->GetResponse(firstChannel);
+    int              timeOffset = fSignalShaping->ResponseTOffset(firstChannel);
+    
+    workspace.setSize(dataSize, false, fValidateSinglePrecision);
+    workspace.setBatchSize(fBatchSize);
+    
+    const BatchKernel& kernel = workspace.batchKernel(response, timeOffset);
+    BatchPlans&        plans  = *workspace.batchPlans;
+    
+    icarusutil::TimeVec referenceVec;
+    
+    for(size_t first = 0; first < group.size(); first += plans.nChannels)
+    {
+        size_t nChannels = std::min(plans.nChannels, group.size() - first);
+        
+        // Copy the waveforms in the block, and clear the rows left unused
+        for(size_t row = 0; row < plans.nChannels; row++)
+        {
+            float* rowItr = plans.timeBlock + row * dataSize;
+            
+            if (row < nChannels) std::copy(group[first + row]->waveform->begin(),group[first + row]->waveform->end(),rowItr);
+            else                 std::fill(rowItr, rowItr + dataSize, 0.);
+        }
+        
+        fftwf_execute(plans.forwardPlan);
+        
+        // Multiply by the kernel, written out on the real and imaginary parts so that it vectorizes
+        const float* kernelRe = kernel.re.data();
+        const float* kernelIm = kernel.im.data();
+        
+        for(size_t row = 0; row < nChannels; row++)
+        {
+            float* freqItr = reinterpret_cast<float*>(plans.freqBlock + row * plans.nFreq);
+            
+            for(size_t idx = 0; idx < plans.nFreq; idx++)
+            {
+                float re = freqItr[2 * idx];
+                float im = freqItr[2 * idx + 1];
+                
+                freqItr[2 * idx]     = re * kernelRe[idx] - im * kernelIm[idx];
+                freqItr[2 * idx + 1] = re * kernelIm[idx] + im * kernelRe[idx];
+            }
+        }
+        
+        fftwf_execute(plans.inversePlan);
+        
+        for(size_t row = 0; row < nChannels; row++)
+        {
+            const BatchChannel& chan   = *group[first + row];
+            const float*        rowItr = plans.timeBlock + row * dataSize;
+            
+            // The time offset of the response is already applied by the kernel
+            workspace.floatVec.assign(rowItr, rowItr + dataSize);
+            
+            if (fValidateSinglePrecision)
+            {
+                referenceVec.assign(chan.waveform->begin(),chan.waveform->end());
+                
+                workspace.doubleFFT->deconvolute(referenceVec, response.getDeconvKernel(), timeOffset);
+                
+                checkSinglePrecision(chan.channel, referenceVec, workspace.floatVec);
+            }
+            
+            extractROIs(workspace.floatVec, chan.channel, *chan.roiVec, *chan.ROIVec);
+        }
+    }
+    
+    return;
+}
+    
+template <typename Waveform>
+void FullWireDeconvolution::extractROIs(const Waveform&                    deconvolvedVec,
+                                        raw::ChannelID_t                   channel,
+                                        IROIFinder::CandidateROIVec const& roiVec,
+                                        recob::Wire::RegionsOfInterest_t&  ROIVec) const
+{
+    size_t binOffset       = 0;
+    float  deconNorm       = fSignalShaping->GetDeconNorm();
+    float  normFactor      = 1. / deconNorm; // This is what we had previously: (samplingRate * deconNorm);
+    bool   applyNormFactor = std::abs(normFactor - 1.) > std::numeric_limits<float>::epsilon() ? true : false;
     
     std::vector<float> holder;
 
@@ -153,7 +562,7 @@ void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        wavefo
         
         holder.resize(roiLen);
         
-        std::copy(rawAdcLessPedVec.begin()+binOffset+roi.first, rawAdcLessPedVec.begin()+binOffset+roiLen, holder.begin());
+        std::copy(deconvolvedVec.begin()+binOffset+roi.first, deconvolvedVec.begin()+binOffset+roiLen, holder.begin());
         if (applyNormFactor) std::transform(holder.begin(),holder.end(),holder.begin(), std::bind(std::multiplies<float>(),std::placeholders::_1,normFactor));
         
         // Get the truncated mean and rms
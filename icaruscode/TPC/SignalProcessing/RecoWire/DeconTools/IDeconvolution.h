@@ -18,6 +18,8 @@
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IROIFinder.h"
 #include "lardataobj/RecoBase/Wire.h"
 
+#include <vector>
+
 namespace art
 {
     class TFileDirectory;
@@ -39,6 +41,25 @@ namespace icarus_tool
                                 raw::ChannelID_t,
                                 IROIFinder::CandidateROIVec const&,
                                 recob::Wire::RegionsOfInterest_t& ) const = 0;
+        
+        // A channel of a batch, with the same meaning as the arguments of Deconvolve
+        struct BatchChannel
+        {
+            const IROIFinder::Waveform*        waveform;
+            raw::ChannelID_t                   channel;
+            const IROIFinder::CandidateROIVec* roiVec;
+            recob::Wire::RegionsOfInterest_t*  ROIVec;
+        };
+        
+        using BatchChannelVec = std::vector<BatchChannel>;
+        
+        // Deconvolve many channels at once; by default they are deconvolved one by one
+        virtual void DeconvolveBatch(BatchChannelVec const& batch,
+                                     double samplingRate) const
+        {
+            for(const BatchChannel& chan : batch)
+                Deconvolve(*chan.waveform, samplingRate, chan.channel, *chan.roiVec, *chan.ROIVec);
+        }
     };
 }
 
@@ -0,0 +1,435 @@
+////////////////////////////////////////////////////////////////////////
+/// \file   PlaneImageDeconvolution.cc
+/// \brief  Deconvolution of whole plane images (wire x time)
+///
+/// The channels of each plane are put in an image, one row per wire,
+/// and deconvolved with a kernel in both the time and wire dimensions.
+/// The kernel is the product of the 1D response of the plane (in time)
+/// and of a wire kernel, which removes the induction on the neighbouring
+/// wires (NeighbourWireFractions) and applies a gaussian filter in the
+/// wire frequency (WireFilterSigma). Since the kernel factorizes, the 2D
+/// FFT is done one dimension at a time. The wire dimension is padded with
+/// empty wires so that the two edges of the image do not leak into each
+/// other (see PlaneWireKernel).
+///
+/// The batch must hold whole planes (Decon1DROI with ChannelsPerBatch 0
+/// hands the planes over one at a time). While a plane is processed, its
+/// channels have in memory their input waveform and their deconvolved
+/// waveform (both kept by the caller) and the plane image: that is about
+/// three floats per channel and tick of the plane.
+///
+/// With no neighbour fractions and no filter the wire dimension is left
+/// untouched, and the result is the same as the one of
+/// FullWireDeconvolution in single precision without batches (BatchSize
+/// below 2).
+////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IDeconvolution.h"
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/PlaneWireKernel.h"
+#include "art/Utilities/ToolMacros.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art_root_io/TFileService.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "cetlib_except/exception.h"
+#include "larcore/Geometry/Geometry.h"
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
+#include "icaruscode/TPC/Utilities/SignalShapingICARUSService_service.h"
+#include "icaruscode/TPC/Utilities/ChannelGeometryCache.h"
+#include "icaruscode/TPC/Utilities/FFTPlanCache.h" // icarus::fftwPlannerMutex()
+
+#include "icarus_signal_processing/WaveformTools.h"
+#include "icarus_signal_processing/Filters/ICARUSFFT.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+
+#include <complex>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace icarus_tool
+{
+
+class PlaneImageDeconvolution : public IDeconvolution
+{
+public:
+    explicit PlaneImageDeconvolution(const fhicl::ParameterSet& pset);
+
+    ~PlaneImageDeconvolution();
+
+    void configure(const fhicl::ParameterSet& pset)              override;
+    void initializeHistograms(art::TFileDirectory&)        const override;
+
+    // A single channel can't be deconvolved in the wire dimension: only the time one is done
+    void Deconvolve(IROIFinder::Waveform const&,
+                    double samplingRate,
+                    raw::ChannelID_t,
+                    IROIFinder::CandidateROIVec const&,
+                    recob::Wire::RegionsOfInterest_t& )    const override;
+
+    void DeconvolveBatch(BatchChannelVec const&,
+                         double samplingRate)                const override;
+
+private:
+
+    using FloatTimeVec      = std::vector<float>;
+    using FloatFrequencyVec = std::vector<std::complex<float>>;
+
+    // FFT plans and buffers of a single thread
+    struct FFTWorkspace
+    {
+        size_t                                                                     timeSize = 0;
+        std::unique_ptr<icarus_signal_processing::ICARUSFFT<float>>                timeFFT;
+        std::map<size_t, std::unique_ptr<icarus_signal_processing::ICARUSFFT<float>>> wireFFTs;     ///< By number of wires
+        std::map<const IResponse*, FloatFrequencyVec>                              timeKernels;  ///< Single precision kernels
+        FloatTimeVec                                                               wireVec;
+        FloatFrequencyVec                                                          wireFreqVec;
+
+        // Returns the FFT for the time dimension, of the specified size
+        icarus_signal_processing::ICARUSFFT<float>& timeTransform(size_t size);
+
+        // Returns the FFT for the wire dimension, of the specified size
+        icarus_signal_processing::ICARUSFFT<float>& wireTransform(size_t size);
+
+        // Returns the single precision copy of the deconvolution kernel of the response
+        const FloatFrequencyVec& timeKernel(const IResponse& response);
+    };
+
+    // The channels of a plane, by wire number, and their data
+    struct PlaneImage
+    {
+        geo::PlaneID                     planeID;
+        unsigned int                     firstWire = 0;
+        std::vector<const BatchChannel*> rows;        ///< Channel of each wire (null if not in the batch)
+        std::vector<FloatTimeVec>        data;        ///< Waveform of each wire
+        std::vector<float>               wireKernel;  ///< Kernel in wire frequency (real), padding included
+    };
+
+    // Deconvolves the waveform of a channel in the time dimension
+    void deconvolveTime(FFTWorkspace&, const IROIFinder::Waveform&, raw::ChannelID_t, double, FloatTimeVec&) const;
+
+    // Deconvolves all the ticks of an image in the wire dimension
+    void deconvolveWires(PlaneImage&) const;
+
+    // Copies the candidate ROI's from the deconvolved waveform, with normalization and calibration
+    void extractROIs(const FloatTimeVec&, raw::ChannelID_t, IROIFinder::CandidateROIVec const&, recob::Wire::RegionsOfInterest_t&) const;
+
+    // Member variables from the fhicl file
+    std::vector<PlaneWireKernel>                                 fWireKernels;                ///< Deconvolution in the wire dimension (by plane)
+
+    icarus_signal_processing::WaveformTools<float>               fWaveformTool;
+
+    mutable tbb::enumerable_thread_specific<FFTWorkspace>        fWorkspaces;                 ///< FFT plans and buffers, one per thread
+
+    const geo::GeometryCore*                                     fGeometry        = lar::providerFrom<geo::Geometry>();
+    const icarus::ChannelGeometryCache&                          fChannelGeometry = icarus::ChannelGeometryCache::shared(*fGeometry);
+    art::ServiceHandle<icarusutil::SignalShapingICARUSService>   fSignalShaping;
+};
+
+//----------------------------------------------------------------------
+// Constructor.
+PlaneImageDeconvolution::PlaneImageDeconvolution(const fhicl::ParameterSet& pset)
+{
+    configure(pset);
+}
+
+PlaneImageDeconvolution::~PlaneImageDeconvolution()
+{
+}
+
+void PlaneImageDeconvolution::configure(const fhicl::ParameterSet& pset)
+{
+    // Start by recovering the parameters
+    std::vector<std::vector<double>> neighbourWireFractions = pset.get< std::vector<std::vector<double>> >("NeighbourWireFractions", std::vector<std::vector<double>>(3));
+    std::vector<double>              wireFilterSigma        = pset.get< std::vector<double>              >("WireFilterSigma",        std::vector<double>(3, 0.));
+    double                           minWireResponse        = pset.get< double                           >("MinWireResponse",        0.01);
+
+    if (neighbourWireFractions.size() != wireFilterSigma.size())
+        throw cet::exception("PlaneImageDeconvolution") << "NeighbourWireFractions (" << neighbourWireFractions.size()
+                                                        << " planes) and WireFilterSigma (" << wireFilterSigma.size()
+                                                        << " planes) must cover the same planes\n";
+
+    fWireKernels.clear();
+
+    for(size_t plane = 0; plane < neighbourWireFractions.size(); plane++)
+        fWireKernels.emplace_back(neighbourWireFractions[plane], wireFilterSigma[plane], minWireResponse);
+
+    // Get signal shaping service.
+    fSignalShaping = art::ServiceHandle<icarusutil::SignalShapingICARUSService>();
+
+    // The FFT plans are made by each thread on its first use, drop the old ones
+    fWorkspaces.clear();
+
+    return;
+}
+
+icarus_signal_processing::ICARUSFFT<float>& PlaneImageDeconvolution::FFTWorkspace::timeTransform(size_t size)
+{
+    if (size != timeSize || !timeFFT)
+    {
+        // The FFTW plans are made when the object is created and on its first transform,
+        // and the FFTW planner must not run in more than one thread at a time
+        std::lock_guard<std::mutex> lock(icarus::fftwPlannerMutex());
+
+        timeFFT  = std::make_unique<icarus_signal_processing::ICARUSFFT<float>>(size);
+        timeSize = size;
+
+        FloatTimeVec timeVec(size, 0.);
+
+        timeFFT->deconvolute(timeVec, FloatFrequencyVec(size, std::complex<float>(1.,0.)), 0);
+    }
+
+    return *timeFFT;
+}
+
+icarus_signal_processing::ICARUSFFT<float>& PlaneImageDeconvolution::FFTWorkspace::wireTransform(size_t size)
+{
+    std::unique_ptr<icarus_signal_processing::ICARUSFFT<float>>& wireFFT = wireFFTs[size];
+
+    if (!wireFFT)
+    {
+        // Same as for the time transform, plans are made under the FFTW planner lock
+        std::lock_guard<std::mutex> lock(icarus::fftwPlannerMutex());
+
+        wireFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<float>>(size);
+
+        FloatTimeVec      timeVec(size, 0.);
+        FloatFrequencyVec freqVec;
+
+        wireFFT->forwardFFT(timeVec, freqVec);
+        wireFFT->inverseFFT(freqVec, timeVec);
+    }
+
+    return *wireFFT;
+}
+
+const PlaneImageDeconvolution::FloatFrequencyVec& PlaneImageDeconvolution::FFTWorkspace::timeKernel(const IResponse& response)
+{
+    FloatFrequencyVec& kernel = timeKernels[&response];
+
+    if (kernel.empty())
+    {
+        const icarusutil::FrequencyVec& deconvKernel = response.getDeconvKernel();
+
+        kernel.resize(deconvKernel.size());
+
+        std::transform(deconvKernel.begin(),deconvKernel.end(),kernel.begin(),[](const auto& val){return std::complex<float>(val);});
+    }
+
+    return kernel;
+}
+
+void PlaneImageDeconvolution::deconvolveTime(FFTWorkspace&               workspace,
+                                             const IROIFinder::Waveform& waveform,
+                                             raw::ChannelID_t            channel,
+                                             double                      samplingRate,
+                                             FloatTimeVec&               timeVec) const
+{
+    // Make sure the deconvolution size is set correctly (this will probably be a noop after first call)
+    fSignalShaping->SetDecon(samplingRate, waveform.size(), channel);
+
+    const IResponse& response = fSignalShaping->GetResponse(channel);
+
+    timeVec.assign(waveform.begin(),waveform.end());
+
+    workspace.timeTransform(timeVec.size()).deconvolute(timeVec, workspace.timeKernel(response), fSignalShaping->ResponseTOffset(channel));
+
+    return;
+}
+
+void PlaneImageDeconvolution::deconvolveWires(PlaneImage& image) const
+{
+    size_t nWires  = image.data.size();
+    size_t nTicks  = image.data.front().size();
+    size_t fftSize = image.wireKernel.size();  // wires of the image and the empty ones after them
+
+    // Each tick is independent from the others
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, nTicks),
+        [this, &image, nWires, fftSize](const tbb::blocked_range<size_t>& range)
+        {
+            FFTWorkspace&                               workspace = fWorkspaces.local();
+            icarus_signal_processing::ICARUSFFT<float>& wireFFT   = workspace.wireTransform(fftSize);
+
+            for(size_t tick = range.begin(); tick < range.end(); tick++)
+            {
+                workspace.wireVec.assign(fftSize, 0.);
+
+                for(size_t wire = 0; wire < nWires; wire++) workspace.wireVec[wire] = image.data[wire][tick];
+
+                wireFFT.forwardFFT(workspace.wireVec, workspace.wireFreqVec);
+
+                for(size_t freqIdx = 0; freqIdx < workspace.wireFreqVec.size(); freqIdx++)
+                    workspace.wireFreqVec[freqIdx] *= image.wireKernel[freqIdx];
+
+                wireFFT.inverseFFT(workspace.wireFreqVec, workspace.wireVec);
+
+                // The padding is dropped
+                for(size_t wire = 0; wire < nWires; wire++) image.data[wire][tick] = workspace.wireVec[wire];
+            }
+        });
+
+    return;
+}
+
+void PlaneImageDeconvolution::Deconvolve(IROIFinder::Waveform const&        waveform,
+                                         double const                       samplingRate,
+                                         raw::ChannelID_t                   channel,
+                                         IROIFinder::CandidateROIVec const& roiVec,
+                                         recob::Wire::RegionsOfInterest_t&  ROIVec) const
+{
+    FloatTimeVec deconvolvedVec;
+
+    deconvolveTime(fWorkspaces.local(), waveform, channel, samplingRate, deconvolvedVec);
+
+    extractROIs(deconvolvedVec, channel, roiVec, ROIVec);
+
+    return;
+}
+
+void PlaneImageDeconvolution::DeconvolveBatch(BatchChannelVec const& batch,
+                                              double const           samplingRate) const
+{
+    // Build the images, one per plane; channels with no wire are deconvolved alone
+    std::vector<PlaneImage>          images;
+    std::vector<const BatchChannel*> singles;
+
+    for(const BatchChannel& chan : batch)
+    {
+        if (!fChannelGeometry.hasWire(chan.channel))
+        {
+            singles.push_back(&chan);
+            continue;
+        }
+
+        const geo::PlaneID& planeID = fChannelGeometry.planeID(chan.channel);
+
+        auto imageItr = std::find_if(images.begin(),images.end(),[&planeID](const auto& image){return image.planeID == planeID;});
+
+        if (imageItr == images.end())
+        {
+            images.emplace_back();
+            imageItr = std::prev(images.end());
+            imageItr->planeID = planeID;
+        }
+
+        imageItr->rows.push_back(&chan);
+    }
+
+    for(PlaneImage& image : images)
+    {
+        // Place each channel in the row of its wire; wires not in the batch are left empty
+        auto wireOf = [this](const BatchChannel* chan){return fChannelGeometry.wire(chan->channel);};
+
+        std::sort(image.rows.begin(),image.rows.end(),[&wireOf](const auto* left, const auto* right){return wireOf(left) < wireOf(right);});
+
+        std::vector<const BatchChannel*> channels;
+
+        std::swap(channels, image.rows);
+
+        image.firstWire = wireOf(channels.front());
+        image.rows.resize(wireOf(channels.back()) - image.firstWire + 1, nullptr);
+
+        for(const BatchChannel* chan : channels) image.rows[wireOf(chan) - image.firstWire] = chan;
+
+        size_t nTicks = channels.front()->waveform->size();
+
+        for(const BatchChannel* chan : channels)
+        {
+            if (chan->waveform->size() != nTicks)
+                throw cet::exception("PlaneImageDeconvolution") << "Channel " << chan->channel << " has " << chan->waveform->size()
+                                                                << " samples, while the others on its plane have " << nTicks << "\n";
+        }
+
+        const PlaneWireKernel& wireKernel = fWireKernels.at(image.planeID.Plane);
+
+        image.data.assign(image.rows.size(), FloatTimeVec(nTicks, 0.));
+        image.wireKernel = wireKernel.kernel(image.rows.size() + wireKernel.padding());
+
+        // First the time dimension, wire by wire...
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, image.rows.size()),
+            [this, &image, samplingRate](const tbb::blocked_range<size_t>& range)
+            {
+                FFTWorkspace& workspace = fWorkspaces.local();
+
+                for(size_t row = range.begin(); row < range.end(); row++)
+                {
+                    const BatchChannel* chan = image.rows[row];
+
+                    if (chan) deconvolveTime(workspace, *chan->waveform, chan->channel, samplingRate, image.data[row]);
+                }
+            });
+
+        // ... then the wire dimension, tick by tick
+        if (image.rows.size() > 1 && !wireKernel.isIdentity()) deconvolveWires(image);
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, image.rows.size()),
+            [this, &image](const tbb::blocked_range<size_t>& range)
+            {
+                for(size_t row = range.begin(); row < range.end(); row++)
+                {
+                    const BatchChannel* chan = image.rows[row];
+
+                    if (chan) extractROIs(image.data[row], chan->channel, *chan->roiVec, *chan->ROIVec);
+                }
+            });
+
+        // Release the image memory before the next plane
+        image.data.clear();
+    }
+
+    for(const BatchChannel* chan : singles)
+        Deconvolve(*chan->waveform, samplingRate, chan->channel, *chan->roiVec, *chan->ROIVec);
+
+    return;
+}
+
+void PlaneImageDeconvolution::extractROIs(const FloatTimeVec&                deconvolvedVec,
+                                          raw::ChannelID_t                   channel,
+                                          IROIFinder::CandidateROIVec const& roiVec,
+                                          recob::Wire::RegionsOfInterest_t&  ROIVec) const
+{
+    float  deconNorm       = fSignalShaping->GetDeconNorm();
+    float  normFactor      = 1. / deconNorm;
+    bool   applyNormFactor = std::abs(normFactor - 1.) > std::numeric_limits<float>::epsilon() ? true : false;
+
+    std::vector<float> holder;
+
+    for(const auto& roi : roiVec)
+    {
+        // First up: copy out the relevent ADC bins into the ROI holder
+        size_t roiLen = roi.second - roi.first + 1;
+
+        holder.resize(roiLen);
+
+        std::copy(deconvolvedVec.begin()+roi.first, deconvolvedVec.begin()+roi.first+roiLen, holder.begin());
+        if (applyNormFactor) std::transform(holder.begin(),holder.end(),holder.begin(), std::bind(std::multiplies<float>(),std::placeholders::_1,normFactor));
+
+        // Get the truncated mean and rms
+        float truncMean;
+        int   nTrunc;
+        int   range;
+
+        fWaveformTool.getTruncatedMean(holder, truncMean, nTrunc, range);
+
+        std::transform(holder.begin(),holder.end(),holder.begin(), std::bind(std::minus<float>(),std::placeholders::_1,truncMean));
+
+        // add the range into ROIVec
+        ROIVec.add_range(roi.first, std::move(holder));
+    }
+
+    return;
+}
+
+void PlaneImageDeconvolution::initializeHistograms(art::TFileDirectory& histDir) const
+{
+    return;
+}
+
+DEFINE_ART_CLASS_TOOL(PlaneImageDeconvolution)
+}
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   PlaneWireKernel.h
+///
+/// \brief  Kernel in wire frequency used by the deconvolution of plane
+///         images (PlaneImageDeconvolution). It removes the induction
+///         on the neighbouring wires and applies a gaussian filter.
+///
+///         The image is deconvolved with a discrete Fourier transform,
+///         which is circular: the wires at one edge of the image would
+///         leak into the ones at the other edge. The image is then
+///         extended with padding() empty wires. The inverse of the
+///         neighbour response has an infinite reach in wire distance,
+///         so the padding is set where the impulse response of the
+///         kernel has decayed below a small fraction of its peak.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef PlaneWireKernel_H
+#define PlaneWireKernel_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+namespace icarus_tool
+{
+    class PlaneWireKernel
+    {
+    public:
+        // Response on the wires at distance 1, 2..., gaussian filter width (in wire frequency),
+        // and the smallest response which is deconvolved (lower ones are suppressed)
+        PlaneWireKernel(std::vector<double> neighbourFractions, double filterSigma, double minResponse)
+            : fNeighbourFractions(std::move(neighbourFractions))
+            , fFilterSigma(filterSigma)
+            , fMinResponse(minResponse)
+            , fPadding(computePadding())
+        {}
+
+        // Whether the kernel leaves the image unchanged (no neighbour response and no filter)
+        bool isIdentity() const {return fNeighbourFractions.empty() && !(fFilterSigma > 0.);}
+
+        // Number of empty wires to add to an image to avoid the circular leak between its edges
+        // (the leak is below LeakTolerance of the peak, up to MaxPadding wires)
+        size_t padding() const {return fPadding;}
+
+        // Returns the kernel for an image of the specified number of wires (padding included)
+        std::vector<float> kernel(size_t nWires) const
+        {
+            static const double twoPi = 2. * M_PI;
+
+            std::vector<float> kernel(nWires);
+
+            // The response is symmetric in the wire distance, so the kernel is real
+            for(size_t freqIdx = 0; freqIdx < nWires; freqIdx++)
+            {
+                double freq     = double(std::min(freqIdx, nWires - freqIdx)) / double(nWires);
+                double response = 1.;
+
+                for(size_t distIdx = 0; distIdx < fNeighbourFractions.size(); distIdx++)
+                    response += 2. * fNeighbourFractions[distIdx] * std::cos(twoPi * freq * double(distIdx + 1));
+
+                double filter = fFilterSigma > 0. ? std::exp(-0.5 * freq * freq / (fFilterSigma * fFilterSigma)) : 1.;
+
+                kernel[freqIdx] = std::abs(response) < fMinResponse ? 0. : filter / response;
+            }
+
+            return kernel;
+        }
+
+        static constexpr double LeakTolerance = 1.e-3; ///< Largest leak to the other edge, relative to the peak
+        static constexpr size_t MaxPadding    = 512;   ///< Largest padding, in wires
+
+    private:
+        // Returns the farthest wire distance where the impulse response of the kernel is above LeakTolerance of its peak
+        size_t computePadding() const
+        {
+            if (isIdentity()) return 0;
+
+            // The impulse response is the inverse transform of the (real and symmetric) kernel, sampled on enough wires
+            // that its circular copies do not overlap up to the largest padding
+            static const double twoPi = 2. * M_PI;
+
+            size_t             nWires = 2 * MaxPadding + 1;
+            std::vector<float> values = kernel(nWires);
+
+            auto impulse = [&values, nWires](size_t dist)
+            {
+                double sum = 0.;
+
+                for(size_t freqIdx = 0; freqIdx < nWires; freqIdx++)
+                    sum += values[freqIdx] * std::cos(twoPi * double(freqIdx * dist % nWires) / double(nWires));
+
+                return std::abs(sum) / double(nWires);
+            };
+
+            double threshold = LeakTolerance * impulse(0);
+
+            for(size_t dist = MaxPadding; dist > 0; dist--)
+            {
+                if (impulse(dist) >= threshold) return dist;
+            }
+
+            return 0;
+        }
+
+        std::vector<double> fNeighbourFractions;  ///< Response on the wires at distance 1, 2...
+        double              fFilterSigma;         ///< Width of the wire filter, in wire frequency
+        double              fMinResponse;         ///< Wire frequencies with lower response are suppressed
+        size_t              fPadding;             ///< Empty wires to add to an image
+    };
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "larcore/Geometry/Geometry.h"
 #include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
 #include "icarus_signal_processing/WaveformTools.h"
+#include "icaruscode/TPC/Utilities/MorphologicalFilters.h"
 
 #include "TH1F.h"
 #include "TH2F.h"
@@ -207,19 +208,22 @@ void ROIFinderMorphological::FindROIs(const Waveform& waveform, size_t channel,
     // finding ROI's will be to compute the erosion and dilation vectors, get their average/difference and then use these to determine
     // candidate ROI's
     
+    // We make lots of vectors... they are kept by each thread from one call to the next
+    icarus::morphology::Buffers<float>& buffers = icarus::morphology::threadBuffers<float>();
+    
     // Smooth the input waveform
-    Waveform smoothWaveform;
+    Waveform& smoothWaveform = buffers.smoothed;
     
     smoothInputWaveform(waveform, smoothWaveform);
     
-    // We make lots of vectors... erosion, dilation, average and difference
-    Waveform erosionVec;
-    Waveform dilationVec;
-    Waveform averageVec;
-    Waveform differenceVec;
+    // erosion, dilation, average and difference
+    Waveform& erosionVec    = buffers.erosion;
+    Waveform& dilationVec   = buffers.dilation;
+    Waveform& averageVec    = buffers.average;
+    Waveform& differenceVec = buffers.difference;
     
-    // Compute the morphological filter vectors
-    fWaveformTool.getErosionDilationAverageDifference(smoothWaveform, fStructuringElement, erosionVec, dilationVec, averageVec, differenceVec);
+    // Compute the morphological filter vectors (in linear time, whatever the structuring element)
+    icarus::morphology::erosionDilationAverageDifference(smoothWaveform, fStructuringElement, erosionVec, dilationVec, averageVec, differenceVec, buffers.workspace);
 
     // Use the average vector to find ROI's
     float fullRMS;
@@ -229,9 +233,11 @@ void ROIFinderMorphological::FindROIs(const Waveform& waveform, size_t channel,
     int   nTrunc;
     int   range;
     
+    Waveform& zeroSuppressed = buffers.scratch;
+    
     if (fUseDifference) 
     {
-        Waveform zeroSuppressed(differenceVec.size());
+        zeroSuppressed.resize(differenceVec.size());
 
         fWaveformTool.getTruncatedMean(differenceVec, truncMean, nTrunc, range);
 
@@ -241,7 +247,7 @@ void ROIFinderMorphological::FindROIs(const Waveform& waveform, size_t channel,
     }
     else                
     {
-        Waveform zeroSuppressed(dilationVec.size());
+        zeroSuppressed.resize(dilationVec.size());
 
         fWaveformTool.getTruncatedMean(dilationVec, truncMean, nTrunc, range);
 
@@ -357,18 +363,19 @@ void ROIFinderMorphological::FindROIs(const Waveform& waveform, size_t channel,
         roi.second = std::min(roi.second + postROIPad, waveform.size() - 1);
     }
     
-    // merge overlapping (or touching) ROI's
+    // merge overlapping (or touching) ROI's, in place (the merged ones are never more than the input ones)
     if(roiVec.size() > 1)
     {
-        // temporary vector for merged ROIs
-        CandidateROIVec tempRoiVec;
+        size_t nMerged = 0;
         
         // Loop through candidate roi's
         size_t startRoi = roiVec.front().first;
         size_t stopRoi  = startRoi;
         
-        for(auto& roi : roiVec)
+        for(size_t roiIdx = 0; roiIdx < roiVec.size(); roiIdx++)
         {
+            CandidateROI roi = roiVec[roiIdx];
+            
             // Should we merge roi's?
             if (roi.first <= stopRoi + 50)
             { 
@@ -378,7 +385,7 @@ void ROIFinderMorphological::FindROIs(const Waveform& waveform, size_t channel,
             }
             else
             {
-                tempRoiVec.push_back(CandidateROI(startRoi,stopRoi));
+                roiVec[nMerged++] = CandidateROI(startRoi,stopRoi);
                 
                 startRoi = roi.first;
                 stopRoi  = roi.second;
@@ -386,9 +393,9 @@ void ROIFinderMorphological::FindROIs(const Waveform& waveform, size_t channel,
         }
         
         // Make sure to get the last one
-        tempRoiVec.push_back(CandidateROI(startRoi,stopRoi));
+        roiVec[nMerged++] = CandidateROI(startRoi,stopRoi);
         
-        roiVec = tempRoiVec;
+        roiVec.resize(nMerged);
     }
     
     return;
@@ -586,25 +593,21 @@ void ROIFinderMorphological::smoothInputWaveform(const Waveform& inputWaveform,
     // Make sure smoothing makes sense
     if (halfBins > 0)
     {
-        // To facilitate handling the bins at the ends of the input waveform we embed in a slightly larger
-        // vector which has zeroes on the ends
-        Waveform tempWaveform(inputWaveform.size()+fNumBinsToAve);
-    
-        // Set the edge bins which can't be smoothed to zero
-        std::fill(tempWaveform.begin(),tempWaveform.begin()+halfBins,0.);
-        std::fill(tempWaveform.end()-halfBins,tempWaveform.end(),0.);
-    
-        // Copy in the input waveform
-        std::copy(inputWaveform.begin(),inputWaveform.end(),tempWaveform.begin()+halfBins);
+        // The bins beyond the ends of the input waveform count as zeroes, so the weights there are skipped
+        int          nBins   = inputWaveform.size();
+        const float* input   = inputWaveform.data();
+        const float* weights = fAveWeightVec.data();
     
         // Now do the smoothing
-        for(size_t idx = 0; idx < inputWaveform.size(); idx++)
+        for(int idx = 0; idx < nBins; idx++)
         {
+            int   firstWIdx = std::max(0, halfBins - idx);
+            int   lastWIdx  = std::min(fNumBinsToAve, nBins + halfBins - idx);
             float weightedSum(0.);
         
-            for(int wIdx = 0; wIdx < fNumBinsToAve; wIdx++) weightedSum += fAveWeightVec.at(wIdx) * tempWaveform.at(idx + wIdx);
+            for(int wIdx = firstWIdx; wIdx < lastWIdx; wIdx++) weightedSum += weights[wIdx] * input[idx + wIdx - halfBins];
         
-            outputWaveform.at(idx) = weightedSum / fWeightSum;
+            outputWaveform[idx] = weightedSum / fWeightSum;
         }
     }
     else std::copy(inputWaveform.begin(),inputWaveform.end(),outputWaveform.begin());
@@ -15,6 +15,7 @@
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icarus_signal_processing/Filters/FFTFilterFunctions.h"
 #include "icarus_signal_processing/Denoising.h"
+#include "icaruscode/TPC/Utilities/VanHerkMorphologicalFunctions.h"
 
 #include "TH1F.h"
 #include "TH2F.h"
@@ -47,6 +48,7 @@ private:
 
     // fhicl parameters
     std::vector<size_t>  fStructuringElement;         ///< Structuring element for morphological filter
+    bool                 fUseVanHerk2D;               ///< Use the linear time 2D dilation (not yet validated)
     std::vector<float>   fThreshold;                  ///< Threshold to apply for saving signal
 
     // Parameters for Butterworth Filter
@@ -82,6 +84,7 @@ void ROIMorphological2D::configure(const fhicl::ParameterSet& pset)
     // Start by recovering the parameters
     fStructuringElement   = pset.get<std::vector<size_t> >("StructuringElement", std::vector<size_t>()={8,16});
     fThreshold            = pset.get<std::vector<float>  >("Threshold",          std::vector<float>()={2.75,2.75,2.75});
+    fUseVanHerk2D         = pset.get<bool                >("UseVanHerk2D",       false);
      
 //    fButterworthOrder     = pset.get<unsigned int        >("ButterworthOrder",     2);
 //    fButterworthThreshold = pset.get<unsigned int        >("ButterworthThreshld", 30);
@@ -110,7 +113,11 @@ void ROIMorphological2D::FindROIs(const art::Event& event, const ArrayFloat& con
 //    for(auto& waveform : inputImage) (*fButterworthFilter)(waveform);
 
     // Use this to get the 2D Dilation of each waveform
-    icarus_signal_processing::Dilation2D(fStructuringElement[0],fStructuringElement[1])(inputImage.begin(),inputImage.size(),morphedWaveforms.begin());
+    // (the linear time version is optional until it is validated against the library one)
+    if (fUseVanHerk2D)
+        icarus::VanHerkDilation2D(fStructuringElement[0],fStructuringElement[1])(inputImage.begin(),inputImage.size(),morphedWaveforms.begin());
+    else
+        icarus_signal_processing::Dilation2D(fStructuringElement[0],fStructuringElement[1])(inputImage.begin(),inputImage.size(),morphedWaveforms.begin());
 
     if (fOutputHistograms)
     {
@@ -53,6 +53,7 @@
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IROIFinder.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IDeconvolution.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IBaseline.h"
+#include "icaruscode/TPC/Utilities/ChannelGeometryCache.h"
 #include "icarus_signal_processing/WaveformTools.h"
 
 ///creation of calibrated signals on wires
@@ -96,6 +97,7 @@ class RecoWireROIICARUS : public art::EDProducer
     icarus_signal_processing::WaveformTools<float>          fWaveformTool;
     
     const geo::GeometryCore*                                fGeometry = lar::providerFrom<geo::Geometry>();
+    const icarus::ChannelGeometryCache&                     fChannelGeometry = icarus::ChannelGeometryCache::shared(*fGeometry);
     
     // Define here a temporary set of histograms...
     std::vector<TH1F*>     fPedestalOffsetVec;
@@ -259,8 +261,7 @@ void RecoWireROIICARUS::produce(art::Event& evt)
             size_t dataSize = digitVec->Samples();
             
             // Recover the plane info
-            std::vector<geo::WireID> wids    = fGeometry->ChannelToWire(channel);
-            const geo::PlaneID&      planeID = wids[0].planeID();
+            const geo::PlaneID&      planeID = fChannelGeometry.planeID(channel);
 
             // vector holding uncompressed adc values
             std::vector<short> rawadc(dataSize);
@@ -299,10 +300,6 @@ void RecoWireROIICARUS::produce(art::Event& evt)
             // Make some histograms?
             if (fOutputHistograms)
             {
-                // First up, determine what kind of wire we have
-                std::vector<geo::WireID> wids    = fGeometry->ChannelToWire(channel);
-                const geo::PlaneID&      planeID = wids[0].planeID();
-                
                 fNumROIsHistVec.at(planeID.Plane)->Fill(candRoiVec.size(), 1.);
                 
                 for(const auto& pair : candRoiVec)
@@ -388,11 +385,9 @@ float RecoWireROIICARUS::fixTheFreakingWaveform(const std::vector<float>& wavefo
     // Fill histograms
     if (fOutputHistograms)
     {
-        std::vector<geo::WireID> wids = fGeometry->ChannelToWire(channel);
-    
         // Recover plane and wire in the plane
-        size_t plane = wids[0].Plane;
-        size_t wire  = wids[0].Wire;
+        size_t plane = fChannelGeometry.plane(channel);
+        size_t wire  = fChannelGeometry.wire(channel);
     
         fPedestalOffsetVec[plane]->Fill(truncMean,1.);
         fFullRMSVec[plane]->Fill(fullRMS, 1.);
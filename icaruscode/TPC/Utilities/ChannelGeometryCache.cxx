@@ -0,0 +1,36 @@
+/** ****************************************************************************
+ * @file   ChannelGeometryCache.cxx
+ * @brief  Flat, channel-indexed cache of the TPC readout geometry.
+ * @date   October 19, 2026
+ * @see    ChannelGeometryCache.h
+ *
+ * ****************************************************************************/
+
+// library header
+#include "icaruscode/TPC/Utilities/ChannelGeometryCache.h"
+
+// LArSoft libraries
+#include "larcorealg/Geometry/GeometryCore.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+
+// -----------------------------------------------------------------------------
+icarus::ChannelGeometryCache const& icarus::ChannelGeometryCache::shared
+  (geo::GeometryCore const& geom)
+{
+  static geo::GeometryCore const* const cacheGeom = &geom;
+  static ChannelGeometryCache const cache { geom };
+  if (&geom != cacheGeom) {
+    throw cet::exception("ChannelGeometryCache")
+      << "The shared channel geometry cache was built from the geometry at "
+      << static_cast<void const*>(cacheGeom)
+      << ", and can't serve the one at " << static_cast<void const*>(&geom)
+      << ".\n";
+  }
+  return cache;
+} // icarus::ChannelGeometryCache::shared()
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,151 @@
+/** ****************************************************************************
+ * @file   ChannelGeometryCache.h
+ * @brief  Flat, channel-indexed cache of the TPC readout geometry.
+ * @date   October 19, 2026
+ * @see    ChannelGeometryCache.cxx
+ *
+ * ****************************************************************************/
+
+#ifndef ICARUSCODE_TPC_UTILITIES_CHANNELGEOMETRYCACHE_H
+#define ICARUSCODE_TPC_UTILITIES_CHANNELGEOMETRYCACHE_H
+
+// LArSoft libraries
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/readout_types.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <cstddef> // std::size_t
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------
+namespace geo { class GeometryCore; }
+
+namespace icarus { class ChannelGeometryCache; }
+
+/**
+ * @brief Geometry information of each TPC channel, in flat arrays.
+ *
+ * The cache is built once from the geometry service provider, and it is never
+ * modified afterwards, so it can be read concurrently from any thread.
+ * Each query is a single load from an array indexed by the channel number,
+ * in place of a `geo::GeometryCore::ChannelToWire()` call.
+ *
+ * Channels reading more than one wire are represented by their first wire,
+ * as returned by `geo::GeometryCore::ChannelToWire()`. Channels with no wire
+ * have an invalid wire ID (see `hasWire()`).
+ *
+ * The accessors expect a channel number smaller than `nChannels()`; that is
+ * checked only by assertions.
+ *
+ * A cache shared by the whole job is returned by `shared()`:
+ * ~~~~{.cpp}
+ * icarus::ChannelGeometryCache const& channelGeom
+ *   = icarus::ChannelGeometryCache::shared(*lar::providerFrom<geo::Geometry>());
+ *
+ * unsigned int const plane = channelGeom.plane(channel);
+ * ~~~~
+ */
+class icarus::ChannelGeometryCache {
+    public:
+
+  /**
+   * @brief Builds the cache for all the channels in the specified geometry.
+   * @tparam Geometry type of geometry (`geo::GeometryCore` in production)
+   * @param geom the geometry to read the channels from
+   *
+   * The geometry needs `Nchannels()`, `ChannelToWire()` and `ChannelToROP()`
+   * with the same meaning as in `geo::GeometryCore`.
+   */
+  template <typename Geometry>
+  explicit ChannelGeometryCache(Geometry const& geom);
+
+  /// Returns the number of channels in the cache.
+  std::size_t nChannels() const { return fWireIDs.size(); }
+
+  /// Returns whether `channel` is in the cache and it reads at least a wire.
+  bool hasWire(raw::ChannelID_t channel) const
+    { return (channel < nChannels()) && fWireIDs[channel].isValid; }
+
+  /// Returns the ID of the (first) wire read by `channel`.
+  geo::WireID const& wireID(raw::ChannelID_t channel) const
+    { assert(channel < nChannels()); return fWireIDs[channel]; }
+
+  /// Returns the ID of the plane of the (first) wire read by `channel`.
+  geo::PlaneID const& planeID(raw::ChannelID_t channel) const
+    { return wireID(channel); }
+
+  /// Returns the ID of the readout plane `channel` belongs to.
+  readout::ROPID const& ropID(raw::ChannelID_t channel) const
+    { assert(channel < nChannels()); return fROPIDs[channel]; }
+
+  /// Returns the number of the plane of the wire read by `channel`.
+  geo::PlaneID::PlaneID_t plane(raw::ChannelID_t channel) const
+    { return wireID(channel).Plane; }
+
+  /// Returns the number of the wire in its plane read by `channel`.
+  geo::WireID::WireID_t wire(raw::ChannelID_t channel) const
+    { return wireID(channel).Wire; }
+
+  /// Returns the number of the TPC of the wire read by `channel`.
+  geo::TPCID::TPCID_t tpc(raw::ChannelID_t channel) const
+    { return wireID(channel).TPC; }
+
+  /// Returns the number of the cryostat of the wire read by `channel`.
+  geo::CryostatID::CryostatID_t cryostat(raw::ChannelID_t channel) const
+    { return wireID(channel).Cryostat; }
+
+
+  /**
+   * @brief Returns a cache shared by all the users in the job.
+   * @param geom the geometry the cache is built from
+   * @return the shared cache
+   *
+   * The cache is built on the first call (which is thread-safe), and the
+   * following calls return the same object.
+   * The geometry is not expected to change during the job: all the calls must
+   * pass the same geometry object, otherwise an exception is thrown.
+   *
+   * @throw cet::exception (category: `"ChannelGeometryCache"`) if `geom` is
+   *        not the geometry of the first call
+   */
+  static ChannelGeometryCache const& shared(geo::GeometryCore const& geom);
+
+
+    private:
+
+  std::vector<geo::WireID> fWireIDs; ///< First wire of each channel.
+  std::vector<readout::ROPID> fROPIDs; ///< Readout plane of each channel.
+
+}; // class icarus::ChannelGeometryCache
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename Geometry>
+icarus::ChannelGeometryCache::ChannelGeometryCache(Geometry const& geom) {
+
+  unsigned int const nChannels = geom.Nchannels();
+
+  fWireIDs.resize(nChannels); // default IDs are invalid
+  fROPIDs.resize(nChannels);
+
+  for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel) {
+
+    std::vector<geo::WireID> const wires = geom.ChannelToWire(channel);
+    if (wires.empty()) continue;
+
+    fWireIDs[channel] = wires.front();
+    fROPIDs[channel] = geom.ChannelToROP(channel);
+
+  } // for channels
+
+} // icarus::ChannelGeometryCache::ChannelGeometryCache()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_UTILITIES_CHANNELGEOMETRYCACHE_H
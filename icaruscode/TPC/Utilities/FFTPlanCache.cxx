@@ -0,0 +1,154 @@
+/** ****************************************************************************
+ * @file   FFTPlanCache.cxx
+ * @brief  Per-thread cache of real-to-complex FFTW plans, by transform size.
+ * @date   October 19, 2026
+ * @see    FFTPlanCache.h
+ *
+ * ****************************************************************************/
+
+// library header
+#include "icaruscode/TPC/Utilities/FFTPlanCache.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// FFTW
+#include "fftw3.h"
+
+
+// -----------------------------------------------------------------------------
+std::mutex& icarus::fftwPlannerMutex() {
+  static std::mutex plannerMutex;
+  return plannerMutex;
+} // icarus::fftwPlannerMutex()
+
+
+// -----------------------------------------------------------------------------
+// ---  single precision
+// -----------------------------------------------------------------------------
+template <>
+icarus::RealFFTPlan<float>::RealFFTPlan(std::size_t size)
+  : fSize(size), fNFreq(size / 2 + 1)
+{
+  std::lock_guard<std::mutex> const lock { fftwPlannerMutex() };
+
+  // FFTW allocation guarantees the alignment needed by the SIMD transforms
+  fTime = fftwf_alloc_real(fSize);
+  fFreq = reinterpret_cast<Complex_t*>(fftwf_alloc_complex(fNFreq));
+
+  if (fTime && fFreq) {
+    auto* const freq = reinterpret_cast<fftwf_complex*>(fFreq);
+    int const n = fSize;
+    fForwardPlan = fftwf_plan_dft_r2c_1d(n, fTime, freq, FFTW_ESTIMATE);
+    fInversePlan = fftwf_plan_dft_c2r_1d(n, freq, fTime, FFTW_ESTIMATE);
+  }
+
+  if (!fForwardPlan || !fInversePlan) {
+    if (fForwardPlan) fftwf_destroy_plan(static_cast<fftwf_plan>(fForwardPlan));
+    if (fInversePlan) fftwf_destroy_plan(static_cast<fftwf_plan>(fInversePlan));
+    fftwf_free(fTime);
+    fftwf_free(fFreq);
+    throw cet::exception("RealFFTPlan")
+      << "Can't create single precision FFT plans for " << fSize << " samples\n";
+  }
+
+} // icarus::RealFFTPlan<float>::RealFFTPlan()
+
+
+template <>
+icarus::RealFFTPlan<float>::~RealFFTPlan() {
+  std::lock_guard<std::mutex> const lock { fftwPlannerMutex() };
+
+  fftwf_destroy_plan(static_cast<fftwf_plan>(fForwardPlan));
+  fftwf_destroy_plan(static_cast<fftwf_plan>(fInversePlan));
+  fftwf_free(fTime);
+  fftwf_free(fFreq);
+} // icarus::RealFFTPlan<float>::~RealFFTPlan()
+
+
+template <>
+void icarus::RealFFTPlan<float>::executeForward()
+  { fftwf_execute(static_cast<fftwf_plan>(fForwardPlan)); }
+
+
+template <>
+void icarus::RealFFTPlan<float>::executeInverse()
+  { fftwf_execute(static_cast<fftwf_plan>(fInversePlan)); }
+
+
+// -----------------------------------------------------------------------------
+// ---  double precision
+// -----------------------------------------------------------------------------
+template <>
+icarus::RealFFTPlan<double>::RealFFTPlan(std::size_t size)
+  : fSize(size), fNFreq(size / 2 + 1)
+{
+  std::lock_guard<std::mutex> const lock { fftwPlannerMutex() };
+
+  fTime = fftw_alloc_real(fSize);
+  fFreq = reinterpret_cast<Complex_t*>(fftw_alloc_complex(fNFreq));
+
+  if (fTime && fFreq) {
+    auto* const freq = reinterpret_cast<fftw_complex*>(fFreq);
+    int const n = fSize;
+    fForwardPlan = fftw_plan_dft_r2c_1d(n, fTime, freq, FFTW_ESTIMATE);
+    fInversePlan = fftw_plan_dft_c2r_1d(n, freq, fTime, FFTW_ESTIMATE);
+  }
+
+  if (!fForwardPlan || !fInversePlan) {
+    if (fForwardPlan) fftw_destroy_plan(static_cast<fftw_plan>(fForwardPlan));
+    if (fInversePlan) fftw_destroy_plan(static_cast<fftw_plan>(fInversePlan));
+    fftw_free(fTime);
+    fftw_free(fFreq);
+    throw cet::exception("RealFFTPlan")
+      << "Can't create double precision FFT plans for " << fSize << " samples\n";
+  }
+
+} // icarus::RealFFTPlan<double>::RealFFTPlan()
+
+
+template <>
+icarus::RealFFTPlan<double>::~RealFFTPlan() {
+  std::lock_guard<std::mutex> const lock { fftwPlannerMutex() };
+
+  fftw_destroy_plan(static_cast<fftw_plan>(fForwardPlan));
+  fftw_destroy_plan(static_cast<fftw_plan>(fInversePlan));
+  fftw_free(fTime);
+  fftw_free(fFreq);
+} // icarus::RealFFTPlan<double>::~RealFFTPlan()
+
+
+template <>
+void icarus::RealFFTPlan<double>::executeForward()
+  { fftw_execute(static_cast<fftw_plan>(fForwardPlan)); }
+
+
+template <>
+void icarus::RealFFTPlan<double>::executeInverse()
+  { fftw_execute(static_cast<fftw_plan>(fInversePlan)); }
+
+
+// -----------------------------------------------------------------------------
+// ---  cache
+// -----------------------------------------------------------------------------
+template <typename T>
+icarus::RealFFTPlan<T>& icarus::FFTPlanCache<T>::plan(std::size_t size) {
+  std::unique_ptr<RealFFTPlan<T>>& plan = fPlans[size];
+  if (!plan) plan = std::make_unique<RealFFTPlan<T>>(size);
+  return *plan;
+} // icarus::FFTPlanCache<>::plan()
+
+
+template <typename T>
+icarus::FFTPlanCache<T>& icarus::FFTPlanCache<T>::threadCache() {
+  static thread_local FFTPlanCache<T> cache;
+  return cache;
+} // icarus::FFTPlanCache<>::threadCache()
+
+
+// -----------------------------------------------------------------------------
+template class icarus::FFTPlanCache<float>;
+template class icarus::FFTPlanCache<double>;
+
+
+// -----------------------------------------------------------------------------
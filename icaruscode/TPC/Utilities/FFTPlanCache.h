@@ -0,0 +1,223 @@
+/** ****************************************************************************
+ * @file   FFTPlanCache.h
+ * @brief  Per-thread cache of real-to-complex FFTW plans, by transform size.
+ * @date   October 19, 2026
+ * @see    FFTPlanCache.cxx
+ *
+ * ****************************************************************************/
+
+#ifndef ICARUSCODE_TPC_UTILITIES_FFTPLANCACHE_H
+#define ICARUSCODE_TPC_UTILITIES_FFTPLANCACHE_H
+
+// C/C++ standard libraries
+#include <vector>
+#include <complex>
+#include <map>
+#include <memory> // std::unique_ptr
+#include <mutex>
+#include <algorithm> // std::copy(), std::min()
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus {
+
+  /**
+   * @brief Returns the mutex protecting the FFTW planner.
+   *
+   * The FFTW planner (plan creation and destruction) is not thread-safe, while
+   * executing an existing plan is. The mutex only serializes the code which
+   * holds it while creating or destroying plans: `RealFFTPlan` and the
+   * deconvolution tools which plan from worker threads (`FullWireDeconvolution`,
+   * `PlaneImageDeconvolution`).
+   *
+   * The other `ICARUSFFT` objects in ICARUS code (e.g. in `TPCNoise`, in the
+   * response tools, or the one `RecoWireICARUS` makes for each event) are
+   * planned without it. Most are created at construction, when no event is
+   * being processed; any that is planned during event processing may still
+   * race with the users of this mutex in a multithreaded job.
+   */
+  std::mutex& fftwPlannerMutex();
+
+
+  /**
+   * @brief Real-to-complex FFT of a fixed size, with its own buffers.
+   * @tparam T the precision of the transform (`float` or `double`)
+   *
+   * The forward transform returns the `size() / 2 + 1` non-redundant
+   * frequencies. The inverse transform is normalized, so that the inverse of
+   * the forward transform returns the original waveform.
+   *
+   * The plan uses its own buffers: an object must not be used by more than
+   * one thread at a time. Use `FFTPlanCache::threadCache()` to get plans
+   * belonging to the current thread.
+   */
+  template <typename T>
+  class RealFFTPlan {
+      public:
+    using Complex_t = std::complex<T>;
+
+    /// Creates the plans for waveforms with `size` samples.
+    explicit RealFFTPlan(std::size_t size);
+
+    ~RealFFTPlan();
+
+    RealFFTPlan(RealFFTPlan const&) = delete;
+    RealFFTPlan& operator= (RealFFTPlan const&) = delete;
+
+    /// Returns the number of samples of the transformed waveforms.
+    std::size_t size() const { return fSize; }
+
+    /// Returns the number of frequencies of the spectrum (`size() / 2 + 1`).
+    std::size_t nFrequencies() const { return fNFreq; }
+
+    /**
+     * @brief Computes the spectrum of `waveform`.
+     * @param waveform the input waveform (samples beyond `size()` are ignored,
+     *                 missing ones are taken as `0`)
+     * @param spectrum _(output)_ resized to `nFrequencies()`
+     */
+    template <typename Input>
+    void forward(std::vector<Input> const& waveform, std::vector<Complex_t>& spectrum);
+
+    /**
+     * @brief Computes the (normalized) waveform of `spectrum`.
+     * @param spectrum the first `nFrequencies()` frequencies of the spectrum
+     * @param waveform _(output)_ resized to `size()`
+     */
+    template <typename Output>
+    void inverse(std::vector<Complex_t> const& spectrum, std::vector<Output>& waveform);
+
+    /**
+     * @brief Multiplies the spectrum of `waveform` by `kernel`, in place.
+     * @param waveform the waveform to transform
+     * @param kernel the multiplicative factor of each frequency
+     *
+     * Frequencies beyond the end of `kernel` are left unchanged.
+     */
+    template <typename Data, typename Kernel>
+    void convolute(std::vector<Data>& waveform, std::vector<Kernel> const& kernel);
+
+    /// Returns a buffer to hold a spectrum, for the convenience of the caller.
+    std::vector<Complex_t>& spectrumBuffer() { return fSpectrum; }
+
+      private:
+    std::size_t fSize;  ///< Number of samples.
+    std::size_t fNFreq; ///< Number of frequencies.
+    T* fTime = nullptr; ///< Aligned input/output of the transforms.
+    Complex_t* fFreq = nullptr; ///< Aligned spectrum of the transforms.
+    void* fForwardPlan = nullptr; ///< FFTW forward plan.
+    void* fInversePlan = nullptr; ///< FFTW inverse plan.
+    std::vector<Complex_t> fSpectrum; ///< Buffer for `convolute()` and users.
+
+    void executeForward(); ///< Transforms `fTime` into `fFreq`.
+    void executeInverse(); ///< Transforms `fFreq` into `fTime` (not normalized).
+
+  }; // class RealFFTPlan
+
+
+  /**
+   * @brief Collection of `RealFFTPlan`, one per transform size.
+   * @tparam T the precision of the transforms (`float` or `double`)
+   *
+   * Plans are created on the first request of each size, and kept for the
+   * lifetime of the cache. The cache of each thread is returned by
+   * `threadCache()`:
+   * ~~~~{.cpp}
+   * auto& fft = icarus::FFTPlanCache<double>::threadCache().plan(waveform.size());
+   * fft.forward(waveform, spectrum);
+   * ~~~~
+   */
+  template <typename T>
+  class FFTPlanCache {
+      public:
+
+    /// Returns the plan for waveforms with `size` samples.
+    RealFFTPlan<T>& plan(std::size_t size);
+
+    /// Returns the cache of the current thread.
+    static FFTPlanCache& threadCache();
+
+      private:
+    std::map<std::size_t, std::unique_ptr<RealFFTPlan<T>>> fPlans;
+
+  }; // class FFTPlanCache
+
+
+  // the transforms are implemented (in FFTPlanCache.cxx) for these precisions
+  template <> RealFFTPlan<float>::RealFFTPlan(std::size_t size);
+  template <> RealFFTPlan<float>::~RealFFTPlan();
+  template <> void RealFFTPlan<float>::executeForward();
+  template <> void RealFFTPlan<float>::executeInverse();
+
+  template <> RealFFTPlan<double>::RealFFTPlan(std::size_t size);
+  template <> RealFFTPlan<double>::~RealFFTPlan();
+  template <> void RealFFTPlan<double>::executeForward();
+  template <> void RealFFTPlan<double>::executeInverse();
+
+  extern template class FFTPlanCache<float>;
+  extern template class FFTPlanCache<double>;
+
+} // namespace icarus
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename T>
+template <typename Input>
+void icarus::RealFFTPlan<T>::forward
+  (std::vector<Input> const& waveform, std::vector<Complex_t>& spectrum)
+{
+  std::size_t const nSamples = std::min(waveform.size(), fSize);
+
+  std::copy(waveform.begin(), waveform.begin() + nSamples, fTime);
+  std::fill(fTime + nSamples, fTime + fSize, T(0));
+
+  executeForward();
+
+  spectrum.assign(fFreq, fFreq + fNFreq);
+} // icarus::RealFFTPlan<>::forward()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+template <typename Output>
+void icarus::RealFFTPlan<T>::inverse
+  (std::vector<Complex_t> const& spectrum, std::vector<Output>& waveform)
+{
+  std::size_t const nFreq = std::min(spectrum.size(), fNFreq);
+
+  std::copy(spectrum.begin(), spectrum.begin() + nFreq, fFreq);
+  std::fill(fFreq + nFreq, fFreq + fNFreq, Complex_t(0));
+
+  executeInverse();
+
+  T const norm = T(1) / T(fSize);
+
+  waveform.resize(fSize);
+  for (std::size_t index = 0; index < fSize; ++index)
+    waveform[index] = static_cast<Output>(fTime[index] * norm);
+
+} // icarus::RealFFTPlan<>::inverse()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+template <typename Data, typename Kernel>
+void icarus::RealFFTPlan<T>::convolute
+  (std::vector<Data>& waveform, std::vector<Kernel> const& kernel)
+{
+  forward(waveform, fSpectrum);
+
+  std::size_t const nFreq = std::min(kernel.size(), fSpectrum.size());
+  for (std::size_t index = 0; index < nFreq; ++index)
+    fSpectrum[index] *= static_cast<Complex_t>(kernel[index]);
+
+  inverse(fSpectrum, waveform);
+} // icarus::RealFFTPlan<>::convolute()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_UTILITIES_FFTPLANCACHE_H
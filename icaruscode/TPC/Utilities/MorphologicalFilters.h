@@ -0,0 +1,275 @@
+/** ****************************************************************************
+ * @file   MorphologicalFilters.h
+ * @brief  Linear time erosion and dilation of waveforms.
+ * @date   October 19, 2026
+ * @see    VanHerkMorphologicalFunctions.h
+ *
+ * The running minimum and maximum are computed with the van Herk/Gil-Werman
+ * algorithm: the waveform is split in blocks as long as the window, and the
+ * extremum of each window is the combination of the suffix extremum of one
+ * block and the prefix extremum of the next one. This costs three comparisons
+ * per sample, whatever the width of the structuring element.
+ *
+ * ****************************************************************************/
+
+#ifndef ICARUSCODE_TPC_UTILITIES_MORPHOLOGICALFILTERS_H
+#define ICARUSCODE_TPC_UTILITIES_MORPHOLOGICALFILTERS_H
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::min(), std::max()
+#include <limits>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::morphology {
+
+  /**
+   * @brief Buffers used by the filters.
+   *
+   * The buffers grow to the size of the largest waveform they are used with,
+   * and they are not released afterwards: reusing a workspace, the filters
+   * do not allocate memory. A workspace must not be shared between threads;
+   * `threadWorkspace()` returns the one of the current thread.
+   */
+  template <typename T>
+  struct Workspace {
+    std::vector<T> prefix; ///< Extremum from the start of the block.
+    std::vector<T> suffix; ///< Extremum to the end of the block.
+    std::vector<T> line;   ///< Copy of a column of an image.
+  }; // Workspace
+
+
+  /**
+   * @brief Waveform buffers of the morphological tools, and their workspace.
+   *
+   * Like the workspace, the buffers are kept from one waveform to the next so
+   * that the tools do not allocate memory, and they must not be shared between
+   * threads: `threadBuffers()` returns the ones of the current thread.
+   * Each tool uses only the buffers it needs.
+   */
+  template <typename T>
+  struct Buffers {
+    std::vector<T> smoothed;   ///< Input waveform, smoothed or baseline subtracted.
+    std::vector<T> erosion;    ///< Erosion of the input.
+    std::vector<T> dilation;   ///< Dilation of the input.
+    std::vector<T> average;    ///< Average of erosion and dilation.
+    std::vector<T> difference; ///< Dilation minus erosion.
+    std::vector<T> opening;    ///< Dilation of the erosion.
+    std::vector<T> closing;    ///< Erosion of the dilation.
+    std::vector<T> scratch;    ///< Any other waveform needed by a tool.
+    Workspace<T> workspace;    ///< Buffers for the filters.
+  }; // Buffers
+
+
+  /// Returns the buffers of the current thread.
+  template <typename T>
+  Buffers<T>& threadBuffers()
+    { static thread_local Buffers<T> buffers; return buffers; }
+
+  /// Returns the workspace of the current thread (the one of its buffers).
+  template <typename T>
+  Workspace<T>& threadWorkspace() { return threadBuffers<T>().workspace; }
+
+
+  /**
+   * @brief Applies a running extremum to `size` samples.
+   * @tparam Op binary operation returning the extremum of its arguments
+   * @param input pointer to the first sample
+   * @param size number of samples
+   * @param halfWidth the window covers `halfWidth` samples on each side
+   * @param identity value never chosen by `op` (the samples out of range)
+   * @param op the extremum operation
+   * @param output pointer to the first of `size` output samples
+   * @param workspace buffers to use
+   *
+   * The window is truncated at the ends of the waveform. `output` may be the
+   * same as `input`.
+   */
+  template <typename T, typename Op>
+  void runningExtremum(
+    T const* input, std::size_t size, std::size_t halfWidth,
+    T identity, Op op, T* output, Workspace<T>& workspace
+    );
+
+
+  /**
+   * @brief Computes the erosion (running minimum) of `input`.
+   * @param input the waveform to filter
+   * @param structuringElement width of the window, in samples
+   * @param output the filtered waveform (resized as `input`, may be `input`)
+   * @param workspace buffers to use
+   *
+   * The window spans `structuringElement / 2` samples on each side of the
+   * one being filtered.
+   */
+  template <typename T>
+  void erosion(
+    std::vector<T> const& input, std::size_t structuringElement,
+    std::vector<T>& output, Workspace<T>& workspace = threadWorkspace<T>()
+    );
+
+  /// Computes the dilation (running maximum) of `input`; see `erosion()`.
+  template <typename T>
+  void dilation(
+    std::vector<T> const& input, std::size_t structuringElement,
+    std::vector<T>& output, Workspace<T>& workspace = threadWorkspace<T>()
+    );
+
+
+  /**
+   * @brief Computes erosion and dilation, their average and their difference.
+   * @param input the waveform to filter
+   * @param structuringElement width of the window, in samples
+   * @param erosionVec _(output)_ the erosion of `input`
+   * @param dilationVec _(output)_ the dilation of `input`
+   * @param averageVec _(output)_ the average of erosion and dilation
+   * @param differenceVec _(output)_ dilation minus erosion
+   * @param workspace buffers to use
+   */
+  template <typename T>
+  void erosionDilationAverageDifference(
+    std::vector<T> const& input, std::size_t structuringElement,
+    std::vector<T>& erosionVec, std::vector<T>& dilationVec,
+    std::vector<T>& averageVec, std::vector<T>& differenceVec,
+    Workspace<T>& workspace = threadWorkspace<T>()
+    );
+
+
+  /**
+   * @brief Computes opening and closing from erosion and dilation.
+   * @param erosionVec the erosion of the waveform
+   * @param dilationVec the dilation of the waveform
+   * @param structuringElement width of the window, in samples
+   * @param openingVec _(output)_ the dilation of `erosionVec`
+   * @param closingVec _(output)_ the erosion of `dilationVec`
+   * @param workspace buffers to use
+   */
+  template <typename T>
+  void openingAndClosing(
+    std::vector<T> const& erosionVec, std::vector<T> const& dilationVec,
+    std::size_t structuringElement,
+    std::vector<T>& openingVec, std::vector<T>& closingVec,
+    Workspace<T>& workspace = threadWorkspace<T>()
+    );
+
+} // namespace icarus::morphology
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename T, typename Op>
+void icarus::morphology::runningExtremum(
+  T const* input, std::size_t size, std::size_t halfWidth,
+  T identity, Op op, T* output, Workspace<T>& workspace
+) {
+  if (size == 0) return;
+
+  // the waveform is padded with `halfWidth` identity samples on each side
+  std::size_t const window = 2 * halfWidth + 1;
+  std::size_t const padded = size + 2 * halfWidth;
+
+  auto const sample = [input, size, halfWidth, identity](std::size_t index)
+    {
+      return ((index < halfWidth) || (index >= size + halfWidth))
+        ? identity: input[index - halfWidth];
+    };
+
+  workspace.prefix.resize(padded);
+  workspace.suffix.resize(padded);
+
+  T* const prefix = workspace.prefix.data();
+  T* const suffix = workspace.suffix.data();
+
+  for (std::size_t start = 0; start < padded; start += window) {
+    std::size_t const stop = std::min(start + window, padded);
+
+    prefix[start] = sample(start);
+    for (std::size_t index = start + 1; index < stop; ++index)
+      prefix[index] = op(prefix[index - 1], sample(index));
+
+    suffix[stop - 1] = sample(stop - 1);
+    for (std::size_t index = stop - 1; index-- > start;)
+      suffix[index] = op(suffix[index + 1], sample(index));
+
+  } // for blocks
+
+  // the window of output sample `i` covers padded samples `[ i, i + window )`
+  for (std::size_t index = 0; index < size; ++index)
+    output[index] = op(suffix[index], prefix[index + window - 1]);
+
+} // icarus::morphology::runningExtremum()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarus::morphology::erosion(
+  std::vector<T> const& input, std::size_t structuringElement,
+  std::vector<T>& output, Workspace<T>& workspace
+) {
+  output.resize(input.size());
+  runningExtremum(
+    input.data(), input.size(), structuringElement / 2,
+    std::numeric_limits<T>::max(),
+    [](T a, T b){ return std::min(a, b); },
+    output.data(), workspace
+    );
+} // icarus::morphology::erosion()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarus::morphology::dilation(
+  std::vector<T> const& input, std::size_t structuringElement,
+  std::vector<T>& output, Workspace<T>& workspace
+) {
+  output.resize(input.size());
+  runningExtremum(
+    input.data(), input.size(), structuringElement / 2,
+    std::numeric_limits<T>::lowest(),
+    [](T a, T b){ return std::max(a, b); },
+    output.data(), workspace
+    );
+} // icarus::morphology::dilation()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarus::morphology::erosionDilationAverageDifference(
+  std::vector<T> const& input, std::size_t structuringElement,
+  std::vector<T>& erosionVec, std::vector<T>& dilationVec,
+  std::vector<T>& averageVec, std::vector<T>& differenceVec,
+  Workspace<T>& workspace
+) {
+  erosion(input, structuringElement, erosionVec, workspace);
+  dilation(input, structuringElement, dilationVec, workspace);
+
+  averageVec.resize(input.size());
+  differenceVec.resize(input.size());
+
+  for (std::size_t index = 0; index < input.size(); ++index) {
+    averageVec[index] = (dilationVec[index] + erosionVec[index]) / 2;
+    differenceVec[index] = dilationVec[index] - erosionVec[index];
+  }
+
+} // icarus::morphology::erosionDilationAverageDifference()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarus::morphology::openingAndClosing(
+  std::vector<T> const& erosionVec, std::vector<T> const& dilationVec,
+  std::size_t structuringElement,
+  std::vector<T>& openingVec, std::vector<T>& closingVec,
+  Workspace<T>& workspace
+) {
+  dilation(erosionVec, structuringElement, openingVec, workspace);
+  erosion(dilationVec, structuringElement, closingVec, workspace);
+} // icarus::morphology::openingAndClosing()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_UTILITIES_MORPHOLOGICALFILTERS_H
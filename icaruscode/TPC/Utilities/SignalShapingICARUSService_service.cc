@@ -32,6 +32,7 @@
 #include "tbb/spin_mutex.h"
 
 #include <fstream>
+#include <limits>
 
 namespace icarusutil
 {
@@ -74,6 +75,8 @@ void SignalShapingICARUSService::reconfigure(const fhicl::ParameterSet& pset)
     fNoiseFactVec           = pset.get<DoubleVec2>("NoiseFactVec"         );
     fStoreHistograms        = pset.get<bool>(      "StoreHistograms"      );
     
+    makePlaneTables();
+    
     fInit = false;
     
     return;
@@ -99,12 +102,67 @@ const icarus_tool::IResponse& SignalShapingICARUSService::GetResponse(size_t cha
 {
     if (!fInit) init();
     
-    art::ServiceHandle<geo::Geometry> geom;
+    return *planeInfo(channel).response;
+}
+
+
+//----------------------------------------------------------------------
+// Fills the quantities which depend only on the configuration and geometry.
+// The time offsets need the responses to be set, and are filled by init().
+void SignalShapingICARUSService::makePlaneTables()
+{
+    static const double fcToElectrons(6241.50975);
+    
+    fPlaneInfo.clear();
+    
+    if (!fPlaneToResponseMap.empty()) fPlaneInfo.resize(fPlaneToResponseMap.rbegin()->first + 1);
     
-        //use channel number to set some useful numbers
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
+    for(const auto& [planeIdx, responses] : fPlaneToResponseMap)
+    {
+        const icarus_tool::IResponse*             response   = responses.front().get();
+        const icarus_tool::IElectronicsResponse*  electronics = response->getElectronicsResponse();
+        
+        if (planeIdx >= fNoiseFactVec.size())
+            throw cet::exception("SignalShapingICARUSService")
+                << "NoiseFactVec has no entry for plane " << planeIdx << "\n";
+        
+        const DoubleVec& noiseFact = fNoiseFactVec[planeIdx];
+        size_t           noiseIdx  = shapingTimeIndex(electronics->getASICShapingTime());
+        
+        PlaneInfo_t& info = fPlaneInfo[planeIdx];
+        
+        info.response   = response;
+        info.asicGain   = electronics->getFCperADCMicroS() * fcToElectrons;
+        info.deconNoise = noiseFact.at(noiseIdx);
+        info.rawNoise   = info.deconNoise * electronics->getFCperADCMicroS() / 4.7;
+    }
+    
+    // channel to plane map, to avoid a geometry query at each call
+    fChannelGeometry = &icarus::ChannelGeometryCache::shared(*lar::providerFrom<geo::Geometry>());
+    
+    return;
+}
 
-    return *fPlaneToResponseMap.at(planeIdx).front();
+//----------------------------------------------------------------------
+const SignalShapingICARUSService::PlaneInfo_t& SignalShapingICARUSService::planeInfo(unsigned int channel) const
+{
+    unsigned int planeIdx = fChannelGeometry->hasWire(channel)
+        ? fChannelGeometry->plane(channel): std::numeric_limits<unsigned int>::max();
+    
+    if (planeIdx >= fPlaneInfo.size() || !fPlaneInfo[planeIdx].response)
+        throw cet::exception("SignalShapingICARUSService")
+            << "No response is configured for channel " << channel << "\n";
+    
+    return fPlaneInfo[planeIdx];
+}
+
+//----------------------------------------------------------------------
+size_t SignalShapingICARUSService::shapingTimeIndex(double shapingTime)
+{
+    if (std::abs(shapingTime - 0.6) < 1e-6) return 0;
+    if (std::abs(shapingTime - 1.3) < 1e-6) return 1;
+    if (std::abs(shapingTime - 2.0) < 1e-6) return 2;
+    return 3;
 }
 
 
@@ -134,6 +192,14 @@ void SignalShapingICARUSService::init()
           fPlaneToResponseMap[planeIdx].front().get()->setResponse(samplingRate, weight);
         }
         
+        fSamplingRate = samplingRate;
+        
+        // The time offsets are known only after the responses are set
+        for(PlaneInfo_t& info : fPlaneInfo)
+        {
+            if (info.response) info.tOffset = info.response->getTOffset();
+        }
+        
         // Check to see if we want histogram output
         if (fStoreHistograms)
         {
@@ -156,34 +222,32 @@ void SignalShapingICARUSService::init()
     return;
 }
 
+// The kernels of all planes are computed once by init(), with the sampling
+// rate of the job and for the number of time samples of the response tools.
+// They are not recomputed: a request for a different sampling rate or FFT
+// size is an error.
 void SignalShapingICARUSService::SetDecon(double const samplingRate,
                                           size_t fftsize, size_t channel)
 {
-    art::ServiceHandle<geo::Geometry> geo;
-    
     if (!fInit) init();
     
-    // Assume we need to reset the kernels
-    double integral = fPlaneToResponseMap.at(fPlaneForNormalization).front().get()->getFieldResponse()->getIntegral();
-    double weight   = 1. / integral;
+    if (std::abs(samplingRate - fSamplingRate) > 1e-6 * fSamplingRate)
+        throw cet::exception("SignalShapingICARUSService")
+            << "SetDecon(): sampling rate " << samplingRate << " requested for channel " << channel
+            << ", while the responses are set for " << fSamplingRate << "\n";
     
-    for(size_t planeIdx = 0; planeIdx < geo->Nplanes(); planeIdx++)
-    {
-        fPlaneToResponseMap.at(planeIdx).front()->setResponse(samplingRate, weight);
-    }
+    size_t kernelSize = planeInfo(channel).response->getNumberTimeSamples();
+    
+    if (fftsize != kernelSize)
+        throw cet::exception("SignalShapingICARUSService")
+            << "SetDecon(): FFT size " << fftsize << " requested for channel " << channel
+            << ", while the response kernel has " << kernelSize << " samples\n";
 }
 
 //-----Give Gain Settings to SimWire-----
 double SignalShapingICARUSService::GetASICGain(unsigned int channel) const
 {
-    static const double fcToElectrons(6241.50975);
-
-    art::ServiceHandle<geo::Geometry> geom;
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
-    
-    double gain = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getFCperADCMicroS() * fcToElectrons;
-    
-    return gain;
+    return planeInfo(channel).asicGain;
 }
 
 //-----Give Shaping time to SimWire-----
@@ -196,66 +260,21 @@ double SignalShapingICARUSService::GetShapingTime(unsigned int planeIdx) const
 
 double SignalShapingICARUSService::GetRawNoise(unsigned int const channel) const
 {
-    art::ServiceHandle<geo::Geometry> geom;
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
-
-    double gain         = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getFCperADCMicroS();
-    double shaping_time = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getASICShapingTime();
-    int    temp;
-    
-    if (std::abs(shaping_time - 0.6)<1e-6){
-        temp = 0;
-    }else if (std::abs(shaping_time - 1.3)<1e-6){
-        temp = 1;
-    }else if (std::abs(shaping_time - 2.0)<1e-6){
-        temp = 2;
-    }else{
-        temp = 3;
-    }
-    
-    double rawNoise;
-    
-    auto tempNoise = fNoiseFactVec.at(planeIdx);
-    rawNoise = tempNoise.at(temp);
-    
-    rawNoise *= gain/4.7;
-    return rawNoise;
+    return planeInfo(channel).rawNoise;
 }
 
 double SignalShapingICARUSService::GetDeconNoise(unsigned int const channel) const
 {
-    art::ServiceHandle<geo::Geometry> geom;
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
-    
-    double shaping_time = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getASICShapingTime();
-    int temp;
-    
-    if (std::abs(shaping_time - 0.6)<1e-6){
-        temp = 0;
-    }else if (std::abs(shaping_time - 1.3)<1e-6){
-        temp = 1;
-    }else if (std::abs(shaping_time - 2.0)<1.e-6){
-        temp = 2;
-    }else{
-        temp = 3;
-    }
-    auto   tempNoise  = fNoiseFactVec.at(planeIdx);
-    double deconNoise = tempNoise.at(temp);
-    
     //deconNoise = deconNoise /4096.*2000./4.7 *6.241*1000/fDeconNorm; <== I don't know where these numbers come from...
 
-    return deconNoise;
+    return planeInfo(channel).deconNoise;
 }
 
 int SignalShapingICARUSService::ResponseTOffset(unsigned int const channel) const
 {
     if (!fInit) init();
     
-    art::ServiceHandle<geo::Geometry> geom;
-    
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
-
-    return fPlaneToResponseMap.at(planeIdx).front()->getTOffset();
+    return planeInfo(channel).tOffset;
 }
 }
 
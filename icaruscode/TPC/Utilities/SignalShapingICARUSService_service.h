@@ -80,12 +80,14 @@
 
 #include <vector>
 #include <map>
+#include <atomic>
 #include "fhiclcpp/ParameterSet.h"
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 
 #include "icaruscode/TPC/Utilities/tools/IResponse.h"
+#include "icaruscode/TPC/Utilities/ChannelGeometryCache.h"
 #include "TH1D.h"
 
 using DoubleVec  = std::vector<double>;
@@ -128,12 +130,32 @@ private:
     using ResponseVec              = std::vector<IResponsePtr>;
     using PlaneToResponseMap       = std::map<size_t, ResponseVec>;
     
+    /// Quantities of a plane, computed once and then only read.
+    struct PlaneInfo_t
+    {
+        const icarus_tool::IResponse* response   = nullptr; ///< Response of the plane
+        double                        asicGain   = 0.;      ///< See `GetASICGain()`
+        double                        rawNoise   = 0.;      ///< See `GetRawNoise()`
+        double                        deconNoise = 0.;      ///< See `GetDeconNoise()`
+        int                           tOffset    = 0;       ///< Set by `init()`
+    };
+    
     // Post-constructor initialization.
     void init() const{const_cast<SignalShapingICARUSService*>(this)->init();}
     void init();
     
+    // Fills the plane table (configuration only).
+    void makePlaneTables();
+    
+    // Returns the precomputed information of the plane of the channel.
+    const PlaneInfo_t& planeInfo(unsigned int channel) const;
+    
+    // Index of the noise factor for the specified shaping time.
+    static size_t shapingTimeIndex(double shapingTime);
+    
     // Attributes.
-    bool fInit;                                                 ///< Initialization flag
+    std::atomic<bool> fInit;                                    ///< Initialization flag
+    double            fSamplingRate = 0.;                       ///< Sampling rate the responses are set for (by `init()`)
     
     // Fcl parameters.
     size_t             fPlaneForNormalization; ///< Normalize responses to this plane
@@ -145,6 +167,10 @@ private:
     
     // Field response tools
     PlaneToResponseMap fPlaneToResponseMap;
+    
+    // Lookup tables: after `init()`, they are only read (no locking needed)
+    std::vector<PlaneInfo_t>            fPlaneInfo;                ///< Information by plane index
+    const icarus::ChannelGeometryCache* fChannelGeometry = nullptr; ///< Plane of each channel
 };
 
 } // end of namespace
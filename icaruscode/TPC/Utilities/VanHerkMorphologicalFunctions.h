@@ -0,0 +1,212 @@
+/** ****************************************************************************
+ * @file   VanHerkMorphologicalFunctions.h
+ * @brief  Linear time erosion and dilation for the signal processing filters.
+ * @date   October 19, 2026
+ * @see    MorphologicalFilters.h
+ *
+ * These classes implement the morphological function interfaces of
+ * `icarus_signal_processing`, and can replace `Erosion1D`, `Dilation1D`,
+ * `Erosion2D` and `Dilation2D` in the denoisers. Their cost does not depend
+ * on the size of the structuring element.
+ *
+ * The 2D versions are not yet validated against the library ones: the tools
+ * using them keep `Erosion2D` and `Dilation2D` unless `UseVanHerk2D` is set.
+ *
+ * ****************************************************************************/
+
+#ifndef ICARUSCODE_TPC_UTILITIES_VANHERKMORPHOLOGICALFUNCTIONS_H
+#define ICARUSCODE_TPC_UTILITIES_VANHERKMORPHOLOGICALFUNCTIONS_H
+
+// ICARUS libraries
+#include "icaruscode/TPC/Utilities/MorphologicalFilters.h"
+
+// ICARUS signal processing libraries
+#include "icarus_signal_processing/Filters/MorphologicalFunctions1D.h"
+#include "icarus_signal_processing/Filters/MorphologicalFunctions2D.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::min(), std::max()
+#include <limits>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus {
+
+  namespace details {
+
+    /// Running extremum of a waveform with the window of `structuringElement`.
+    template <bool Max>
+    void vanHerkFilter1D(
+      icarus_signal_processing::VectorFloat const& input,
+      std::size_t structuringElement,
+      icarus_signal_processing::VectorFloat& output
+      );
+
+    /**
+     * @brief Running extremum of an image, with a rectangular window.
+     * @param first iterator to the first waveform (channel) of the image
+     * @param numChannels number of waveforms in the image
+     * @param channelElement width of the window along the channels
+     * @param tickElement width of the window along the ticks
+     * @param output iterator to the first waveform of the result
+     *
+     * The rectangular window is separable: the filter is applied first along
+     * the ticks of each waveform, then along the channels of each tick.
+     */
+    template <bool Max>
+    void vanHerkFilter2D(
+      icarus_signal_processing::ArrayFloat::const_iterator first,
+      unsigned int numChannels,
+      std::size_t channelElement, std::size_t tickElement,
+      icarus_signal_processing::ArrayFloat::iterator output
+      );
+
+  } // namespace details
+
+
+  /// Erosion of a waveform, computed in linear time.
+  class VanHerkErosion1D: public icarus_signal_processing::IMorphologicalFunctions1D {
+      public:
+    explicit VanHerkErosion1D(unsigned int structuringElement)
+      : fStructuringElement(structuringElement) {}
+
+    void operator()(
+      icarus_signal_processing::VectorFloat const& input,
+      icarus_signal_processing::VectorFloat& output
+      ) const override
+      { details::vanHerkFilter1D<false>(input, fStructuringElement, output); }
+
+      private:
+    unsigned int fStructuringElement; ///< Width of the window.
+  }; // VanHerkErosion1D
+
+
+  /// Dilation of a waveform, computed in linear time.
+  class VanHerkDilation1D: public icarus_signal_processing::IMorphologicalFunctions1D {
+      public:
+    explicit VanHerkDilation1D(unsigned int structuringElement)
+      : fStructuringElement(structuringElement) {}
+
+    void operator()(
+      icarus_signal_processing::VectorFloat const& input,
+      icarus_signal_processing::VectorFloat& output
+      ) const override
+      { details::vanHerkFilter1D<true>(input, fStructuringElement, output); }
+
+      private:
+    unsigned int fStructuringElement; ///< Width of the window.
+  }; // VanHerkDilation1D
+
+
+  /// Erosion of an image (channel by tick), computed in linear time.
+  class VanHerkErosion2D: public icarus_signal_processing::IMorphologicalFunctions2D {
+      public:
+    VanHerkErosion2D(unsigned int channelElement, unsigned int tickElement)
+      : fChannelElement(channelElement), fTickElement(tickElement) {}
+
+    void operator()(
+      icarus_signal_processing::ArrayFloat::const_iterator first,
+      const unsigned int numChannels,
+      icarus_signal_processing::ArrayFloat::iterator output
+      ) const override
+      {
+        details::vanHerkFilter2D<false>
+          (first, numChannels, fChannelElement, fTickElement, output);
+      }
+
+      private:
+    unsigned int fChannelElement; ///< Width of the window along the channels.
+    unsigned int fTickElement;    ///< Width of the window along the ticks.
+  }; // VanHerkErosion2D
+
+
+  /// Dilation of an image (channel by tick), computed in linear time.
+  class VanHerkDilation2D: public icarus_signal_processing::IMorphologicalFunctions2D {
+      public:
+    VanHerkDilation2D(unsigned int channelElement, unsigned int tickElement)
+      : fChannelElement(channelElement), fTickElement(tickElement) {}
+
+    void operator()(
+      icarus_signal_processing::ArrayFloat::const_iterator first,
+      const unsigned int numChannels,
+      icarus_signal_processing::ArrayFloat::iterator output
+      ) const override
+      {
+        details::vanHerkFilter2D<true>
+          (first, numChannels, fChannelElement, fTickElement, output);
+      }
+
+      private:
+    unsigned int fChannelElement; ///< Width of the window along the channels.
+    unsigned int fTickElement;    ///< Width of the window along the ticks.
+  }; // VanHerkDilation2D
+
+} // namespace icarus
+
+
+// -----------------------------------------------------------------------------
+// ---  implementation
+// -----------------------------------------------------------------------------
+template <bool Max>
+void icarus::details::vanHerkFilter1D(
+  icarus_signal_processing::VectorFloat const& input,
+  std::size_t structuringElement,
+  icarus_signal_processing::VectorFloat& output
+) {
+  if constexpr (Max) morphology::dilation(input, structuringElement, output);
+  else               morphology::erosion(input, structuringElement, output);
+} // icarus::details::vanHerkFilter1D()
+
+
+// -----------------------------------------------------------------------------
+template <bool Max>
+void icarus::details::vanHerkFilter2D(
+  icarus_signal_processing::ArrayFloat::const_iterator first,
+  unsigned int numChannels,
+  std::size_t channelElement, std::size_t tickElement,
+  icarus_signal_processing::ArrayFloat::iterator output
+) {
+  if (numChannels == 0) return;
+
+  morphology::Workspace<float>& workspace = morphology::threadWorkspace<float>();
+
+  // first along the ticks, waveform by waveform...
+  for (unsigned int channel = 0; channel < numChannels; ++channel) {
+    if constexpr (Max)
+      morphology::dilation(first[channel], tickElement, output[channel], workspace);
+    else
+      morphology::erosion(first[channel], tickElement, output[channel], workspace);
+  }
+
+  // ... then along the channels, tick by tick
+  if (channelElement / 2 == 0) return;
+
+  float const identity = Max
+    ? std::numeric_limits<float>::lowest(): std::numeric_limits<float>::max();
+  auto const op = [](float a, float b){ return Max? std::max(a, b): std::min(a, b); };
+
+  std::size_t const numTicks = output[0].size();
+  std::vector<float>& line = workspace.line;
+
+  line.resize(numChannels);
+
+  for (std::size_t tick = 0; tick < numTicks; ++tick) {
+
+    for (unsigned int channel = 0; channel < numChannels; ++channel)
+      line[channel] = output[channel][tick];
+
+    morphology::runningExtremum(line.data(), line.size(), channelElement / 2,
+      identity, op, line.data(), workspace);
+
+    for (unsigned int channel = 0; channel < numChannels; ++channel)
+      output[channel][tick] = line[channel];
+
+  } // for ticks
+
+} // icarus::details::vanHerkFilter2D()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_UTILITIES_VANHERKMORPHOLOGICALFUNCTIONS_H
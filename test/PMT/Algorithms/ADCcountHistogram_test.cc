@@ -0,0 +1,109 @@
+/**
+ * @file ADCcountHistogram_test.cc
+ * @brief Unit test for `ADCcountHistogram.h`
+ * @date October 18, 2026
+ * @see icaruscode/PMT/Algorithms/ADCcountHistogram.h
+ * 
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Algorithms/ADCcountHistogram.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ADCcountHistogram_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::nth_element()
+#include <random>
+#include <cstdlib> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+/// Reference median, as it used to be computed in the baseline modules.
+raw::ADC_Count_t referenceMedian(std::vector<raw::ADC_Count_t> data) {
+  auto const middle = data.begin() + data.size() / 2;
+  std::nth_element(data.begin(), middle, data.end());
+  return *middle;
+} // referenceMedian()
+
+
+// -----------------------------------------------------------------------------
+void simpleStatisticsTest() {
+  
+  std::vector<raw::ADC_Count_t> const samples
+    { 14998, 15000, 15001, 15000, 14999, 15003, 15000, 14999 };
+  
+  opdet::ADCcountHistogram histogram;
+  BOOST_TEST(histogram.empty());
+  
+  histogram.add(samples.begin(), samples.end());
+  BOOST_TEST(histogram.size() == samples.size());
+  BOOST_TEST(histogram.count(15000) == 3U);
+  BOOST_TEST(histogram.count(14997) == 0U);
+  BOOST_TEST(histogram.nth(0) == 14998);
+  BOOST_TEST(histogram.nth(samples.size() - 1) == 15003);
+  BOOST_TEST(histogram.median() == referenceMedian(samples));
+  BOOST_TEST(histogram.mode() == 15000);
+  
+  // in case of tie, the lowest value is the mode
+  histogram.add(14999);
+  BOOST_TEST(histogram.size() == samples.size() + 1);
+  BOOST_TEST(histogram.mode() == 14999);
+  
+  histogram.clear();
+  BOOST_TEST(histogram.empty());
+  BOOST_TEST(histogram.count(15000) == 0U);
+  
+  // out of range values are counted in the closest bin
+  histogram.add(-5);
+  histogram.add(20000);
+  BOOST_TEST(histogram.nth(0) == 0);
+  BOOST_TEST(histogram.nth(1) == 16383);
+  
+} // simpleStatisticsTest()
+
+
+// -----------------------------------------------------------------------------
+void windowMedianTest() {
+  
+  std::mt19937 engine { 12345 };
+  std::normal_distribution<double> noise { 14800.0, 4.0 };
+  
+  std::vector<raw::ADC_Count_t> waveform(5000);
+  for (auto& sample: waveform)
+    sample = static_cast<raw::ADC_Count_t>(noise(engine));
+  // a few pulses
+  for (std::size_t i = 1000; i < 1040; ++i) waveform[i] -= 300;
+  for (std::size_t i = 3500; i < 3700; ++i) waveform[i] -= 50;
+  
+  std::size_t const window = 250U;
+  
+  // the same workspace is reused for all the windows
+  opdet::ADCcountHistogram workspace;
+  for (std::size_t start = 0; start + window <= waveform.size(); start += 50U)
+  {
+    auto const begin = waveform.begin() + start;
+    BOOST_TEST_CONTEXT("Window starting at #" << start) {
+      BOOST_TEST(opdet::medianADC(begin, begin + window, workspace)
+        == referenceMedian({ begin, begin + window }));
+      BOOST_TEST(workspace.empty());
+    }
+  } // for
+  
+  // the convenience function must give the same result
+  BOOST_TEST(opdet::medianADC(waveform.begin(), waveform.end())
+    == referenceMedian(waveform));
+  
+} // windowMedianTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SimpleStatisticsTestCase) {
+  simpleStatisticsTest();
+}
+
+BOOST_AUTO_TEST_CASE(WindowMedianTestCase) {
+  windowMedianTest();
+}
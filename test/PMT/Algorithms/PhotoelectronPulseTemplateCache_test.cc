@@ -0,0 +1,158 @@
+/**
+ * @file PhotoelectronPulseTemplateCache_test.cc
+ * @brief Unit test for `PhotoelectronPulseTemplateCache.h`
+ * @date October 19, 2026
+ * @see icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.h
+ *
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Algorithms/PhotoelectronPulseTemplateCache.h"
+#include "icaruscode/PMT/Algorithms/DiscretePhotoelectronPulse.h"
+#include "icaruscode/PMT/Algorithms/AsymGaussPulseFunction.h"
+
+// LArSoft libraries
+#include "lardataalg/Utilities/quantities/spacetime.h" // nanosecond
+#include "lardataalg/Utilities/quantities/frequency.h" // gigahertz
+#include "lardataalg/Utilities/quantities/electronics.h" // counts_f
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( PhotoelectronPulseTemplateCache_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include <unistd.h> // ::getpid()
+
+
+// -----------------------------------------------------------------------------
+/// A fresh, empty directory removed at the end of the test.
+struct TemporaryDirectory {
+  std::filesystem::path const path;
+
+  TemporaryDirectory(std::string const& name)
+    : path{
+        std::filesystem::temp_directory_path()
+        / (name + "_" + std::to_string(::getpid()))
+      }
+    { std::filesystem::remove_all(path); }
+
+  ~TemporaryDirectory() { std::filesystem::remove_all(path); }
+
+}; // TemporaryDirectory
+
+
+// -----------------------------------------------------------------------------
+void storeAndLoadTest() {
+
+  using Template_t = icarus::opdet::PhotoelectronPulseTemplateCache::Template_t;
+
+  TemporaryDirectory const dir { "PhotoelectronPulseTemplateCache_test" };
+
+  icarus::opdet::PhotoelectronPulseTemplateCache const cache
+    { dir.path.string() };
+  BOOST_TEST(cache.enabled());
+
+  Template_t data;
+  data.nSubsamples = 2U;
+  data.length = 3U;
+  data.samples = { 0.0f, -1.5f, -0.25f, -0.5f, -2.0f, 1.0e-7f };
+
+  // nothing stored yet
+  BOOST_TEST(!cache.load("template A"));
+
+  // the directory is created on the first store
+  BOOST_TEST(cache.store("template A", data));
+  BOOST_TEST(std::filesystem::exists(cache.pathFor("template A")));
+
+  std::optional<Template_t> const loaded = cache.load("template A");
+  BOOST_TEST_REQUIRE(loaded.has_value());
+  BOOST_TEST(loaded->nSubsamples == data.nSubsamples);
+  BOOST_TEST(loaded->length == data.length);
+  BOOST_TEST(loaded->samples == data.samples, boost::test_tools::per_element());
+
+  // a different key is not found
+  BOOST_TEST(!cache.load("template B"));
+
+  // a truncated file is ignored
+  std::filesystem::resize_file(cache.pathFor("template A"), 16U);
+  BOOST_TEST(!cache.load("template A"));
+
+} // storeAndLoadTest()
+
+
+// -----------------------------------------------------------------------------
+void disabledCacheTest() {
+
+  icarus::opdet::PhotoelectronPulseTemplateCache const cache;
+  BOOST_TEST(!cache.enabled());
+
+  icarus::opdet::PhotoelectronPulseTemplateCache::Template_t data;
+  data.nSubsamples = 1U;
+  data.length = 1U;
+  data.samples = { 1.0f };
+
+  BOOST_TEST(!cache.store("template", data));
+  BOOST_TEST(!cache.load("template"));
+
+} // disabledCacheTest()
+
+
+// -----------------------------------------------------------------------------
+void sampledPulseTest() {
+
+  using namespace util::quantities::time_literals;
+  using namespace util::quantities::frequency_literals;
+  using namespace util::quantities::electronics_literals;
+  using util::quantities::nanosecond;
+
+  TemporaryDirectory const dir { "PhotoelectronPulseTemplateCache_pulse_test" };
+  icarus::opdet::PhotoelectronPulseTemplateCache const cache
+    { dir.path.string() };
+
+  icarus::opdet::AsymGaussPulseFunction<nanosecond> const shape
+    { -25.0_ADCf, 55.0_ns, 2.5_ns, 7.0_ns };
+
+  // the first sampling is stored in the cache...
+  icarus::opdet::DiscretePhotoelectronPulse const sampled
+    { shape, 0.5_GHz, 4U, 1.0e-4_ADCf, &cache };
+  BOOST_TEST(!std::filesystem::is_empty(dir.path));
+
+  // ... and the second one is read from there, and must be identical
+  icarus::opdet::DiscretePhotoelectronPulse const loaded
+    { shape, 0.5_GHz, 4U, 1.0e-4_ADCf, &cache };
+
+  // ... as it must be to a sampling which does not use the cache at all
+  icarus::opdet::DiscretePhotoelectronPulse const reference
+    { shape, 0.5_GHz, 4U, 1.0e-4_ADCf };
+
+  BOOST_TEST_REQUIRE(loaded.nSubsamples() == reference.nSubsamples());
+  BOOST_TEST_REQUIRE(loaded.pulseLength() == reference.pulseLength());
+  for (gsl::index i = 0; i < reference.nSubsamples(); ++i) {
+    BOOST_TEST_CONTEXT("subsample #" << i) {
+      auto const& expected = reference.subsample(i);
+      auto const& actual = loaded.subsample(i);
+      BOOST_TEST(std::vector(actual.begin(), actual.end())
+        == std::vector(expected.begin(), expected.end()),
+        boost::test_tools::per_element());
+    }
+  } // for subsamples
+
+} // sampledPulseTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(StoreAndLoadTestCase) {
+  storeAndLoadTest();
+}
+
+BOOST_AUTO_TEST_CASE(DisabledCacheTestCase) {
+  disabledCacheTest();
+}
+
+BOOST_AUTO_TEST_CASE(SampledPulseTestCase) {
+  sampledPulseTest();
+}
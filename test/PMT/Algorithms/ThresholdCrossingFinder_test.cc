@@ -0,0 +1,166 @@
+/**
+ * @file ThresholdCrossingFinder_test.cc
+ * @brief Unit test for `ThresholdCrossingFinder.h`
+ * @date October 18, 2026
+ * @see icaruscode/PMT/Algorithms/ThresholdCrossingFinder.h
+ * 
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Algorithms/ThresholdCrossingFinder.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ThresholdCrossingFinder_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::min()
+#include <cstdlib> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+/// Straightforward, sample by sample implementation of the crossing search.
+template <typename Sample>
+icarus::opdet::ThresholdCrossings_t referenceCrossings(
+  std::vector<Sample> const& waveform, Sample level, int polarity,
+  bool above = false
+) {
+  icarus::opdet::ThresholdCrossings_t crossings;
+  for (std::size_t i = 0; i < waveform.size(); ++i) {
+    bool const beyond = (polarity > 0)
+      ? (waveform[i] >= level): (waveform[i] <= level);
+    if (beyond == above) continue;
+    (beyond? crossings.opening: crossings.closing).push_back(i);
+    above = beyond;
+  } // for
+  return crossings;
+} // referenceCrossings()
+
+
+// -----------------------------------------------------------------------------
+void simpleCrossing_test() {
+  
+  std::vector<int> const waveform
+    { 0, 1, 5, 6, 5, 4, 6, 3, 0, 7 };
+  //  0  1  2  3  4  5  6  7  8  9
+  
+  icarus::opdet::ThresholdCrossingFinder<int> const findCrossings{ { 5, 6 } };
+  BOOST_TEST(findCrossings.nThresholds() == 2U);
+  
+  std::vector<icarus::opdet::ThresholdCrossings_t> const crossings
+    = findCrossings(waveform);
+  BOOST_TEST_REQUIRE(crossings.size() == 2U);
+  
+  std::vector<std::size_t> const expectedOpening5 { 2U, 6U, 9U };
+  std::vector<std::size_t> const expectedClosing5 { 5U, 7U };
+  BOOST_TEST(crossings[0].opening == expectedOpening5, boost::test_tools::per_element());
+  BOOST_TEST(crossings[0].closing == expectedClosing5, boost::test_tools::per_element());
+  
+  std::vector<std::size_t> const expectedOpening6 { 3U, 6U, 9U };
+  std::vector<std::size_t> const expectedClosing6 { 4U, 7U };
+  BOOST_TEST(crossings[1].opening == expectedOpening6, boost::test_tools::per_element());
+  BOOST_TEST(crossings[1].closing == expectedClosing6, boost::test_tools::per_element());
+  
+} // simpleCrossing_test()
+
+
+// -----------------------------------------------------------------------------
+void negativePolarity_test() {
+  
+  std::vector<short int> const waveform
+    { 100, 99, 90, 80, 90, 95, 100, 80, 100 };
+  //    0   1   2   3   4   5    6   7    8
+  
+  icarus::opdet::ThresholdCrossingFinder<short int> const findCrossings
+    { { 90 }, -1 };
+  BOOST_TEST(!findCrossings.isPositive());
+  
+  std::vector<icarus::opdet::ThresholdCrossings_t> const crossings
+    = findCrossings(waveform, 1000U);
+  BOOST_TEST_REQUIRE(crossings.size() == 1U);
+  
+  std::vector<std::size_t> const expectedOpening { 1002U, 1007U };
+  std::vector<std::size_t> const expectedClosing { 1005U, 1008U };
+  BOOST_TEST(crossings[0].opening == expectedOpening, boost::test_tools::per_element());
+  BOOST_TEST(crossings[0].closing == expectedClosing, boost::test_tools::per_element());
+  
+} // negativePolarity_test()
+
+
+// -----------------------------------------------------------------------------
+void longWaveform_test() {
+  
+  // a waveform long enough to span many blocks, with crossings at the borders
+  std::size_t const N = 1000U;
+  std::vector<float> waveform(N, 0.0f);
+  for (std::size_t i = 0; i < N; ++i) {
+    if ((i % 63U) < 7U) waveform[i] = 10.0f;
+    if ((i % 64U) == 63U) waveform[i] = 5.0f;
+    if ((i % 64U) == 0U) waveform[i] = 20.0f;
+  }
+  
+  std::vector<float> const levels { 1.0f, 5.0f, 10.0f, 15.0f, 25.0f };
+  icarus::opdet::ThresholdCrossingFinder<float> const findCrossings{ levels };
+  
+  std::vector<icarus::opdet::ThresholdCrossings_t> const crossings
+    = findCrossings(waveform);
+  BOOST_TEST_REQUIRE(crossings.size() == levels.size());
+  
+  for (std::size_t iLevel = 0; iLevel < levels.size(); ++iLevel) {
+    BOOST_TEST_MESSAGE("Level #" << iLevel << ": " << levels[iLevel]);
+    icarus::opdet::ThresholdCrossings_t const expected
+      = referenceCrossings(waveform, levels[iLevel], +1);
+    BOOST_TEST(crossings[iLevel].opening == expected.opening, boost::test_tools::per_element());
+    BOOST_TEST(crossings[iLevel].closing == expected.closing, boost::test_tools::per_element());
+  } // for
+  
+} // longWaveform_test()
+
+
+// -----------------------------------------------------------------------------
+void piecewise_test() {
+  
+  // scanning in pieces must give the same result as scanning at once
+  std::vector<int> waveform;
+  for (int i = 0; i < 300; ++i) waveform.push_back((i * 37) % 23);
+  
+  icarus::opdet::ThresholdCrossingFinder<int> const findCrossings{ { 8, 16 } };
+  
+  std::vector<icarus::opdet::ThresholdCrossings_t> const all
+    = findCrossings(waveform);
+  
+  std::vector<icarus::opdet::ThresholdCrossings_t> pieces(2U);
+  std::vector<bool> above(2U, false);
+  for (std::size_t start = 0; start < waveform.size(); start += 70U) {
+    std::size_t const n = std::min<std::size_t>(70U, waveform.size() - start);
+    auto const piece
+      = findCrossings(waveform.data() + start, n, start, above);
+    for (std::size_t iLevel = 0; iLevel < 2U; ++iLevel) {
+      pieces[iLevel].opening.insert(pieces[iLevel].opening.end(),
+        piece[iLevel].opening.begin(), piece[iLevel].opening.end());
+      pieces[iLevel].closing.insert(pieces[iLevel].closing.end(),
+        piece[iLevel].closing.begin(), piece[iLevel].closing.end());
+    }
+  } // for
+  
+  for (std::size_t iLevel = 0; iLevel < 2U; ++iLevel) {
+    BOOST_TEST(pieces[iLevel].opening == all[iLevel].opening, boost::test_tools::per_element());
+    BOOST_TEST(pieces[iLevel].closing == all[iLevel].closing, boost::test_tools::per_element());
+  }
+  
+} // piecewise_test()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ThresholdCrossingFinder_testcase) {
+  
+  simpleCrossing_test();
+  negativePolarity_test();
+  longWaveform_test();
+  piecewise_test();
+  
+} // BOOST_AUTO_TEST_CASE(ThresholdCrossingFinder_testcase)
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,331 @@
+/**
+ * @file SimpleFlashAlgo_test.cc
+ * @brief Unit test for the flash clustering of `SimpleFlashAlgo`.
+ * @date October 19, 2026
+ * @see icaruscode/PMT/OpReco/FlashFinder/SimpleFlashAlgo.h
+ *
+ * The flashes are compared with the ones from the original implementation,
+ * which filled dense arrays with all the time bins; that implementation is
+ * reproduced here as `denseRecoFlash()`.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/OpReco/FlashFinder/SimpleFlashAlgo.h"
+
+// framework libraries
+#include "fhiclcpp/ParameterSet.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( SimpleFlashAlgo_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <random>
+#include <vector>
+#include <map>
+#include <string>
+#include <utility> // std::pair
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+/// Configuration shared by the tested algorithm and the reference one.
+struct FlashConfig {
+  double minPEhit = 0.5;
+  double minPEflash = 10.0;
+  double minPEcoinc = 5.0;
+  double minMultCoinc = 2.0;
+  double integralTime = 8.0;
+  double vetoTime = 8.0;
+  double timeRes = 0.03;
+  double preSample = 0.1;
+  int firstChannel = 0;
+  int lastChannel = 9;
+
+  pmtana::Config_t toParameterSet() const
+    {
+      pmtana::Config_t pset;
+      pset.put("PEThresholdHit", minPEhit);
+      pset.put("PEThreshold", minPEflash);
+      pset.put("MinPECoinc", minPEcoinc);
+      pset.put("MinMultCoinc", minMultCoinc);
+      pset.put("IntegralTime", integralTime);
+      pset.put("VetoSize", vetoTime);
+      pset.put("TimeResolution", timeRes);
+      pset.put("PreSample", preSample);
+      pset.put("HitVetoRangeStart", std::vector<double>{});
+      pset.put("HitVetoRangeEnd", std::vector<double>{});
+      pset.put("OpChannelRange", std::vector<int>{ firstChannel, lastChannel });
+      return pset;
+    }
+
+}; // FlashConfig
+
+
+// -----------------------------------------------------------------------------
+/// The flashes from the original, dense time bin, `SimpleFlashAlgo`.
+pmtana::LiteOpFlashArray_t denseRecoFlash
+  (FlashConfig const& config, pmtana::LiteOpHitArray_t const& ophits)
+{
+  std::size_t const max_ch = config.lastChannel;
+  std::size_t const NOpDet = config.lastChannel - config.firstChannel + 1;
+  auto const opchToIndex = [&config](std::size_t opch)
+    { return int(opch) - config.firstChannel; };
+  auto const indexToOpch = [&config](std::size_t index)
+    { return std::size_t(config.firstChannel + index); };
+
+  double min_time=1.1e20;
+  double max_time=1.1e20;
+  for(auto const& oph : ophits) {
+    if(max_time > 1.e20 || oph.peak_time > max_time) max_time = oph.peak_time;
+    if(min_time > 1.e20 || oph.peak_time < min_time) min_time = oph.peak_time;
+  }
+  min_time -= 10* config.timeRes;
+  max_time += 10* config.timeRes;
+
+  std::size_t nbins_pesum_v = (std::size_t)((max_time - min_time) / config.timeRes) + 1;
+  std::vector<double> pesum_v(nbins_pesum_v, 0);
+  std::vector<double> mult_v(nbins_pesum_v, 0);
+  std::vector<std::vector<double>> pespec_v(nbins_pesum_v, std::vector<double>(NOpDet));
+  std::vector<std::vector<unsigned int>> hitidx_v(nbins_pesum_v);
+
+  for(std::size_t hitidx = 0; hitidx < ophits.size(); ++hitidx) {
+    auto const& oph = ophits[hitidx];
+    if(oph.channel > max_ch || opchToIndex(oph.channel) < 0) continue;
+    if(oph.pe <= 0.) continue;
+    if(config.minPEhit > 0. && oph.pe < config.minPEhit) continue;
+    std::size_t index = (std::size_t)((oph.peak_time - min_time) / config.timeRes);
+    pesum_v[index] += oph.pe;
+    mult_v[index] += 1;
+    pespec_v[index][opchToIndex(oph.channel)] += oph.pe;
+    hitidx_v[index].push_back(hitidx);
+  }
+
+  std::map<double,std::size_t> pesum_idx_map;
+  for(std::size_t idx=0; idx<nbins_pesum_v; ++idx) {
+    if(pesum_v[idx] < config.minPEcoinc  ) continue;
+    if(mult_v[idx]  < config.minMultCoinc) continue;
+    pesum_idx_map[1./(pesum_v[idx])] = idx;
+  }
+
+  std::vector<std::pair<std::size_t,std::size_t> > flash_period_v;
+  std::vector<std::size_t> flash_time_v;
+  std::size_t veto_ctr = (std::size_t)(config.vetoTime / config.timeRes);
+  std::size_t default_integral_ctr = (std::size_t)(config.integralTime / config.timeRes);
+  std::size_t precount = (std::size_t)(config.preSample / config.timeRes);
+
+  for(auto const& pe_idx : pesum_idx_map) {
+    auto const& idx = pe_idx.second;
+
+    std::size_t start_time = (idx < precount)? 0: idx - precount;
+
+    bool skip=false;
+    std::size_t integral_ctr = default_integral_ctr;
+    for(auto const& used_period : flash_period_v) {
+      if( start_time <= used_period.first && (start_time + veto_ctr) > used_period.first ) {
+        skip=true;
+        break;
+      }
+      if( used_period.first <= start_time && start_time < (used_period.first + veto_ctr) ) {
+        skip=true;
+        break;
+      }
+      if( used_period.first >= start_time && used_period.first < (start_time + integral_ctr) )
+        integral_ctr = used_period.first - start_time;
+    }
+    if(skip) continue;
+
+    double pesum = 0;
+    for(std::size_t i=start_time; i<std::min(nbins_pesum_v,(start_time+integral_ctr)); ++i)
+      pesum += pesum_v[i];
+    if(pesum < config.minPEflash) continue;
+
+    flash_period_v.emplace_back(start_time,integral_ctr);
+    flash_time_v.push_back(idx);
+  }
+
+  pmtana::LiteOpFlashArray_t res;
+  for(std::size_t flash_idx=0; flash_idx<flash_period_v.size(); ++flash_idx) {
+    auto const& start  = flash_period_v[flash_idx].first;
+    auto const& period = flash_period_v[flash_idx].second;
+    auto const& time   = flash_time_v[flash_idx];
+
+    std::vector<double> pe_v(max_ch+1,0);
+    for(std::size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
+      for(std::size_t pmt_index=0; pmt_index<NOpDet; ++pmt_index)
+        pe_v[indexToOpch(pmt_index)] += pespec_v[index][pmt_index];
+    }
+
+    std::vector<unsigned int> asshit_v;
+    for(std::size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
+      for(auto const& idx : hitidx_v[index]) asshit_v.push_back(idx);
+    }
+
+    res.emplace_back(min_time + time * config.timeRes,
+                     period * config.timeRes / 2.,
+                     std::move(pe_v),
+                     std::move(asshit_v));
+  }
+  return res;
+} // denseRecoFlash()
+
+
+// -----------------------------------------------------------------------------
+/// Returns a hit on `channel` at `time` with `pe` photoelectrons.
+pmtana::LiteOpHit_t makeHit(std::size_t channel, double time, double pe) {
+  pmtana::LiteOpHit_t hit;
+  hit.channel = channel;
+  hit.peak_time = time;
+  hit.pe = pe;
+  return hit;
+} // makeHit()
+
+
+/// Checks that `flashes` are exactly the `expected` ones.
+void checkFlashes(
+  pmtana::LiteOpFlashArray_t const& flashes,
+  pmtana::LiteOpFlashArray_t const& expected
+) {
+  BOOST_TEST_REQUIRE(flashes.size() == expected.size());
+  for (std::size_t iFlash = 0; iFlash < flashes.size(); ++iFlash) {
+    BOOST_TEST_CONTEXT("flash #" << iFlash) {
+      auto const& flash = flashes[iFlash];
+      auto const& expectedFlash = expected[iFlash];
+      BOOST_TEST(flash.time == expectedFlash.time);
+      BOOST_TEST(flash.time_err == expectedFlash.time_err);
+      BOOST_TEST(flash.channel_pe == expectedFlash.channel_pe,
+        boost::test_tools::per_element());
+      BOOST_TEST(flash.asshit_idx == expectedFlash.asshit_idx,
+        boost::test_tools::per_element());
+    } // context
+  } // for
+} // checkFlashes()
+
+
+// -----------------------------------------------------------------------------
+void randomHitsTest() {
+
+  constexpr unsigned int NHitSets = 200U;
+
+  FlashConfig const config;
+  pmtana::SimpleFlashAlgo algo { "SimpleFlashAlgo_test" };
+  algo.Configure(config.toParameterSet());
+
+  std::mt19937 rng { 20261019U };
+  std::uniform_int_distribution<int> nClustersDist { 0, 6 };
+  std::uniform_int_distribution<int> nHitsDist { 1, 12 };
+  std::uniform_real_distribution<double> clusterTimeDist { -50.0, 1500.0 };
+  std::normal_distribution<double> hitSpreadDist { 0.0, 0.05 };
+  // channels out of the configured range are ignored by the algorithm;
+  // integral PE make ties in the bin PE sums likely
+  std::uniform_int_distribution<std::size_t> channelDist { 0U, 11U };
+  std::uniform_int_distribution<int> peDist { 0, 8 };
+
+  unsigned int nFlashes = 0U;
+  for (unsigned int iSet = 0; iSet < NHitSets; ++iSet) {
+    pmtana::LiteOpHitArray_t hits;
+    for (int nClusters = nClustersDist(rng); nClusters > 0; --nClusters) {
+      double const clusterTime = clusterTimeDist(rng);
+      for (int nHits = nHitsDist(rng); nHits > 0; --nHits) {
+        hits.push_back(makeHit(
+          channelDist(rng), clusterTime + hitSpreadDist(rng), peDist(rng)
+          ));
+      }
+    } // for clusters
+
+    BOOST_TEST_CONTEXT("hit set #" << iSet << " (" << hits.size() << " hits)") {
+      auto const expected = denseRecoFlash(config, hits);
+      checkFlashes(algo.RecoFlash(hits), expected);
+      nFlashes += expected.size();
+    }
+  } // for hit sets
+
+  // the comparison is meaningful only if there are flashes
+  BOOST_TEST(nFlashes > NHitSets);
+
+} // randomHitsTest()
+
+
+// -----------------------------------------------------------------------------
+void truncationTest() {
+  /*
+   * The integration of a flash is truncated at the start of any flash claimed
+   * before it. Since the integration time can't exceed the veto time, a flash
+   * that would be truncated is vetoed instead, and the truncation can only
+   * happen right at its limit: a flash starting exactly one veto time before
+   * a brighter one integrates up to the start of that one, and no further.
+   *
+   * Bins are exact in binary: 0.25 us each, 8 bins of integration and veto.
+   * The first hit, at 0 us, sets the bin 0 at -2.5 us.
+   */
+  FlashConfig config;
+  config.integralTime = 2.0;
+  config.vetoTime = 2.0;
+  config.timeRes = 0.25;
+  config.preSample = 0.0;
+
+  pmtana::SimpleFlashAlgo algo { "SimpleFlashAlgo_test" };
+  algo.Configure(config.toParameterSet());
+
+  pmtana::LiteOpHitArray_t const hits {
+    makeHit(0, 0.0, 1.0),     // #0 (bin 10): too dim to be a candidate
+    makeHit(0, 4.0, 10.0),    // #1 (bin 26): brightest, first flash
+    makeHit(1, 4.0, 10.0),    // #2
+    makeHit(2, 4.0, 10.0),    // #3
+    makeHit(3, 2.0, 5.0),     // #4 (bin 18): 8 bins before the first flash
+    makeHit(4, 2.0, 5.0),     // #5
+    makeHit(5, 2.25, 3.0),    // #6 (bin 19): vetoed by the first flash
+    makeHit(6, 2.25, 3.0),    // #7
+    makeHit(7, 3.875, 4.0),   // #8 (bin 25): last bin of the second flash
+    makeHit(8, 4.25, 2.0),    // #9 (bin 27): in the first flash
+  };
+
+  auto const expected = denseRecoFlash(config, hits);
+  auto const flashes = algo.RecoFlash(hits);
+  checkFlashes(flashes, expected);
+
+  BOOST_TEST_REQUIRE(flashes.size() == 2U);
+
+  // the brightest flash, integrated over the full time
+  BOOST_TEST(flashes[0].time == 4.0);
+  BOOST_TEST(flashes[0].time_err == 1.0);
+  BOOST_TEST(flashes[0].asshit_idx
+    == (std::vector<unsigned int>{ 1U, 2U, 3U, 9U }),
+    boost::test_tools::per_element());
+
+  // the second flash: integration stops right before the first one
+  BOOST_TEST(flashes[1].time == 2.0);
+  BOOST_TEST(flashes[1].time_err == 1.0);
+  BOOST_TEST(flashes[1].asshit_idx
+    == (std::vector<unsigned int>{ 4U, 5U, 6U, 7U, 8U }),
+    boost::test_tools::per_element());
+  BOOST_TEST(flashes[1].channel_pe[7] == 4.0);
+  BOOST_TEST(flashes[1].channel_pe[0] == 0.0);
+
+} // truncationTest()
+
+
+// -----------------------------------------------------------------------------
+void noHitTest() {
+
+  FlashConfig const config;
+  pmtana::SimpleFlashAlgo algo { "SimpleFlashAlgo_test" };
+  algo.Configure(config.toParameterSet());
+
+  BOOST_TEST(algo.RecoFlash({}).empty());
+
+} // noHitTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(RandomHitsTestCase) {
+  randomHitsTest();
+}
+
+BOOST_AUTO_TEST_CASE(TruncationTestCase) {
+  truncationTest();
+}
+
+BOOST_AUTO_TEST_CASE(NoHitTestCase) {
+  noHitTest();
+}
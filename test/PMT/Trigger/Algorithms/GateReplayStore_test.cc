@@ -0,0 +1,305 @@
+/**
+ * @file GateReplayStore_test.cc
+ * @brief Unit test for the gate replay store in `GateReplayStore.h`.
+ * @date October 19, 2026
+ * @see icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/GateReplayStore.h"
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowChannelMap.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
+#include "icaruscode/IcarusObj/OpDetWaveformMeta.h"
+
+// test helpers
+#include "WindowTopologyTestHelpers.h" // makeTopology()
+
+// LArSoft libraries
+#include "larcorealg/CoreUtils/zip.h"
+
+// framework libraries
+#include "canvas/Persistency/Provenance/EventID.h"
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TTree.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( GateReplayStore_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <random>
+#include <vector>
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+using TriggerGates_t = icarus::trigger::GateReplayEvent::TriggerGates_t;
+
+/// Returns gates with random openings, tracking the waveforms in `waveforms`.
+TriggerGates_t makeGates(
+  icarus::trigger::WindowChannelMap const& topology,
+  std::vector<sbn::OpDetWaveformMeta> const& waveforms,
+  std::mt19937& rng
+) {
+  std::uniform_int_distribution<int> startDist{ -20, 180 };
+  std::uniform_int_distribution<int> lengthDist{ 1, 25 };
+  std::uniform_int_distribution<int> levelDist{ 1, 4 };
+  std::uniform_int_distribution<int> countDist{ 0, 6 };
+  
+  TriggerGates_t gates;
+  for (auto const& info: topology) {
+    icarus::trigger::GateReplayEvent::TriggerGate_t gate;
+    for (raw::Channel_t const channel: info.channels) {
+      gate.gate().addChannel(channel);
+      for (sbn::OpDetWaveformMeta const& waveform: waveforms)
+        if (waveform.channel == channel) gate.tracking().add(&waveform);
+    } // for channels
+    for (int nOpenings = countDist(rng); nOpenings > 0; --nOpenings) {
+      int const start = startDist(rng);
+      gate.gate().openBetween(start, start + lengthDist(rng), levelDist(rng));
+    }
+    gates.push_back(std::move(gate));
+  } // for windows
+  
+  return gates;
+} // makeGates()
+
+
+/// Checks that the two gates have the same content (tracking excluded).
+void checkSameGate(
+  icarus::trigger::GateReplayEvent::TriggerGate_t const& test,
+  icarus::trigger::GateReplayEvent::TriggerGate_t const& expected
+) {
+  auto const& testGate = test.gate();
+  auto const& expectedGate = expected.gate();
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    testGate.channels().begin(), testGate.channels().end(),
+    expectedGate.channels().begin(), expectedGate.channels().end()
+    );
+  for (int tick = -50; tick < 250; ++tick) {
+    BOOST_TEST_CONTEXT("tick " << tick) {
+      BOOST_TEST
+        (testGate.openingCount(tick) == expectedGate.openingCount(tick));
+    }
+  } // for
+} // checkSameGate()
+
+
+// -----------------------------------------------------------------------------
+void WindowPatternTag_test() {
+  
+  for (std::string const tag: {
+    "M1", "M0", "M5O2", "S5", "M5S7", "M2D1req", "M3O1D2U1req", "M1U0req"
+  }) {
+    BOOST_TEST_CONTEXT("tag '" << tag << "'") {
+      BOOST_TEST(icarus::trigger::makeWindowPattern(tag).tag() == tag);
+    }
+  } // for
+  
+  auto const pattern = icarus::trigger::makeWindowPattern("M5O2D2reqU1");
+  BOOST_TEST(pattern.minInMainWindow == 5U);
+  BOOST_TEST(pattern.minInOppositeWindow == 2U);
+  BOOST_TEST(pattern.minSumInOppositeWindows == 0U);
+  BOOST_TEST(pattern.minInDownstreamWindow == 2U);
+  BOOST_TEST(pattern.requireDownstreamWindow);
+  BOOST_TEST(pattern.minInUpstreamWindow == 1U);
+  BOOST_TEST(!pattern.requireUpstreamWindow);
+  
+  for (std::string const tag: { "", "M", "X3", "M1M2", "O2req", "M1D" }) {
+    BOOST_TEST_CONTEXT("tag '" << tag << "'") {
+      BOOST_CHECK_THROW
+        (icarus::trigger::makeWindowPattern(tag), cet::exception);
+    }
+  } // for
+  
+} // WindowPatternTag_test()
+
+
+// -----------------------------------------------------------------------------
+void GateReplayStore_test() {
+  
+  constexpr unsigned int NEvents = 20U;
+  
+  icarus::trigger::WindowChannelMap const topology = makeTopology();
+  std::vector<icarus::trigger::WindowPattern> const patterns {
+    icarus::trigger::makeWindowPattern("M1"),
+    icarus::trigger::makeWindowPattern("M3O1"),
+    icarus::trigger::makeWindowPattern("S5"),
+    icarus::trigger::makeWindowPattern("M2D1req"),
+    };
+  
+  std::vector<sbn::OpDetWaveformMeta> waveforms(3U);
+  waveforms[0].channel = 2;
+  waveforms[0].startTime = -1.5;
+  waveforms[1].channel = 2;
+  waveforms[1].startTime = 4.0;
+  waveforms[2].channel = 13;
+  waveforms[2].startTime = 0.5;
+  
+  //
+  // write
+  //
+  TTree eventTree{ "TestEvents", "test replay store events" };
+  eventTree.SetDirectory(nullptr);
+  TTree windowTree{ "TestWindows", "test replay store windows" };
+  windowTree.SetDirectory(nullptr);
+  
+  std::mt19937 rng{ 12345U };
+  std::vector<TriggerGates_t> allGates;
+  std::vector<icarus::trigger::SlidingWindowPatternAlg::AllTriggerInfo_t>
+    recorded;
+  {
+    icarus::trigger::GateReplayStoreWriter writer{ eventTree, windowTree };
+    BOOST_TEST(!writer.hasTopology());
+    
+    icarus::trigger::SlidingWindowPatternAlg const recordingAlg
+      { topology, patterns[1] };
+    for (unsigned int iEvent = 0U; iEvent < NEvents; ++iEvent) {
+      allGates.push_back(makeGates(topology, waveforms, rng));
+      recorded.push_back(recordingAlg.simulateResponse(allGates.back()));
+      writer.setTopology(topology);
+      writer.add(
+        art::EventID{ 1U, 2U, iEvent + 1U }, -10, 160,
+        allGates.back(), recorded.back()
+        );
+    } // for
+    BOOST_TEST(writer.hasTopology());
+  }
+  BOOST_TEST(eventTree.GetEntries() == NEvents);
+  BOOST_TEST(windowTree.GetEntries() == topology.nWindows());
+  
+  //
+  // read back
+  //
+  icarus::trigger::GateReplayStoreReader reader{ eventTree, windowTree };
+  BOOST_TEST(reader.nEvents() == NEvents);
+  
+  icarus::trigger::WindowChannelMap const& readTopology = reader.topology();
+  BOOST_TEST(readTopology.nWindows() == topology.nWindows());
+  for (auto const& [ readInfo, info ]: util::zip(readTopology, topology)) {
+    BOOST_TEST(readInfo.index == info.index);
+    BOOST_TEST(readInfo.opposite == info.opposite);
+    BOOST_TEST(readInfo.upstream == info.upstream);
+    BOOST_TEST(readInfo.downstream == info.downstream);
+    BOOST_TEST(readInfo.cryoid == info.cryoid);
+    BOOST_TEST(readInfo.center == info.center);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+      readInfo.channels.begin(), readInfo.channels.end(),
+      info.channels.begin(), info.channels.end()
+      );
+  } // for
+  
+  for (unsigned int iEvent = 0U; iEvent < NEvents; ++iEvent) {
+    BOOST_TEST_CONTEXT("event #" << iEvent) {
+      
+      icarus::trigger::GateReplayEvent const& event = reader.read(iEvent);
+      BOOST_TEST(event.run == 1U);
+      BOOST_TEST(event.subRun == 2U);
+      BOOST_TEST(event.event == iEvent + 1U);
+      BOOST_TEST(event.beamGateStart == -10);
+      BOOST_TEST(event.beamGateEnd == 160);
+      
+      TriggerGates_t const& expectedGates = allGates[iEvent];
+      BOOST_TEST(event.nWindows() == expectedGates.size());
+      
+      // tracking information
+      for (std::size_t iWindow = 0U; iWindow < event.nWindows(); ++iWindow) {
+        BOOST_TEST
+          (event.trackBegin[iWindow + 1U] - event.trackBegin[iWindow]
+          == expectedGates[iWindow].tracking().nTracked());
+      }
+      
+      // tracking restored from the store: same waveforms, once each
+      std::vector<sbn::OpDetWaveformMeta> const readWaveforms
+        = event.trackedWaveforms();
+      BOOST_TEST(readWaveforms.size() == waveforms.size());
+      TriggerGates_t const trackingGates = event.gates(readWaveforms);
+      for (std::size_t iWindow = 0U; iWindow < event.nWindows(); ++iWindow) {
+        BOOST_TEST_CONTEXT("window #" << iWindow) {
+          auto const& expectedTracking = expectedGates[iWindow].tracking();
+          auto const& tracking = trackingGates[iWindow].tracking();
+          BOOST_TEST(tracking.nTracked() == expectedTracking.nTracked());
+          for (auto const& [ readWaveform, waveform ]
+            : util::zip(tracking.getTracked(), expectedTracking.getTracked())
+          ) {
+            BOOST_TEST(readWaveform->channel == waveform->channel);
+            BOOST_TEST(readWaveform->startTime == waveform->startTime);
+            BOOST_TEST(readWaveform >= readWaveforms.data());
+            BOOST_TEST(readWaveform < readWaveforms.data() + readWaveforms.size());
+          } // for
+          checkSameGate(trackingGates[iWindow], expectedGates[iWindow]);
+        }
+      } // for windows
+      
+      // a waveform not supplied is an error
+      if (!readWaveforms.empty()) {
+        std::vector<sbn::OpDetWaveformMeta> const missing
+          { readWaveforms.begin() + 1, readWaveforms.end() };
+        BOOST_CHECK_THROW(event.gates(missing), cet::exception);
+      }
+      
+      // gate content
+      TriggerGates_t const gates = event.gates();
+      BOOST_TEST(gates.size() == expectedGates.size());
+      for (std::size_t iWindow = 0U; iWindow < gates.size(); ++iWindow) {
+        BOOST_TEST_CONTEXT("window #" << iWindow) {
+          checkSameGate(gates[iWindow], expectedGates[iWindow]);
+        }
+      }
+      
+      // the recorded response
+      auto const& expected = recorded[iEvent];
+      BOOST_TEST(event.fired == expected.info.fired());
+      if (expected.info.fired()) {
+        BOOST_TEST(event.triggerTick == expected.info.atTick().value());
+        BOOST_TEST(event.triggerWindow == int(expected.extra.windowIndex));
+      }
+      
+      // the replay of the recording pattern matches the stored response,
+      // as `replayTriggerPatterns --check` does on a store written by a module
+      {
+        icarus::trigger::SlidingWindowPatternAlg const patternAlg
+          { readTopology, patterns[1] };
+        auto const replay = patternAlg.simulateResponse(gates);
+        BOOST_TEST(replay.info.fired() == bool(event.fired));
+        if (event.fired) {
+          BOOST_TEST(replay.info.atTick().value() == event.triggerTick);
+          BOOST_TEST(int(replay.extra.windowIndex) == event.triggerWindow);
+        }
+      }
+      
+      // the replay of all patterns
+      for (icarus::trigger::WindowPattern const& pattern: patterns) {
+        BOOST_TEST_CONTEXT("pattern " << pattern.tag()) {
+          icarus::trigger::SlidingWindowPatternAlg const patternAlg
+            { readTopology, pattern };
+          auto const replay = patternAlg.simulateResponse(gates);
+          auto const original = patternAlg.simulateResponse(expectedGates);
+          BOOST_TEST(replay.info.fired() == original.info.fired());
+          if (original.info.fired()) {
+            BOOST_TEST(replay.info.atTick() == original.info.atTick());
+            BOOST_TEST(replay.extra.windowIndex == original.extra.windowIndex);
+          }
+        }
+      } // for patterns
+      
+    } // context
+  } // for events
+  
+} // GateReplayStore_test()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(WindowPatternTagTestCase) {
+  WindowPatternTag_test();
+} // BOOST_AUTO_TEST_CASE(WindowPatternTagTestCase)
+
+BOOST_AUTO_TEST_CASE(GateReplayStoreTestCase) {
+  GateReplayStore_test();
+} // BOOST_AUTO_TEST_CASE(GateReplayStoreTestCase)
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,149 @@
+/**
+ * @file SlidingWindowPatternGridAlg_test.cc
+ * @brief Unit test for `SlidingWindowPatternGridAlg.h`.
+ * @date October 19, 2026
+ * @see icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.h
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternGridAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowChannelMap.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
+
+// test helpers
+#include "WindowTopologyTestHelpers.h" // makeTopology()
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( SlidingWindowPatternGridAlg_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <random>
+#include <vector>
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+using PatternAlg_t = icarus::trigger::SlidingWindowPatternAlg;
+using TriggerGates_t = PatternAlg_t::TriggerGates_t;
+
+/// Returns gates with random openings, up to `maxLevel`.
+TriggerGates_t makeGates(
+  icarus::trigger::WindowChannelMap const& topology, int maxLevel,
+  std::mt19937& rng
+) {
+  std::uniform_int_distribution<int> startDist{ 0, 200 };
+  std::uniform_int_distribution<int> lengthDist{ 1, 25 };
+  std::uniform_int_distribution<int> levelDist{ 1, maxLevel };
+  std::uniform_int_distribution<int> countDist{ 0, 5 };
+
+  TriggerGates_t gates;
+  for (auto const& info: topology) {
+    PatternAlg_t::InputTriggerGate_t gate;
+    for (raw::Channel_t const channel: info.channels)
+      gate.gate().addChannel(channel);
+    for (int nOpenings = countDist(rng); nOpenings > 0; --nOpenings) {
+      int const start = startDist(rng);
+      gate.gate().openBetween(start, start + lengthDist(rng), levelDist(rng));
+    }
+    gates.push_back(std::move(gate));
+  } // for windows
+
+  return gates;
+} // makeGates()
+
+
+// -----------------------------------------------------------------------------
+void gridVsSeparateRunsTest() {
+
+  constexpr unsigned int NEvents = 50U;
+
+  icarus::trigger::WindowChannelMap const topology = makeTopology();
+
+  // patterns sharing some of the window combinations, in an order where the
+  // cache is filled by one pattern and reused by the following ones
+  std::vector<icarus::trigger::WindowPattern> patterns;
+  for (std::string const tag: {
+    "M1", "M3O1", "S5", "M2O2", "M2D1req", "M3U1req", "M2S4", "M1O1D1U1",
+    "M5", "M1"
+  }) {
+    patterns.push_back(icarus::trigger::makeWindowPattern(tag));
+  }
+
+  icarus::trigger::SlidingWindowPatternGridAlg const gridAlg
+    { topology, patterns };
+  BOOST_TEST(gridAlg.nPatterns() == patterns.size());
+
+  std::vector<PatternAlg_t> separateAlgs;
+  for (icarus::trigger::WindowPattern const& pattern: patterns)
+    separateAlgs.emplace_back(topology, pattern);
+
+  // the gates of each event at different thresholds, as the modules see them:
+  // lower thresholds have higher levels
+  std::mt19937 rng{ 54321U };
+  std::vector<int> const thresholdMaxLevels { 6, 4, 2 };
+
+  unsigned int nFired = 0U;
+  for (unsigned int iEvent = 0U; iEvent < NEvents; ++iEvent) {
+    for (int const maxLevel: thresholdMaxLevels) {
+      BOOST_TEST_CONTEXT("event #" << iEvent << " max level " << maxLevel) {
+
+        TriggerGates_t const gates = makeGates(topology, maxLevel, rng);
+
+        auto const responses = gridAlg.simulateResponses(gates);
+        BOOST_TEST_REQUIRE(responses.size() == patterns.size());
+
+        for (std::size_t iPattern = 0U; iPattern < patterns.size(); ++iPattern)
+        {
+          BOOST_TEST_CONTEXT("pattern " << patterns[iPattern].tag()) {
+            auto const& response = responses[iPattern];
+            auto const expected
+              = separateAlgs[iPattern].simulateResponse(gates);
+            BOOST_TEST(response.info.fired() == expected.info.fired());
+            if (expected.info.fired()) {
+              ++nFired;
+              BOOST_TEST(response.info.atTick() == expected.info.atTick());
+              BOOST_TEST(response.info.level() == expected.info.level());
+              BOOST_TEST
+                (response.info.nTriggers() == expected.info.nTriggers());
+              BOOST_TEST
+                (response.extra.windowIndex == expected.extra.windowIndex);
+            }
+          } // context
+        } // for patterns
+
+      } // context
+    } // for thresholds
+  } // for events
+
+  // the comparison is meaningful only if some of the patterns did fire
+  BOOST_TEST(nFired > 0U);
+
+} // gridVsSeparateRunsTest()
+
+
+// -----------------------------------------------------------------------------
+void noPatternTest() {
+
+  icarus::trigger::WindowChannelMap const topology = makeTopology();
+  icarus::trigger::SlidingWindowPatternGridAlg const gridAlg{ topology, {} };
+
+  std::mt19937 rng{ 12345U };
+  BOOST_TEST(gridAlg.nPatterns() == 0U);
+  BOOST_TEST(gridAlg.simulateResponses(makeGates(topology, 3, rng)).empty());
+
+} // noPatternTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(GridVsSeparateRunsTestCase) {
+  gridVsSeparateRunsTest();
+} // BOOST_AUTO_TEST_CASE(GridVsSeparateRunsTestCase)
+
+BOOST_AUTO_TEST_CASE(NoPatternTestCase) {
+  noPatternTest();
+} // BOOST_AUTO_TEST_CASE(NoPatternTestCase)
+
+
+// -----------------------------------------------------------------------------
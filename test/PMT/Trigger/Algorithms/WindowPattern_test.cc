@@ -0,0 +1,76 @@
+/**
+ * @file WindowPattern_test.cc
+ * @brief Unit test for the pattern tags of `WindowPattern.h`.
+ * @date October 19, 2026
+ * @see icaruscode/PMT/Trigger/Algorithms/WindowPattern.h
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( WindowPattern_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+void tagRoundTripTest() {
+
+  for (std::string const tag: { "M1", "M3O1", "S5", "M2O2D1req", "M1O1D1U1req" })
+  {
+    BOOST_TEST_CONTEXT("tag '" << tag << "'") {
+      BOOST_TEST(icarus::trigger::makeWindowPattern(tag).tag() == tag);
+    }
+  }
+
+  icarus::trigger::WindowPattern const pattern
+    = icarus::trigger::makeWindowPattern("M5O2D2reqU1");
+  BOOST_TEST(pattern.minInMainWindow == 5U);
+  BOOST_TEST(pattern.minInOppositeWindow == 2U);
+  BOOST_TEST(pattern.minInDownstreamWindow == 2U);
+  BOOST_TEST(pattern.requireDownstreamWindow);
+  BOOST_TEST(pattern.minInUpstreamWindow == 1U);
+  BOOST_TEST(!pattern.requireUpstreamWindow);
+
+  // the largest value still fits
+  BOOST_TEST(icarus::trigger::makeWindowPattern("M4294967295").minInMainWindow
+    == 4294967295U);
+
+} // tagRoundTripTest()
+
+
+// -----------------------------------------------------------------------------
+void malformedTagTest() {
+
+  for (std::string const tag: {
+    "M4294967296",          // value does not fit in `unsigned int`
+    "M99999999999999999999", // value does not fit in any integer
+    "M",                    // no value
+    "M-1",                  // no (positive) value
+    "X3",                   // unknown requirement
+    "M1M2",                 // repeated requirement
+    "M2req",                // mandatory requirement on the main window
+  }) {
+    BOOST_TEST_CONTEXT("tag '" << tag << "'") {
+      BOOST_CHECK_THROW
+        (icarus::trigger::makeWindowPattern(tag), cet::exception);
+    }
+  }
+
+} // malformedTagTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(TagRoundTripTestCase) {
+  tagRoundTripTest();
+}
+
+BOOST_AUTO_TEST_CASE(MalformedTagTestCase) {
+  malformedTagTest();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file WindowTopologyTestHelpers.h
+ * @brief Window topology shared by the sliding window algorithm tests.
+ * @date October 19, 2026
+ */
+
+#ifndef TEST_PMT_TRIGGER_ALGORITHMS_WINDOWTOPOLOGYTESTHELPERS_H
+#define TEST_PMT_TRIGGER_ALGORITHMS_WINDOWTOPOLOGYTESTHELPERS_H
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/WindowChannelMap.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <utility> // std::move()
+
+
+// -----------------------------------------------------------------------------
+/// Returns two pairs of opposite windows, each pair up/downstream, with four
+/// channels each (channels of window `i` are `4i` to `4i + 3`).
+inline icarus::trigger::WindowChannelMap makeTopology() {
+  
+  using WindowChannelMap = icarus::trigger::WindowChannelMap;
+  
+  std::vector<WindowChannelMap::WindowInfo_t> windows(4U);
+  for (unsigned int iWindow = 0U; iWindow < windows.size(); ++iWindow) {
+    auto& info = windows[iWindow];
+    info.index = iWindow;
+    info.opposite = iWindow ^ 2U;
+    if (iWindow & 1U) info.upstream = iWindow - 1U;
+    else              info.downstream = iWindow + 1U;
+    info.cryoid = geo::CryostatID{ 0U };
+    info.center = geo::Point_t{
+      (iWindow & 2U)? 100.0: -100.0, 0.0, (iWindow & 1U)? 450.0: -450.0
+      };
+    for (unsigned int i = 0U; i < 4U; ++i)
+      info.channels.push_back(iWindow * 4U + i);
+  } // for
+  
+  return WindowChannelMap{ std::move(windows) };
+} // makeTopology()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // TEST_PMT_TRIGGER_ALGORITHMS_WINDOWTOPOLOGYTESTHELPERS_H
@@ -0,0 +1,230 @@
+/**
+ * @file DenseTriggerGates_test.cc
+ * @brief Unit test for the dense gate representations in `DenseTriggerGates.h`
+ * @date October 19, 2026
+ * @see icaruscode/PMT/Trigger/Utilities/DenseTriggerGates.h
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Utilities/DenseTriggerGates.h"
+#include "icaruscode/PMT/Trigger/Utilities/TriggerGateOperations.h"
+#include "sbnobj/ICARUS/PMT/Trigger/Data/OpticalTriggerGate.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( DenseTriggerGates_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <vector>
+#include <random>
+#include <cstdint>
+
+
+// -----------------------------------------------------------------------------
+using GateData_t = icarus::trigger::OpticalTriggerGateData_t::GateData_t;
+
+
+// -----------------------------------------------------------------------------
+std::vector<GateData_t> makeGates() {
+
+  std::vector<GateData_t> gates(3);
+
+  gates[0].openBetween(10, 20);
+  gates[0].openBetween(15, 90, 2);
+
+  gates[1].openBetween(5, 70);
+  gates[1].openBetween(130, 200); // ends out of the window
+
+  // gates[2] stays closed
+
+  return gates;
+} // makeGates()
+
+
+// -----------------------------------------------------------------------------
+void DenseGateLevels_test() {
+
+  std::vector<GateData_t> const gates = makeGates();
+
+  icarus::trigger::DenseGateLevels<> levels{ gates.size(), 0, 150 };
+  for (std::size_t i = 0; i < gates.size(); ++i) levels.setGate(i, gates[i]);
+
+  BOOST_TEST(levels.nGates() == gates.size());
+  BOOST_TEST(levels.nTicks() == 150U);
+
+  for (std::size_t i = 0; i < gates.size(); ++i) {
+    for (std::ptrdiff_t tick = 0; tick < 150; ++tick) {
+      BOOST_TEST_CONTEXT("Gate #" << i << " tick " << tick) {
+        BOOST_TEST(levels.level(i, tick) == gates[i].openingCount(tick));
+      }
+    } // for ticks
+  } // for gates
+  BOOST_TEST(levels.level(1, 150) == 0U); // out of window
+
+  // conversion back
+  BOOST_TEST(levels.toGate<GateData_t>(0) == gates[0]);
+  BOOST_TEST(levels.toGate<GateData_t>(2) == gates[2]);
+
+  // combinations against the gate operations
+  GateData_t const sum = icarus::trigger::sumGates(gates);
+  GateData_t const max = icarus::trigger::maxGates(gates);
+  auto const sumLevels = levels.sum();
+  auto const maxLevels = levels.max();
+  auto const minLevels = levels.min();
+  std::vector<std::uint16_t> min01Levels(levels.nTicks());
+  levels.min({ 0U, 1U }, min01Levels.data());
+  for (std::ptrdiff_t tick = 0; tick < 150; ++tick) {
+    BOOST_TEST_CONTEXT("Tick " << tick) {
+      BOOST_TEST(sumLevels[tick] == sum.openingCount(tick));
+      BOOST_TEST(maxLevels[tick] == max.openingCount(tick));
+      BOOST_TEST(minLevels[tick] == 0U);
+      BOOST_TEST(min01Levels[tick] == std::min(
+        gates[0].openingCount(tick), gates[1].openingCount(tick)
+        ));
+    }
+  } // for
+
+} // DenseGateLevels_test()
+
+
+// -----------------------------------------------------------------------------
+void combineDenseGates_test() {
+
+  using icarus::trigger::DenseGateLevels;
+
+  std::vector<GateData_t> gates = makeGates();
+  gates.emplace_back().openBetween(-50, 40); // starts before all the others
+
+  GateData_t alwaysOpen;
+  alwaysOpen.openAt(alwaysOpen.MinTick);
+  alwaysOpen.openBetween(60, 80);
+
+  std::vector<GateData_t const*> const ptrs
+    { &gates[0], &gates[1], &gates[2], &gates[3], &alwaysOpen };
+  std::vector<GateData_t const*> const closed { &gates[2] };
+
+  GateData_t sum, max, min, min01, empty;
+  icarus::trigger::combineDenseGates(ptrs, &DenseGateLevels<>::sum, sum);
+  icarus::trigger::combineDenseGates(ptrs, &DenseGateLevels<>::max, max);
+  icarus::trigger::combineDenseGates
+    ({ &gates[0], &gates[1] }, &DenseGateLevels<>::min, min01);
+  icarus::trigger::combineDenseGates
+    ({ &alwaysOpen, &gates[1] }, &DenseGateLevels<>::min, min);
+  icarus::trigger::combineDenseGates
+    (closed, &DenseGateLevels<>::sum, empty);
+
+  // the results must be the same as the ones of the gate operations
+  std::vector<GateData_t> allGates { gates };
+  allGates.push_back(alwaysOpen);
+  BOOST_TEST(sum == icarus::trigger::sumGates(allGates));
+  BOOST_TEST(max == icarus::trigger::maxGates(allGates));
+  BOOST_TEST(min01 == icarus::trigger::minGates(gates[0], gates[1]));
+  BOOST_TEST(min == icarus::trigger::minGates(alwaysOpen, gates[1]));
+  BOOST_TEST(empty == gates[2]);
+
+} // combineDenseGates_test()
+
+
+// -----------------------------------------------------------------------------
+/// Returns `n` discriminated PMT gates: short level 1 pulses over a readout of
+/// about one and a half millisecond (optical ticks of 2 ns).
+std::vector<GateData_t> makeDiscriminatedGates(std::size_t n, std::mt19937& rng)
+{
+  std::uniform_int_distribution<int> startDist{ -375000, 375000 };
+  std::uniform_int_distribution<int> beamDist{ -100, 900 };
+  std::uniform_int_distribution<int> widthDist{ 4, 40 };
+  std::uniform_int_distribution<int> countDist{ 0, 12 };
+
+  std::vector<GateData_t> gates(n);
+  for (GateData_t& gate: gates) {
+    // pulses scattered over the readout (mostly overlapping in the beam gate)
+    for (int nPulses = countDist(rng); nPulses > 0; --nPulses) {
+      int const start = (nPulses % 3 == 0)? startDist(rng): beamDist(rng);
+      gate.openBetween(start, start + widthDist(rng));
+    }
+  } // for
+  return gates;
+} // makeDiscriminatedGates()
+
+
+// -----------------------------------------------------------------------------
+void realShapedGates_test() {
+
+  /*
+   * The combinations of LVDSgates (AND and OR of channel pairs) and of
+   * SlidingWindowCombinerAlg (sum of the LVDS gates of a window) are done
+   * with the sparse gate operations; the dense ones must give the same gates.
+   */
+  using icarus::trigger::DenseGateLevels;
+
+  std::mt19937 rng{ 2048U };
+
+  for (int iEvent = 0; iEvent < 10; ++iEvent) {
+    BOOST_TEST_CONTEXT("event #" << iEvent) {
+
+      // 30 PMT in a window, paired in 15 LVDS channels
+      std::vector<GateData_t> const channelGates
+        = makeDiscriminatedGates(30U, rng);
+
+      std::vector<GateData_t> LVDSgates;
+      for (std::size_t iPair = 0; iPair < 15U; ++iPair) {
+        BOOST_TEST_CONTEXT("pair #" << iPair) {
+          GateData_t const& A = channelGates[2 * iPair];
+          GateData_t const& B = channelGates[2 * iPair + 1];
+
+          GateData_t denseAND, denseOR;
+          icarus::trigger::combineDenseGates
+            ({ &A, &B }, &DenseGateLevels<>::min, denseAND);
+          icarus::trigger::combineDenseGates
+            ({ &A, &B }, &DenseGateLevels<>::max, denseOR);
+
+          BOOST_TEST(denseAND == icarus::trigger::minGates(A, B));
+          GateData_t const sparseOR = icarus::trigger::maxGates(A, B);
+          BOOST_TEST(denseOR == sparseOR);
+          LVDSgates.push_back(sparseOR);
+        }
+      } // for pairs
+
+      std::vector<GateData_t const*> windowInputs;
+      for (GateData_t const& gate: LVDSgates) windowInputs.push_back(&gate);
+
+      GateData_t denseSum;
+      icarus::trigger::combineDenseGates
+        (windowInputs, &DenseGateLevels<>::sum, denseSum);
+      BOOST_TEST(denseSum == icarus::trigger::sumGates(LVDSgates));
+
+    } // context
+  } // for events
+
+} // realShapedGates_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(DenseGateLevels_testCase) {
+
+  DenseGateLevels_test();
+
+} // BOOST_AUTO_TEST_CASE(DenseGateLevels_testCase)
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(combineDenseGates_testCase) {
+
+  combineDenseGates_test();
+
+} // BOOST_AUTO_TEST_CASE(combineDenseGates_testCase)
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(realShapedGates_testCase) {
+
+  realShapedGates_test();
+
+} // BOOST_AUTO_TEST_CASE(realShapedGates_testCase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,176 @@
+/**
+ * @file PlotSandbox_test.cc
+ * @brief Unit test for the shadow sandboxes of `PlotSandbox.h`.
+ * @date October 19, 2026
+ * @see icaruscode/PMT/Trigger/Utilities/PlotSandbox.h
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Utilities/PlotSandbox.h"
+
+// framework libraries
+#include "art_root_io/TFileDirectory.h"
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TMemFile.h"
+#include "TEfficiency.h"
+#include "TGraph.h"
+#include "TNamed.h"
+#include "TH1F.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( PlotSandbox_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <memory> // std::unique_ptr
+#include <vector>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+/// Creates a sandbox with one object of each supported type, and a subbox.
+void fillSandbox(icarus::trigger::PlotSandbox& plots) {
+
+  plots.make<TH1F>("HValue", "values", 10, 0.0, 10.0);
+  plots.make<TEfficiency>("Eff", "efficiency", 5, 0.0, 5.0);
+  plots.make<TGraph>("Graph", "points");
+
+  auto& subbox = plots.addSubSandbox("Sub", "subbox");
+  subbox.make<TH1F>("HSubValue", "subbox values", 10, 0.0, 10.0);
+
+} // fillSandbox()
+
+
+// -----------------------------------------------------------------------------
+void shadowFillAndMergeTest() {
+
+  TMemFile file { "PlotSandbox_test", "RECREATE" };
+  art::TFileDirectory const topDir { "", "", &file, "" };
+
+  icarus::trigger::PlotSandbox plots { topDir, "Box", "test box" };
+  fillSandbox(plots);
+  auto& subbox = plots.demandSandbox("Sub");
+
+  plots.demand<TH1>("HValue").Fill(1.5);
+  plots.demand<TEfficiency>("Eff").Fill(true, 0.5);
+  plots.demand<TGraph>("Graph").SetPoint(0, 0.0, 0.0);
+  subbox.demand<TH1>("HSubValue").Fill(2.5);
+
+  //
+  // creation: same structure, empty objects
+  //
+  std::vector<std::unique_ptr<icarus::trigger::PlotSandbox>> shadows;
+  for (int i = 0; i < 3; ++i) shadows.push_back(plots.makeShadow());
+
+  for (auto const& shadow: shadows) {
+    BOOST_TEST(shadow->isShadow());
+    BOOST_TEST(shadow->ID() == plots.ID());
+    BOOST_TEST(shadow->nSubSandboxes() == plots.nSubSandboxes());
+    BOOST_TEST(shadow->demand<TH1>("HValue").GetEntries() == 0.0);
+    BOOST_TEST
+      (shadow->demand<TEfficiency>("Eff").GetTotalHistogram()->GetEntries()
+      == 0.0);
+    BOOST_TEST(shadow->demand<TGraph>("Graph").GetN() == 0);
+    auto const& subShadow = shadow->demandSandbox("Sub");
+    BOOST_TEST(subShadow.isShadow());
+    BOOST_TEST(subShadow.ID() == subbox.ID());
+    BOOST_TEST(subShadow.demand<TH1>("HSubValue").GetEntries() == 0.0);
+
+    // shadow objects are not the original ones
+    BOOST_TEST
+      (&(shadow->demand<TH1>("HValue")) != &(plots.demand<TH1>("HValue")));
+  } // for
+
+  //
+  // filling: the original objects are untouched
+  //
+  for (std::size_t i = 0; i < shadows.size(); ++i) {
+    auto const& shadow = shadows[i];
+    for (std::size_t j = 0; j <= i; ++j) {
+      shadow->demand<TH1>("HValue").Fill(5.5);
+      shadow->demand<TEfficiency>("Eff").Fill(j % 2 == 0, 3.5);
+      shadow->demandSandbox("Sub").demand<TH1>("HSubValue").Fill(7.5);
+    }
+    shadow->demand<TGraph>("Graph").SetPoint(0, double(i + 1), 1.0);
+  } // for
+  BOOST_TEST(plots.demand<TH1>("HValue").GetEntries() == 1.0);
+  BOOST_TEST(plots.demand<TGraph>("Graph").GetN() == 1);
+  BOOST_TEST(subbox.demand<TH1>("HSubValue").GetEntries() == 1.0);
+
+  //
+  // merging: all the content is added to the original, and removed from shadow
+  //
+  for (auto const& shadow: shadows) plots.mergeShadow(*shadow);
+
+  TH1 const& hValue = plots.demand<TH1>("HValue");
+  BOOST_TEST(hValue.GetEntries() == 7.0);
+  BOOST_TEST(hValue.GetBinContent(hValue.FindBin(1.5)) == 1.0);
+  BOOST_TEST(hValue.GetBinContent(hValue.FindBin(5.5)) == 6.0);
+
+  TEfficiency const& eff = plots.demand<TEfficiency>("Eff");
+  BOOST_TEST(eff.GetTotalHistogram()->GetBinContent(4) == 6.0); // [ 3, 4 [
+  BOOST_TEST(eff.GetPassedHistogram()->GetBinContent(4) == 4.0);
+  BOOST_TEST(eff.GetTotalHistogram()->GetBinContent(1) == 1.0); // [ 0, 1 [
+
+  BOOST_TEST(plots.demand<TGraph>("Graph").GetN() == 4);
+
+  TH1 const& hSubValue = subbox.demand<TH1>("HSubValue");
+  BOOST_TEST(hSubValue.GetEntries() == 7.0);
+  BOOST_TEST(hSubValue.GetBinContent(hSubValue.FindBin(7.5)) == 6.0);
+
+  for (auto const& shadow: shadows) {
+    BOOST_TEST(shadow->demand<TH1>("HValue").GetEntries() == 0.0);
+    BOOST_TEST(shadow->demand<TGraph>("Graph").GetN() == 0);
+  }
+
+  // merging again does not add anything
+  plots.mergeShadow(*shadows.front());
+  BOOST_TEST(hValue.GetEntries() == 7.0);
+
+  //
+  // a shadow can't be changed in structure, nor merged into another sandbox
+  //
+  auto& shadow = *shadows.front();
+  BOOST_CHECK_THROW
+    (shadow.make<TH1F>("HNew", "new", 5, 0.0, 5.0), cet::exception);
+  BOOST_CHECK_THROW
+    (shadow.addSubSandbox("NewSub", "new subbox"), cet::exception);
+  BOOST_TEST(shadow.nSubSandboxes() == 1U);
+  BOOST_CHECK_THROW(subbox.mergeShadow(shadow), cet::exception);
+  BOOST_CHECK_THROW(plots.mergeShadow(plots), cet::exception);
+
+  // ... and nothing was added to the output file
+  BOOST_TEST(!plots.getDirectory("NewSub"));
+
+} // shadowFillAndMergeTest()
+
+
+// -----------------------------------------------------------------------------
+void unsupportedObjectTest() {
+
+  TMemFile file { "PlotSandbox_unsupported_test", "RECREATE" };
+  art::TFileDirectory const topDir { "", "", &file, "" };
+
+  icarus::trigger::PlotSandbox plots { topDir, "Box", "test box" };
+  fillSandbox(plots);
+
+  // a shadow of the supported objects is fine...
+  BOOST_CHECK_NO_THROW(plots.makeShadow());
+
+  // ... but objects with no reset nor merge are not supported, even in subboxes
+  plots.demandSandbox("Sub").make<TNamed>("Named", "unsupported object");
+  BOOST_CHECK_THROW(plots.makeShadow(), cet::exception);
+
+} // unsupportedObjectTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ShadowFillAndMergeTestCase) {
+  shadowFillAndMergeTest();
+}
+
+BOOST_AUTO_TEST_CASE(UnsupportedObjectTestCase) {
+  unsupportedObjectTest();
+}
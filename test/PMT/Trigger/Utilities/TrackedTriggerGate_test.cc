@@ -24,6 +24,7 @@
 // C/C++ standard libraries
 #include <utility> // std::as_const(), std::move()
 #include <type_traits> // std::is_same_v
+#include <vector>
 
 
 // -----------------------------------------------------------------------------
@@ -237,6 +238,47 @@ void TrackedTriggerGate_test() {
 } // TrackedTriggerGate_test()
 
 
+// -----------------------------------------------------------------------------
+void TrackingInfo_test() {
+  
+  using TrackedGate_t = icarus::trigger::TrackedTriggerGate<int, int>;
+  using TrackingInfo_t = TrackedGate_t::TrackingInfo;
+  
+  TrackingInfo_t A;
+  BOOST_TEST(!A.hasTracked());
+  A.add(5);
+  A.add(1);
+  A.add(9);
+  A.add(5); // already present
+  BOOST_TEST(A.nTracked() == 3U);
+  BOOST_TEST(A.getTracked() == (std::vector<int>{ 1, 5, 9 }),
+    boost::test_tools::per_element());
+  
+  TrackingInfo_t B;
+  B.add(0);
+  B.add(5);
+  B.add(7);
+  B.add(12);
+  
+  A.add(B); // interleaved, with one duplicate
+  BOOST_TEST(A.getTracked() == (std::vector<int>{ 0, 1, 5, 7, 9, 12 }),
+    boost::test_tools::per_element());
+  
+  A.add(A); // self
+  A.add(TrackingInfo_t{}); // empty
+  BOOST_TEST(A.nTracked() == 6U);
+  
+  TrackingInfo_t C;
+  C.add(20);
+  A.add(C); // all after
+  TrackingInfo_t D;
+  D.add(A); // into empty
+  BOOST_TEST(D.getTracked() == (std::vector<int>{ 0, 1, 5, 7, 9, 12, 20 }),
+    boost::test_tools::per_element());
+  
+} // TrackingInfo_test()
+
+
 // -----------------------------------------------------------------------------
 // BEGIN Test cases  -----------------------------------------------------------
 // -----------------------------------------------------------------------------
@@ -249,6 +291,13 @@ BOOST_AUTO_TEST_CASE(TrackedTriggerGate_testcase) {
 } // BOOST_AUTO_TEST_CASE(TrackedTriggerGate_testcase)
 
 
+BOOST_AUTO_TEST_CASE(TrackingInfo_testcase) {
+  
+  TrackingInfo_test();
+  
+} // BOOST_AUTO_TEST_CASE(TrackingInfo_testcase)
+
+
 // -----------------------------------------------------------------------------
 // END Test cases  -------------------------------------------------------------
 // -----------------------------------------------------------------------------
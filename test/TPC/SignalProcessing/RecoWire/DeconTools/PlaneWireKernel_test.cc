@@ -0,0 +1,171 @@
+/**
+ * @file PlaneWireKernel_test.cc
+ * @brief Unit test for `PlaneWireKernel.h`
+ * @date October 19, 2026
+ * @see icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/PlaneWireKernel.h
+ *
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/PlaneWireKernel.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( PlaneWireKernel_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <vector>
+#include <complex>
+#include <algorithm> // std::copy()
+#include <cmath>
+#include <cstdlib> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+/// Applies `kernel` to the wires in `wires` (zero padded to the kernel size)
+/// with a plain discrete Fourier transform, and returns the first wires back.
+std::vector<double> applyKernel
+  (std::vector<double> const& wires, std::vector<float> const& kernel)
+{
+  std::size_t const N = kernel.size();
+  std::vector<double> padded(N, 0.0);
+  std::copy(wires.begin(), wires.end(), padded.begin());
+
+  std::vector<std::complex<double>> freq(N);
+  for (std::size_t k = 0; k < N; ++k) {
+    for (std::size_t n = 0; n < N; ++n)
+      freq[k] += padded[n] * std::polar(1.0, -2.0 * M_PI * double(k * n) / N);
+    freq[k] *= kernel[k];
+  }
+
+  std::vector<double> result(wires.size(), 0.0);
+  for (std::size_t n = 0; n < wires.size(); ++n) {
+    std::complex<double> sum;
+    for (std::size_t k = 0; k < N; ++k)
+      sum += freq[k] * std::polar(1.0, 2.0 * M_PI * double(k * n) / N);
+    result[n] = sum.real() / N;
+  }
+  return result;
+} // applyKernel()
+
+
+// -----------------------------------------------------------------------------
+void identityTest() {
+
+  // this is the configuration where the plane image deconvolution does not
+  // touch the wire dimension, and matches the single channel deconvolution
+  icarus_tool::PlaneWireKernel const kernel { {}, 0.0, 0.01 };
+
+  BOOST_TEST(kernel.isIdentity());
+  BOOST_TEST(kernel.padding() == 0U);
+
+  std::vector<float> const values = kernel.kernel(17U);
+  BOOST_TEST(values == std::vector<float>(17U, 1.0f),
+    boost::test_tools::per_element());
+
+  BOOST_TEST(!(icarus_tool::PlaneWireKernel{ { -0.1 }, 0.0, 0.01 }.isIdentity()));
+  BOOST_TEST(!(icarus_tool::PlaneWireKernel{ {}, 0.1, 0.01 }.isIdentity()));
+
+} // identityTest()
+
+
+// -----------------------------------------------------------------------------
+void paddingTest(icarus_tool::PlaneWireKernel const& kernel) {
+
+  // a signal on the first wire must not leak into the last one
+  std::size_t const nWires = 20U;
+
+  BOOST_TEST_MESSAGE("Padding: " << kernel.padding() << " wires");
+  BOOST_TEST(kernel.padding() > 0U);
+  BOOST_TEST(kernel.padding() < icarus_tool::PlaneWireKernel::MaxPadding);
+
+  std::vector<double> image(nWires, 0.0);
+  image.front() = 1.0;
+
+  std::vector<double> const padded
+    = applyKernel(image, kernel.kernel(nWires + kernel.padding()));
+  std::vector<double> const circular = applyKernel(image, kernel.kernel(nWires));
+
+  double const tolerance = icarus_tool::PlaneWireKernel::LeakTolerance;
+  BOOST_TEST(std::abs(padded.back()) < tolerance * std::abs(padded.front()));
+  BOOST_TEST(std::abs(circular.back()) > tolerance * std::abs(circular.front()));
+
+  // one wire less of padding is not enough
+  std::vector<double> const short_padded
+    = applyKernel(image, kernel.kernel(nWires + kernel.padding() - 1U));
+  BOOST_TEST
+    (std::abs(short_padded.back()) >= tolerance * std::abs(short_padded.front()));
+
+} // paddingTest()
+
+
+void noFilterPaddingTest() {
+
+  // the inverse of 1 - 0.1 (z + 1/z) decays as (5 - sqrt(24))^d ~ 0.101^d:
+  // it is still 1.03e-3 at 3 wires, although the response reaches only 1
+  icarus_tool::PlaneWireKernel const kernel { { -0.1 }, 0.0, 0.01 };
+  BOOST_TEST(kernel.padding() == 3U);
+
+  paddingTest(kernel);
+
+} // noFilterPaddingTest()
+
+
+void filterPaddingTest() {
+
+  paddingTest(icarus_tool::PlaneWireKernel{ { -0.1 }, 0.1, 0.01 });
+
+} // filterPaddingTest()
+
+
+// -----------------------------------------------------------------------------
+void deconvolutionTest() {
+
+  // with no filter the kernel must undo the induction on the neighbours
+  std::vector<double> const fractions { -0.1, 0.02 };
+  icarus_tool::PlaneWireKernel const kernel { fractions, 0.0, 0.01 };
+  std::size_t const nWires = 20U;
+
+  std::vector<double> signal(nWires, 0.0);
+  signal[2] = 1.0;
+  signal[3] = 0.5;
+  signal[17] = -2.0;
+
+  // the measured image includes the induction, which stays within the image
+  std::vector<double> measured(signal);
+  for (std::size_t wire = 0; wire < nWires; ++wire) {
+    for (std::size_t dist = 1; dist <= fractions.size(); ++dist) {
+      double const induced = fractions[dist - 1] * signal[wire];
+      if (wire >= dist) measured[wire - dist] += induced;
+      if (wire + dist < nWires) measured[wire + dist] += induced;
+    }
+  } // for
+
+  std::vector<double> const deconvolved
+    = applyKernel(measured, kernel.kernel(nWires + kernel.padding()));
+
+  for (std::size_t wire = 0; wire < nWires; ++wire) {
+    BOOST_TEST_CONTEXT("Wire " << wire) {
+      BOOST_TEST(std::abs(deconvolved[wire] - signal[wire]) < 1e-6);
+    }
+  }
+
+} // deconvolutionTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(IdentityTestCase) {
+  identityTest();
+}
+
+BOOST_AUTO_TEST_CASE(NoFilterPaddingTestCase) {
+  noFilterPaddingTest();
+}
+
+BOOST_AUTO_TEST_CASE(FilterPaddingTestCase) {
+  filterPaddingTest();
+}
+
+BOOST_AUTO_TEST_CASE(DeconvolutionTestCase) {
+  deconvolutionTest();
+}
@@ -0,0 +1,95 @@
+/**
+ * @file ChannelGeometryCache_test.cc
+ * @brief Unit test for `ChannelGeometryCache.h`
+ * @date October 19, 2026
+ * @see icaruscode/TPC/Utilities/ChannelGeometryCache.h
+ *
+ * The cache is built from a fake geometry, which provides only the mapping of
+ * channels to wires and readout planes.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Utilities/ChannelGeometryCache.h"
+
+// LArSoft libraries
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/readout_types.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ChannelGeometryCache_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// Geometry with 12 channels in two readout planes; some have no wire.
+struct FakeGeometry {
+
+  /// Channels with no wire.
+  static bool isEmpty(raw::ChannelID_t channel)
+    { return (channel == 0U) || (channel == 5U) || (channel == 11U); }
+
+  unsigned int Nchannels() const { return 12U; }
+
+  /// Channels read two wires, in two TPC; the first one is in TPC 1.
+  std::vector<geo::WireID> ChannelToWire(raw::ChannelID_t channel) const
+    {
+      if (isEmpty(channel)) return {};
+      geo::PlaneID::PlaneID_t const plane = (channel < 6U)? 0U: 2U;
+      geo::WireID::WireID_t const wire = 100U + channel;
+      return {
+        geo::WireID{ 0U, 1U, plane, wire },
+        geo::WireID{ 0U, 0U, plane, wire }
+      };
+    }
+
+  readout::ROPID ChannelToROP(raw::ChannelID_t channel) const
+    { return { 0U, 0U, (channel < 6U)? 0U: 2U }; }
+
+}; // FakeGeometry
+
+
+// -----------------------------------------------------------------------------
+void flatLookupTest() {
+
+  FakeGeometry const geom;
+  icarus::ChannelGeometryCache const cache { geom };
+
+  BOOST_TEST(cache.nChannels() == geom.Nchannels());
+
+  for (raw::ChannelID_t channel = 0U; channel < geom.Nchannels(); ++channel) {
+    BOOST_TEST_CONTEXT("channel " << channel) {
+
+      if (FakeGeometry::isEmpty(channel)) {
+        BOOST_TEST(!cache.hasWire(channel));
+        BOOST_TEST(!cache.wireID(channel).isValid);
+        BOOST_TEST(!cache.ropID(channel).isValid);
+      }
+      else {
+        geo::WireID const expected = geom.ChannelToWire(channel).front();
+        BOOST_TEST(cache.hasWire(channel));
+        BOOST_TEST(cache.wireID(channel) == expected);
+        BOOST_TEST(cache.planeID(channel) == geo::PlaneID(expected));
+        BOOST_TEST(cache.ropID(channel) == geom.ChannelToROP(channel));
+        BOOST_TEST(cache.cryostat(channel) == 0U);
+        BOOST_TEST(cache.tpc(channel) == 1U);
+        BOOST_TEST(cache.plane(channel) == expected.Plane);
+        BOOST_TEST(cache.wire(channel) == 100U + channel);
+      }
+
+    } // context
+  } // for
+
+  // channels out of the geometry have no wire
+  BOOST_TEST(!cache.hasWire(geom.Nchannels()));
+  BOOST_TEST(!cache.hasWire(raw::InvalidChannelID));
+
+} // flatLookupTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(FlatLookupTestCase) {
+  flatLookupTest();
+}
@@ -0,0 +1,172 @@
+/**
+ * @file MorphologicalFilters_test.cc
+ * @brief Unit test for `MorphologicalFilters.h`
+ * @date October 19, 2026
+ * @see icaruscode/TPC/Utilities/MorphologicalFilters.h
+ *
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Utilities/MorphologicalFilters.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( MorphologicalFilters_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <vector>
+#include <random>
+#include <algorithm> // std::min_element(), std::max_element()
+#include <cstdlib> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+/// Running minimum or maximum of `input` over the centered window of
+/// `structuringElement / 2` samples per side, truncated at the ends.
+template <typename T>
+std::vector<T> bruteForceExtremum
+  (std::vector<T> const& input, std::size_t structuringElement, bool maximum)
+{
+  std::size_t const halfWidth = structuringElement / 2;
+  std::vector<T> result(input.size());
+  for (std::size_t index = 0; index < input.size(); ++index) {
+    auto const begin
+      = input.begin() + (index < halfWidth? 0: index - halfWidth);
+    auto const end
+      = input.begin() + std::min(index + halfWidth + 1, input.size());
+    result[index]
+      = maximum? *std::max_element(begin, end): *std::min_element(begin, end);
+  }
+  return result;
+} // bruteForceExtremum()
+
+
+/// Returns `size` random samples between `-range` and `range`.
+template <typename T>
+std::vector<T> randomWaveform(std::size_t size, int range, std::mt19937& rng) {
+  std::uniform_int_distribution<int> dist { -range, range };
+  std::vector<T> waveform(size);
+  for (T& sample: waveform) sample = static_cast<T>(dist(rng));
+  return waveform;
+} // randomWaveform()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void bruteForceTest() {
+
+  std::mt19937 rng { 4096U };
+
+  // a workspace reused across all the sizes, which grow and shrink
+  icarus::morphology::Workspace<T> workspace;
+
+  for (std::size_t const size: { 0U, 1U, 2U, 5U, 16U, 17U, 100U, 3U, 513U }) {
+    for (std::size_t const structuringElement
+      : { 0U, 1U, 2U, 3U, 4U, 7U, 8U, 15U, 31U, 600U }
+    ) {
+      BOOST_TEST_CONTEXT
+        ("size " << size << ", structuring element " << structuringElement)
+      {
+        // few levels, so that the extremum is often repeated in the window
+        std::vector<T> const input = randomWaveform<T>(size, 20, rng);
+        std::vector<T> const expectedErosion
+          = bruteForceExtremum(input, structuringElement, false);
+        std::vector<T> const expectedDilation
+          = bruteForceExtremum(input, structuringElement, true);
+
+        std::vector<T> erosionVec, dilationVec;
+        icarus::morphology::erosion
+          (input, structuringElement, erosionVec, workspace);
+        icarus::morphology::dilation
+          (input, structuringElement, dilationVec, workspace);
+        BOOST_TEST(erosionVec == expectedErosion,
+          boost::test_tools::per_element());
+        BOOST_TEST(dilationVec == expectedDilation,
+          boost::test_tools::per_element());
+
+        // in place, with the thread workspace
+        std::vector<T> inPlace = input;
+        icarus::morphology::erosion(inPlace, structuringElement, inPlace);
+        BOOST_TEST(inPlace == expectedErosion,
+          boost::test_tools::per_element());
+
+        // average and difference
+        std::vector<T> averageVec, differenceVec;
+        icarus::morphology::erosionDilationAverageDifference(
+          input, structuringElement,
+          erosionVec, dilationVec, averageVec, differenceVec, workspace
+          );
+        BOOST_TEST_REQUIRE(averageVec.size() == size);
+        BOOST_TEST_REQUIRE(differenceVec.size() == size);
+        for (std::size_t index = 0; index < size; ++index) {
+          BOOST_TEST_CONTEXT("sample #" << index) {
+            BOOST_TEST(averageVec[index] == static_cast<T>(
+              (expectedDilation[index] + expectedErosion[index]) / 2
+              ));
+            BOOST_TEST(differenceVec[index] == static_cast<T>(
+              expectedDilation[index] - expectedErosion[index]
+              ));
+          }
+        } // for
+
+        // opening and closing are filters of the filters
+        std::vector<T> openingVec, closingVec;
+        icarus::morphology::openingAndClosing(
+          erosionVec, dilationVec, structuringElement,
+          openingVec, closingVec, workspace
+          );
+        BOOST_TEST(openingVec
+          == bruteForceExtremum(expectedErosion, structuringElement, true),
+          boost::test_tools::per_element());
+        BOOST_TEST(closingVec
+          == bruteForceExtremum(expectedDilation, structuringElement, false),
+          boost::test_tools::per_element());
+
+      } // context
+    } // for structuring elements
+  } // for sizes
+
+} // bruteForceTest()
+
+
+// -----------------------------------------------------------------------------
+void windowTest() {
+
+  // a single peak is spread by `structuringElement / 2` samples on each side
+  std::vector<short> input(11U, 0);
+  input[5] = 10;
+
+  std::vector<short> dilationVec;
+  icarus::morphology::dilation(input, 4U, dilationVec);
+  std::vector<short> const expected { 0, 0, 0, 10, 10, 10, 10, 10, 0, 0, 0 };
+  BOOST_TEST(dilationVec == expected, boost::test_tools::per_element());
+
+  // odd and next even structuring elements have the same window
+  std::vector<short> oddDilationVec;
+  icarus::morphology::dilation(input, 5U, oddDilationVec);
+  BOOST_TEST(oddDilationVec == dilationVec, boost::test_tools::per_element());
+
+  // at the ends, the window is truncated
+  input.assign(6U, 5);
+  input.front() = -3;
+  input.back() = -4;
+  std::vector<short> erosionVec;
+  icarus::morphology::erosion(input, 2U, erosionVec);
+  BOOST_TEST(erosionVec == std::vector<short>({ -3, -3, 5, 5, -4, -4 }),
+    boost::test_tools::per_element());
+
+} // windowTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(BruteForceFloatTestCase) {
+  bruteForceTest<float>();
+}
+
+BOOST_AUTO_TEST_CASE(BruteForceShortTestCase) {
+  bruteForceTest<short>();
+}
+
+BOOST_AUTO_TEST_CASE(WindowTestCase) {
+  windowTest();
+}